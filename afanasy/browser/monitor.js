@@ -500,7 +500,12 @@ Monitor.prototype.processMsg = function(obj) {
 		else if (obj.job_progress != null)
 		{
 			if (obj.job_progress.id == this.job_id)
-				this.jobProgress(obj.job_progress.progress);
+			{
+				if (obj.job_progress.compact)
+					this.jobProgress(this.jobProgressExpand(obj.job_progress.progress));
+				else
+					this.jobProgress(obj.job_progress.progress);
+			}
 		}
 		else if (obj.blocks != null)
 		{
@@ -1695,7 +1700,7 @@ Monitor.prototype.jobConstruct = function(job) {
 		}
 	}
 
-	nw_GetNodes('jobs', [this.job_id], 'progress');
+	nw_GetNodes('jobs', [this.job_id], 'progress_compact');
 	nw_Subscribe(this.type, true, [this.job_id]);
 };
 
@@ -1726,6 +1731,35 @@ Monitor.prototype.jobProgress = function(progress) {
 	this.setWindowTitle();
 };
 
+// Compact progress block has per task values arrays, and states and hosts written once.
+Monitor.prototype.jobProgressExpand = function(i_blocks) {
+	var progress = [];
+	var columns = ['per', 'frm', 'pfr', 'str', 'err', 'tst', 'tdn', 'act', 'res'];
+
+	for (var b = 0; b < i_blocks.length; b++)
+	{
+		var block = i_blocks[b];
+		var tasks = [];
+		for (var t = 0; t < block.tasks; t++)
+		{
+			var state = block.states[block.s[t]];
+			var p = {'state': state.state, 'st': state.st};
+
+			if (block.hst && (block.hst[t] >= 0))
+				p.hst = block.hosts[block.hst[t]];
+
+			for (var c = 0; c < columns.length; c++)
+				if (block[columns[c]] && block[columns[c]][t])
+					p[columns[c]] = block[columns[c]][t];
+
+			tasks.push(p);
+		}
+		progress.push(tasks);
+	}
+
+	return progress;
+};
+
 Monitor.prototype.tasksProgress = function(tasks_progress) {
 	// g_Info('Monitor.prototype.tasksProgress = function( tasks_progress)');
 	var j = -1;
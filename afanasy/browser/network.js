@@ -130,18 +130,32 @@ function nw_Subscribe(i_class, i_subscribe, i_ids)
 	nw_send(obj);
 }
 
+// Events request waits on server for events, next request is sent when it is answered.
+// Cycle is stored to send a new request, if an answer is lost.
+var nw_events_cycle = null;
+
 function nw_GetEvents()
 {
 	if (g_id == 0)
 		return;
+	if ((nw_events_cycle != null) && (nw_events_cycle > g_cycle - 10))
+		return;
 	// info('c' + g_cycle + ' getting events...');
 	var obj = {};
 	obj.get = {};
 	obj.get.type = 'monitors';
 	obj.get.ids = [g_id];
 	obj.get.mode = 'events';
+	obj.get.wait = true;
 
-	nw_send(obj);
+	nw_events_cycle = g_cycle;
+	nw_request({"send": obj, "func": nw_EventsReceived});
+}
+
+function nw_EventsReceived(i_obj)
+{
+	nw_events_cycle = null;
+	g_ProcessMsg(i_obj);
 }
 
 function nw_GetNodes(i_type, i_ids, i_mode, i_blocks, i_tasks, i_number, i_func)
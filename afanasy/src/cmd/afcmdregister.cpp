@@ -44,6 +44,8 @@ void AfCmd::RegisterCommands()
 
 	addCmd(new CmdTestMsg);
 	addCmd(new CmdTestThreads);
+	addCmd(new CmdTestLoad);
+	addCmd(new CmdSolveBench);
 
 	addCmd(new CmdMonitorList);
 	addCmd(new CmdMonitorLog);
@@ -114,6 +116,7 @@ void AfCmd::RegisterCommands()
 	addCmd(new CmdDBResetTasks);
 	addCmd(new CmdDBResetAll);
 	addCmd(new CmdDBUpdateTables);
+	addCmd(new CmdDBBench);
 
 	addCmd(new CmdConfigLoad);
 
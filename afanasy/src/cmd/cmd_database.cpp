@@ -1,10 +1,17 @@
 #include "cmd_database.h"
 
+#include "../libafanasy/job.h"
+#include "../libafanasy/render.h"
+#include "../libafanasy/taskexec.h"
+#include "../libafanasy/taskprogress.h"
+
 #include "../libafsql/dbconnection.h"
+#include "../libafsql/dbtask.h"
 
 #define AFOUTPUT
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
 
 CmdDBCheck::CmdDBCheck()
 {
@@ -85,3 +92,89 @@ bool CmdDBUpdateTables::v_processArguments( int argc, char** argv, af::Msg &msg)
    DB.DBClose();
    return true;
 }
+
+CmdDBBench::CmdDBBench()
+{
+   setCmd("db_bench");
+   setInfo("Benchmark statistics rows serialization.");
+   setHelp("db_bench [rows] [batch]"
+"\nSerialize [rows] tasks statistics rows (100000 by default) as server does,"
+"\none INSERT query per row and multi-row INSERT queries of [batch] rows (500 by default)."
+"\nQueries are not executed, it measures serialization and queue memory cost only.");
+}
+CmdDBBench::~CmdDBBench(){}
+bool CmdDBBench::v_processArguments( int argc, char** argv, af::Msg &msg)
+{
+	int rows = 100000;
+	int batch = 500;
+	if( argc > 0 ) rows  = atoi( argv[0]);
+	if( argc > 1 ) batch = atoi( argv[1]);
+	if(( rows < 1 ) || ( batch < 1 ))
+	{
+		AF_ERR << "Rows and batch should be positive.";
+		return false;
+	}
+
+	// Typical task statistics values:
+	af::Job job( 1);
+	af::Render render;
+	std::vector<std::string> files;
+	std::map<std::string, std::string> environment;
+	af::TaskExec exec("shot_010_comp.0001", "nuke", "nuke", 1000, -1, -1,
+		"nuke -x -F @#@-@#@ /projects/film/shot_010/comp/shot_010_comp.nk",
+		files, 1, 100, 1, 1, "/projects/film/shot_010/comp", environment, 1, 0, 0, 0);
+	af::TaskProgress progress;
+	progress.time_start = time( NULL) - 600;
+	progress.time_done = progress.time_start + 300;
+
+	afsql::DBTask dbtask;
+
+	printf("Serializing %d tasks statistics rows:\n", rows);
+
+	// Row per query, it is how tasks rows were queued before batching:
+	{
+		int64_t time = af::getMonotonicUSec();
+		int64_t bytes = 0;
+		std::list<std::list<std::string>*> queue;
+		for( int i = 0; i < rows; i++)
+		{
+			std::list<std::string> * queries = new std::list<std::string>();
+			dbtask.add( &exec, &progress, &job, &render, queries);
+			bytes += queries->front().size();
+			queue.push_back( queries);
+		}
+		time = af::getMonotonicUSec() - time;
+
+		printf("Query per row: %lld ms, %.2f us per row, %lld bytes per row, %d queries.\n",
+			(long long)( time / 1000), double( time) / rows, (long long)( bytes / rows), rows);
+
+		for( std::list<std::list<std::string>*>::iterator it = queue.begin(); it != queue.end(); it++)
+			delete *it;
+	}
+
+	// Multi-row queries, as server queues tasks rows now:
+	{
+		int64_t time = af::getMonotonicUSec();
+		int64_t bytes = 0;
+		std::list<std::string> queue;
+		std::string values;
+		int batch_rows = 0;
+		for( int i = 0; i < rows; i++)
+		{
+			dbtask.add( &exec, &progress, &job, &render, values);
+			if(( ++batch_rows < batch ) && ( i != rows - 1 ))
+				continue;
+
+			queue.push_back( dbtask.dbInsertPrefix() + values + ";");
+			bytes += queue.back().size();
+			values.clear();
+			batch_rows = 0;
+		}
+		time = af::getMonotonicUSec() - time;
+
+		printf("Batch of %d rows: %lld ms, %.2f us per row, %lld bytes per row, %d queries.\n",
+			batch, (long long)( time / 1000), double( time) / rows, (long long)( bytes / rows), int( queue.size()));
+	}
+
+	return true;
+}
@@ -29,3 +29,8 @@ class CmdDBUpdateTables : public Cmd { public:
    ~CmdDBUpdateTables();
    bool v_processArguments( int argc, char** argv, af::Msg &msg);
 };
+class CmdDBBench : public Cmd { public:
+   CmdDBBench();
+   ~CmdDBBench();
+   bool v_processArguments( int argc, char** argv, af::Msg &msg);
+};
@@ -64,16 +64,18 @@ bool CmdNumeric::v_processArguments( int argc, char** argv, af::Msg &msg)
 	block.setSequential( seq);
 
 	// Create progresses:
-	af::TaskProgress ** tp = new af::TaskProgress * [block.getTasksNum()];
+	af::TaskProgressColumns progress( block.getTasksNum());
+	af::TaskProgressView * tp = new af::TaskProgressView[block.getTasksNum()];
 	for( int i = 0; i < block.getTasksNum(); i++)
 	{
-		tp[i] = new af::TaskProgress;
+		tp[i] = af::TaskProgressView( &progress, i);
 		tp[i]->state = AFJOB::STATE_READY_MASK;
 	}
 	// Fill tasks order:
 	int * tasks_order = new int[block.getTasksNum()];
 	int task; int order = 0;
-	while(( task = block.getReadyTaskNumber( tp, 0, NULL)) != -1)
+	// All tasks are solved in the same (first) solving attempt:
+	while(( task = block.getReadyTaskNumber( tp, 0, NULL, 1)) != -1)
 	{
 		if( task < 0 )
 		{
@@ -117,6 +119,7 @@ bool CmdNumeric::v_processArguments( int argc, char** argv, af::Msg &msg)
 	std::cout << std::endl;
 
 	delete [] tasks_order;
+	delete [] tp;
 
 	return true;
 }
@@ -1,8 +1,13 @@
 #include "cmd_test.h"
 
+#include <algorithm>
+
 #include "../libafanasy/common/dlThread.h"
 
 #include "../libafanasy/msgclasses/mctest.h"
+#include "../libafanasy/job.h"
+#include "../libafanasy/render.h"
+#include "../libafanasy/rendersranking.h"
 
 #define AFOUTPUT
 #undef AFOUTPUT
@@ -99,3 +104,416 @@ bool CmdTestThreads::v_processArguments( int argc, char** argv, af::Msg &msg)
 
 void CmdTestThreads::v_msgOut( af::Msg& msg) {}
 
+
+
+CmdTestLoad::CmdTestLoad()
+{
+	setCmd("tload");
+	setArgsCount(2);
+	setInfo("Test server load.");
+	setHelp("tload [rate] [seconds] [threads]\nSend requests to server with [rate] per second during [seconds]."
+		"\nRequests are sent from [threads] threads (rate/100 by default), each request uses a new connection."
+		"\nRequests latencies are measured from the scheduled time, so server delays are not hidden by a slow sending."
+		"\nFor server sockets IO benchmarking.");
+}
+
+CmdTestLoad::~CmdTestLoad(){}
+
+struct TestLoadArgs
+{
+	int64_t start_us;
+	int64_t finish_us;
+	int64_t interval_us;
+	int errors;
+	std::vector<int> latencies_us;
+};
+
+void testLoadThread( void * i_args)
+{
+	TestLoadArgs * args = (TestLoadArgs*)(i_args);
+
+	// A light request, that is answered by a container read lock:
+	static const std::string request("{\"get\":{\"type\":\"users\"}}");
+
+	for( int64_t scheduled = args->start_us; scheduled < args->finish_us; scheduled += args->interval_us)
+	{
+		int64_t now = af::getMonotonicUSec();
+		if( now < scheduled )
+			af::sleep_msec( int(( scheduled - now + 999 ) / 1000 ));
+
+		af::Msg msg;
+		msg.setData( request.size(), request.c_str(), af::Msg::TJSON);
+		msg.setJSONBIN();
+
+		bool ok;
+		af::Msg * answer = af::sendToServer( &msg, ok, af::VerboseOff);
+		if( ok && answer )
+			args->latencies_us.push_back( int( af::getMonotonicUSec() - scheduled));
+		else
+			args->errors++;
+
+		if( answer )
+			delete answer;
+	}
+}
+
+bool CmdTestLoad::v_processArguments( int argc, char** argv, af::Msg &msg)
+{
+	int rate = atoi(argv[0]);
+	int seconds = atoi(argv[1]);
+	int threads = rate / 100;
+	if( argc > 2 )
+		threads = atoi(argv[2]);
+	if( threads < 1 )
+		threads = 1;
+
+	if(( rate < 1 ) || ( seconds < 1 ))
+	{
+		AF_ERR << "Rate and seconds should be positive.";
+		return false;
+	}
+
+	printf("Sending %d requests per second during %d seconds from %d threads...\n", rate, seconds, threads);
+
+	// Threads start with a shift, to send requests evenly:
+	int64_t start_us = af::getMonotonicUSec() + 100000;
+	int64_t interval_us = int64_t( threads) * 1000000 / rate;
+
+	std::vector<DlThread*> threads_list;
+	std::vector<TestLoadArgs*> args_list;
+	for( int i = 0; i < threads; i++)
+	{
+		TestLoadArgs * args = new TestLoadArgs;
+		args->start_us = start_us + interval_us * i / threads;
+		args->finish_us = start_us + int64_t( seconds) * 1000000;
+		args->interval_us = interval_us;
+		args->errors = 0;
+
+		DlThread * t = new DlThread();
+		if( t->Start( testLoadThread, args) != 0 )
+		{
+			AF_ERR << "Failed to start thread #" << i;
+			delete t;
+			delete args;
+			continue;
+		}
+
+		threads_list.push_back( t);
+		args_list.push_back( args);
+	}
+
+	int errors = 0;
+	std::vector<int> latencies;
+	for( int i = 0; i < threads_list.size(); i++)
+	{
+		threads_list[i]->Join();
+		delete threads_list[i];
+
+		errors += args_list[i]->errors;
+		latencies.insert( latencies.end(), args_list[i]->latencies_us.begin(), args_list[i]->latencies_us.end());
+		delete args_list[i];
+	}
+
+	int64_t time_us = af::getMonotonicUSec() - start_us;
+
+	printf("Requests: %d, errors: %d, time: %.2f s, rate: %.0f per second\n",
+		int( latencies.size()), errors, time_us / 1000000.0, latencies.size() * 1000000.0 / time_us);
+
+	if( latencies.empty())
+		return true;
+
+	std::sort( latencies.begin(), latencies.end());
+	int64_t sum = 0;
+	for( int i = 0; i < latencies.size(); i++)
+		sum += latencies[i];
+
+	printf("Latency ms: average %.2f, median %.2f, 90%% %.2f, 99%% %.2f, max %.2f\n",
+		sum / 1000.0 / latencies.size(),
+		latencies[latencies.size() / 2] / 1000.0,
+		latencies[latencies.size() * 9 / 10] / 1000.0,
+		latencies[latencies.size() * 99 / 100] / 1000.0,
+		latencies.back() / 1000.0);
+
+	return true;
+}
+
+void CmdTestLoad::v_msgOut( af::Msg& msg) {}
+
+CmdSolveBench::CmdSolveBench()
+{
+	setCmd("solve_bench");
+	setInfo("Benchmark renders ranking for solving.");
+	setHelp("solve_bench [renders] [jobs] [solves]\nSolve [solves] tasks of [jobs] jobs on a synthetic farm of [renders] renders."
+		"\nEach solve filters ready renders that job can run on and takes the most ready one, as server does."
+		"\nRenders are ranked by a full list sort with comparator calculating render parameters (as before),"
+		"\nand by a heap of stored render solving keys (as server does now).");
+}
+
+CmdSolveBench::~CmdSolveBench(){}
+
+namespace
+{
+const int BenchTaskCapacity = 1000;
+
+struct BenchPool
+{
+	std::string name;
+	int priority;
+	int capacity;
+	int max_tasks;
+	BenchPool * parent;
+
+	inline int calcPriority() const { if (parent) return (priority + parent->calcPriority())/2; else return priority; }
+};
+
+// Render parameters are found as on server: pool values are used if render has no own.
+class BenchRender : public af::Render
+{
+public:
+	BenchRender( int i_num, BenchPool * i_pool):
+		m_parent( i_pool),
+		m_tasks_count( 0)
+	{
+		m_id = i_num;
+		m_name = "render" + af::itos( i_num);
+		m_pool = i_pool->name;
+		m_priority = 50 + rand() % 50;
+		m_capacity_host  = ( rand() % 4 ) ? -1 : BenchTaskCapacity * ( 1 + rand() % 8 );
+		m_max_tasks_host = ( rand() % 4 ) ? -1 : 1 + rand() % 4;
+		m_state = SOnline;
+	}
+
+	inline int findMaxTasks() const
+		{ if (m_max_tasks_host < 0 && m_parent) return m_parent->max_tasks; else return m_max_tasks_host;}
+	inline int findCapacity() const
+		{ if (m_capacity_host  < 0 && m_parent) return m_parent->capacity; else return m_capacity_host; }
+	inline int findCapacityFree() const { return findCapacity() - m_capacity_used;}
+	inline int calcPoolPriority() const {if (m_parent) return m_parent->calcPriority(); else return 0;}
+	inline int getTasksCount() const { return m_tasks_count; }
+
+	inline bool isReady() const
+		{ return ( m_tasks_count < findMaxTasks()) && ( m_capacity_used + BenchTaskCapacity <= findCapacity()); }
+
+	inline int getPoolPriority( const af::Job * i_job) const
+	{
+		bool canrunon;
+		return calcPoolPriority() + i_job->getPoolPriority( m_pool, canrunon);
+	}
+
+	void startTask( long long i_time)
+	{
+		m_tasks_count++;
+		m_capacity_used += BenchTaskCapacity;
+		m_task_start_finish_time = i_time;
+		updateKey();
+	}
+
+	void finishTasks( long long i_time)
+	{
+		m_tasks_count = 0;
+		m_capacity_used = 0;
+		m_task_start_finish_time = i_time;
+		updateKey();
+	}
+
+	void updateKey()
+	{
+		m_key.online                  = isOnline();
+		m_key.pool_priority           = calcPoolPriority();
+		m_key.tasks_num               = m_tasks_count;
+		m_key.capacity_free           = findCapacityFree();
+		m_key.priority                = getPriority();
+		m_key.tasks_start_finish_time = getTasksStartFinishTime();
+		m_key.capacity                = findCapacity();
+		m_key.max_tasks               = findMaxTasks();
+	}
+
+	inline const af::RendersRanking::Key & getKey() const { return m_key; }
+
+private:
+	BenchPool * m_parent;
+	int m_tasks_count;
+	af::RendersRanking::Key m_key;
+};
+
+// Comparator that was used to sort renders list for each solving node.
+struct BenchMostReadyRender
+{
+	const af::Job * m_job;
+	BenchMostReadyRender( const af::Job * i_job): m_job( i_job) {}
+
+	inline bool operator()( const BenchRender * a, const BenchRender * b) const
+	{
+		if( a->isOnline() && b->isOffline()) return true;
+		if( a->isOffline() && b->isOnline()) return false;
+
+		int pool_priority_a = a->getPoolPriority( m_job);
+		int pool_priority_b = b->getPoolPriority( m_job);
+		if( pool_priority_a > pool_priority_b) return true;
+		if( pool_priority_a < pool_priority_b) return false;
+
+		if( a->getTasksCount() < b->getTasksCount()) return true;
+		if( a->getTasksCount() > b->getTasksCount()) return false;
+
+		if( a->findCapacityFree() > b->findCapacityFree()) return true;
+		if( a->findCapacityFree() < b->findCapacityFree()) return false;
+
+		if( a->getPriority() > b->getPriority()) return true;
+		if( a->getPriority() < b->getPriority()) return false;
+
+		if( a->getTasksStartFinishTime() < b->getTasksStartFinishTime()) return true;
+		if( a->getTasksStartFinishTime() > b->getTasksStartFinishTime()) return false;
+
+		if( a->findCapacity() > b->findCapacity()) return true;
+		if( a->findCapacity() < b->findCapacity()) return false;
+
+		if( a->findMaxTasks() > b->findMaxTasks()) return true;
+		if( a->findMaxTasks() < b->findMaxTasks()) return false;
+
+		return a->getName().compare( b->getName()) < 0;
+	}
+};
+
+// Solve tasks one by one, returns solves done (it is less if no render is ready).
+int benchSolve( std::vector<BenchRender*> & i_renders, std::vector<af::Job*> & i_jobs, int i_solves, bool i_heap)
+{
+	srand( 1);
+	for( int r = 0; r < i_renders.size(); r++)
+	{
+		i_renders[r]->finishTasks( r);
+	}
+
+	std::list<BenchRender*> ready( i_renders.begin(), i_renders.end());
+	af::RendersRanking ranking;
+
+	int solves = 0;
+	for( int s = 0; s < i_solves; s++)
+	{
+		// All tasks are done, renders are ready again:
+		if( ready.empty())
+		{
+			for( int r = 0; r < i_renders.size(); r++)
+				i_renders[r]->finishTasks( s);
+			ready.assign( i_renders.begin(), i_renders.end());
+		}
+
+		// Job can run on 4 of 5 renders, filtering is the same for both rankings:
+		int j = s % int( i_jobs.size());
+		const af::Job * job = i_jobs[j];
+		std::list<BenchRender*> renders;
+		for( std::list<BenchRender*>::const_iterator it = ready.begin(); it != ready.end(); it++)
+			if(( (*it)->getId() % 5 ) != ( j % 5 ))
+				renders.push_back( *it);
+
+		BenchRender * render = NULL;
+		if( i_heap )
+		{
+			ranking.reset( int( renders.size()));
+			for( std::list<BenchRender*>::const_iterator it = renders.begin(); it != renders.end(); it++)
+			{
+				af::RendersRanking::Key key = (*it)->getKey();
+				key.pool_priority = (*it)->getPoolPriority( job);
+				ranking.add( key, *it);
+			}
+			ranking.rank();
+			render = (BenchRender*)ranking.next();
+		}
+		else
+		{
+			renders.sort( BenchMostReadyRender( job));
+			if( renders.size())
+				render = renders.front();
+		}
+
+		if( NULL == render )
+			continue;
+
+		render->startTask( s);
+		if( false == render->isReady())
+			ready.remove( render);
+
+		solves++;
+	}
+
+	return solves;
+}
+}
+
+bool CmdSolveBench::v_processArguments( int argc, char** argv, af::Msg &msg)
+{
+	int renders_count = 5000;
+	int jobs_count = 20000;
+	int solves = 2000;
+	if( argc > 0 ) renders_count = atoi( argv[0]);
+	if( argc > 1 ) jobs_count    = atoi( argv[1]);
+	if( argc > 2 ) solves        = atoi( argv[2]);
+	if(( renders_count < 1 ) || ( jobs_count < 1 ) || ( solves < 1 ))
+	{
+		AF_ERR << "Renders, jobs and solves should be positive.";
+		return false;
+	}
+
+	srand( 1);
+
+	// Pools tree: root and 20 pools with different parameters.
+	std::vector<BenchPool> pools( 21);
+	pools[0].name = "/";
+	pools[0].priority = 50;
+	pools[0].capacity = BenchTaskCapacity * 4;
+	pools[0].max_tasks = 2;
+	pools[0].parent = NULL;
+	for( int p = 1; p < pools.size(); p++)
+	{
+		pools[p].name = "/pool" + af::itos( p);
+		pools[p].priority = rand() % 100;
+		pools[p].capacity = BenchTaskCapacity * ( 1 + rand() % 8 );
+		pools[p].max_tasks = 1 + rand() % 4;
+		pools[p].parent = &pools[0];
+	}
+
+	std::vector<BenchRender*> renders;
+	for( int r = 0; r < renders_count; r++)
+	{
+		renders.push_back( new BenchRender( r, &pools[1 + rand() % 20]));
+	}
+
+	// Every fourth job has pools priorities:
+	std::vector<af::Job*> jobs;
+	for( int j = 0; j < jobs_count; j++)
+	{
+		jobs.push_back( new af::Job( j + 1));
+		if( j % 4 )
+			continue;
+
+		std::string data = "{\"pools\":{\"/pool" + af::itos( 1 + rand() % 20) + "\":" + af::itos( rand() % 100)
+			+ ",\"/pool" + af::itos( 1 + rand() % 20) + "\":" + af::itos( rand() % 100) + "}}";
+		rapidjson::Document document;
+		char * buffer = af::jsonParseData( document, data.c_str(), int( data.size()));
+		if( NULL == buffer )
+			continue;
+		jobs.back()->af::Work::jsonRead( document);
+		delete [] buffer;
+	}
+
+	printf("Solving %d tasks of %d jobs on %d renders:\n", solves, jobs_count, renders_count);
+
+	const char * names[] = {"Full list sort", "Keyed heap"};
+	for( int h = 0; h < 2; h++)
+	{
+		int64_t time = af::getMonotonicUSec();
+		int solved = benchSolve( renders, jobs, solves, h == 1);
+		time = af::getMonotonicUSec() - time;
+		if( time < 1 )
+			time = 1;
+
+		printf("%s: %d solves in %lld ms, %.1f us per solve, %.0f solves per second.\n",
+			names[h], solved, (long long)( time / 1000), double( time) / solved, solved * 1000000.0 / time);
+	}
+
+	for( int r = 0; r < renders.size(); r++)
+		delete renders[r];
+	for( int j = 0; j < jobs.size(); j++)
+		delete jobs[j];
+
+	return true;
+}
@@ -20,3 +20,20 @@ public:
    void v_msgOut( af::Msg& msg);
 };
 
+class CmdTestLoad : public Cmd
+{
+public:
+   CmdTestLoad();
+   ~CmdTestLoad();
+   bool v_processArguments( int argc, char** argv, af::Msg &msg);
+   void v_msgOut( af::Msg& msg);
+};
+
+class CmdSolveBench : public Cmd
+{
+public:
+   CmdSolveBench();
+   ~CmdSolveBench();
+   bool v_processArguments( int argc, char** argv, af::Msg &msg);
+};
+
@@ -90,6 +90,10 @@ const bool CUT_DOMAIN_NAME       = true; ///< "user.local" will be just "user"
 namespace AFSERVER
 {
 const char STORE_FILE[] = "server.json";
+const int STORE_LOAD_THREADS = 8; ///< Threads to read and parse jobs store on server start.
+const int STORE_LOG = 0; ///< Keep nodes store in a snapshot file and a write-ahead log, instead of folders.
+const int STORE_LOG_SNAPSHOT_SEC = 600; ///< Maximum store log age to rewrite a snapshot.
+const int FILES_WRITE_THREADS = 4; ///< Threads to write store files, files of a node are written by the same thread.
 
 const int WOLWAKE_INTERVAL = 10;
 
@@ -99,8 +103,20 @@ const int SOCKETS_READWRITE_THREADS_STACK = 0;
 const int SOCKETS_PROCESSING_THREADS_STACK = 0;
 
 const int LINUX_EPOLL = 0;
+const int LINUX_IO_URING = 0;
 const int HTTP_WAIT_CLOSE = 0;
+const int HTTP_KEEP_ALIVE_SEC = 15;
+const int HTTP_GZIP_SIZE_MIN = 16384; ///< Bigger HTTP answers are compressed, if client accepts it.
+const int SOCKETS_QUEUE_MAX = 1000;      ///< Accepting pauses while so many requests wait for processing.
+const int CLIENT_RATE = 0;               ///< Maximum connections per second from one IP address.
+const int RENDER_REGISTER_RATE = 100;    ///< Maximum renders registrations per second.
 const int PROFILING_SEC = 1024;
+
+const int RUN_CYCLE_WAKEUP = 0;
+const int RUN_CYCLE_MIN_MSEC = 100;
+const int RUN_CYCLE_BATCH_MSEC = 20;
+
+const int LIST_SNAPSHOT_SEC = 10;
 }
 
 /// Database options:
@@ -114,6 +130,10 @@ const int STRINGNAMELEN = 512;
 const int STRINGEXPRLEN = 4096;
 ///< Maximum lenght for expression (command, dependmask, hostsmask, view command etc...).
 const int RECONNECTAFTER = 60; ///< If connection lost, try to reconnect every RECONNECTAFTER seconds.
+const int BATCH_ROWS = 500; ///< Statistics rows are inserted by batches of this size,
+const int BATCH_SEC = 2;    ///< or by a smaller batch if rows are waiting this time.
+const int QUEUE_KB = 16384; ///< Queries above this size are spilled to a journal file until database is reachable.
+const char JOURNAL_FILE[] = "dbqueue.journal";
 }
 
 /// Render options:
@@ -142,6 +162,7 @@ const char HDDSPACE_PATH[] /*******/ = "/";			///< Path to query total and free
 const char IOSTAT_DEVICE[] /*******/ = "sda";		///< Device to monitor IO.
 const int TASK_READ_BUFFER_SIZE /**/ = 1024 * 1024; ///< Task process read buffer.
 const bool CUT_DOMAIN_NAME           = true;        ///< "render.local" will be just "render"
+const bool CONNECTION_KEEP           = false;       ///< Keep one connection to server to receive pushed events.
 }
 
 /// Watch options:
@@ -166,6 +187,7 @@ namespace AFMONITOR
 {
 const int MAXCOUNT = 100000; ///< Maximum allowed online Monitors.
 const int ZOMBIETIME = 40;   ///< Seconds to wait for update to consider to kill Monitor.
+const int EVENTS_WAIT_SEC = 5; ///< Seconds events request can wait for events on server.
 }
 
 /// Network options:
@@ -24,6 +24,9 @@ namespace AFJOB
 
 	const int TASK_MULTIHOSTMAXHOSTS = 100;
 
+	/// Tasks progress journal is compacted when it has more records than twice tasks number plus this value.
+	const int TASKS_PROGRESS_JOURNAL_MIN = 1000;
+
 // When job sends it's data to server to register.
 	const int NET_CONNECTTIME = 10000;
 	const int NET_SENTTIME = 10000;
@@ -89,8 +92,6 @@ namespace AFJOB
 	const   char  STATE_TRYTHISTASKNEXT_NAME[]     = "Trying this task next";
 	const   char  STATE_TRYTHISTASKNEXT_NAME_S[]   = "TRY";
 
-	const int64_t STATE_SOLVED_MASK                = 1ULL<<62;
-
 	const int  SYSJOB_ID                   = 1;  // System job ID
 	const char SYSJOB_NAME[]               = "afanasy";
 	const char SYSJOB_USERNAME[]           = "afadmin";
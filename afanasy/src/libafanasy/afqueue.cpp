@@ -174,6 +174,12 @@ void AfQueue::releaseNull()
 #endif
 }
 
+int AfQueue::getCount()
+{
+   DlScopeLocker lock( &m_mutex );
+   return count;
+}
+
 AfQueueItem* AfQueue::pop( WaitMode i_mode )
 {
    AfQueueItem* item = NULL;
@@ -238,7 +244,8 @@ void AfQueue::run()
 
       if( AFRunning == false )
       {
-         delete item;
+         // Item is not processed, keep it for a derived class destructor:
+         if( item ) push( item, true);
          return;
       }
 
@@ -257,6 +264,16 @@ void AfQueue::run()
    AFINFA("AfQueue::run is finished for queue '%s'.", name.c_str() )
 }
 
+void AfQueue::stopThread()
+{
+   if( false == m_thread_started )
+      return;
+
+   releaseNull();
+   m_thread.Join();
+   m_thread_started = false;
+}
+
 void AfQueue::processItem( AfQueueItem* item)
 {
 	AFERRAR("AfQueue::processItem: in %s not implemented.", name.c_str())
@@ -64,6 +64,9 @@ public:
    // Needed to wake up waiting threads to join them on application exit.
    void releaseNull();
 
+   /// Number of items in queue.
+   int getCount();
+
 protected:
 
 /// Return first item from queue. BLOCKING FUNCTION if \c block==e_wait .
@@ -73,6 +76,10 @@ protected:
    /// Called from run thead to process item just poped from queue
    virtual void processItem( AfQueueItem* item);
 
+   /// Wake and join run thread, \c AFRunning should be false.
+   /// Items that are not processed are left in queue.
+   void stopThread();
+
    /*
       This function is called from a thread and waits on our
       counting semaphore.
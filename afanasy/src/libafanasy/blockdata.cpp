@@ -139,6 +139,9 @@ BlockData::BlockData(int BlockNum, int JobId)
 void BlockData::construct()
 {
 	m_tasks_num = 0;
+	m_tasks_ready_num = -1;
+	m_tasks_ready_first = 0;
+	m_tasks_percent_sum = 0;
 	m_tasks_data = NULL;
 	m_running_tasks_counter = 0;
 	m_running_capacity_counter = 0;
@@ -914,15 +917,15 @@ void BlockData::setFramesPerTask(long long perTask)
 	m_frames_per_task = perTask;
 }
 
-int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flags, const Render *i_render)
+int BlockData::getReadyTaskNumber(TaskProgressView *i_tp, const int64_t &i_job_flags, const Render *i_render, int64_t i_solve_epoch)
 {
 	// printf("af::getReadyTaskNumber: %li-%li/%li:%li%%%li\n", m_frame_first, m_frame_last, m_frames_inc,
 	// m_frames_per_task, m_sequential);
 	if (i_render && (i_job_flags & Job::FMaintenance))
 	{
-		for (int task = 0; task < m_tasks_num; task++)
+		for (int task = findTaskReady(0); task < m_tasks_num; task = findTaskReady(task + 1))
 		{
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK)
+			if (isTaskReady(i_tp, task))
 			{
 				if (genTaskName(task) == i_render->getName()) return task;
 			}
@@ -931,6 +934,9 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 		return AFJOB::TASK_NUM_NO_TASK;
 	}
 
+	// Tasks that are not ready are not marked as solved,
+	// as they can't become ready during the solving.
+
 	if (m_sequential > 1)
 	{
 		// Task solving with a positive step:
@@ -941,13 +947,13 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 		// Check the first task:
 		{
 			int task = 0;
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
+			if (isTaskReady(i_tp, task)) return task;
 		}
 
 		// Check the last task:
 		{
 			int task = m_tasks_num - 1;
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
+			if (isTaskReady(i_tp, task)) return task;
 		}
 
 		// Iterate sequential tasks:
@@ -961,23 +967,23 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 				break;
 			}
 
-			if (i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if (false == isTaskReady(i_tp, task)) continue;
+			if (i_tp[task]->isSolved(i_solve_epoch)) continue;
+			i_tp[task]->setSolved(i_solve_epoch);
 
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
+			return task;
 		}
 
 		if (i_job_flags & af::Job::FPPApproval) return AFJOB::TASK_NUM_NO_SEQUENTIAL;
 
-		for (int task = 0; task < m_tasks_num; task++)
+		for (int task = findTaskReady(0); task < m_tasks_num; task = findTaskReady(task + 1))
 		{
 			// Common tasks solving:
-			if (i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
-
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
+			if (false == isTaskReady(i_tp, task)) continue;
+			if (i_tp[task]->isSolved(i_solve_epoch)) continue;
+			i_tp[task]->setSolved(i_solve_epoch);
 
-			continue;
+			return task;
 		}
 
 		return AFJOB::TASK_NUM_NO_TASK;
@@ -1000,52 +1006,59 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 				break;
 			}
 
-			if (i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if (false == isTaskReady(i_tp, task)) continue;
+			if (i_tp[task]->isSolved(i_solve_epoch)) continue;
+			i_tp[task]->setSolved(i_solve_epoch);
 
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
+			return task;
 		}
 
-		for (int task = m_tasks_num - 1; task >= 0; task--)
+		for (int task = findTaskReadyBack(m_tasks_num - 1); task >= 0; task = findTaskReadyBack(task - 1))
 		{
 			// Common tasks solving:
-			if (i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if (false == isTaskReady(i_tp, task)) continue;
+			if (i_tp[task]->isSolved(i_solve_epoch)) continue;
+			i_tp[task]->setSolved(i_solve_epoch);
 
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
-
-			continue;
+			return task;
 		}
 
 		return AFJOB::TASK_NUM_NO_TASK;
 	}
 
-	for (int task = 0; task < m_tasks_num; task++)
+	if (isSequential())
 	{
-		if (isSequential())
+		for (int task = findTaskReady(0); task < m_tasks_num; task = findTaskReady(task + 1))
 		{
 			// Common tasks solving:
-			if (i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
-
-			if (i_tp[task]->state & AFJOB::STATE_READY_MASK) return task;
+			if (false == isTaskReady(i_tp, task)) continue;
+			if (i_tp[task]->isSolved(i_solve_epoch)) continue;
+			i_tp[task]->setSolved(i_solve_epoch);
 
-			continue;
+			return task;
 		}
 
-		if (m_sequential == -1)
+		return AFJOB::TASK_NUM_NO_TASK;
+	}
+
+	if (m_sequential == -1)
+	{
+		for (int task = findTaskReadyBack(m_tasks_num - 1); task >= 0; task = findTaskReadyBack(task - 1))
 		{
 			// Reverse tasks solving:
-			int index = m_tasks_num - 1 - task;
-
-			if (i_tp[index]->isSolved()) continue;
-			i_tp[index]->setSolved();
+			if (false == isTaskReady(i_tp, task)) continue;
+			if (i_tp[task]->isSolved(i_solve_epoch)) continue;
+			i_tp[task]->setSolved(i_solve_epoch);
 
-			if (i_tp[index]->state & AFJOB::STATE_READY_MASK) return index;
-
-			continue;
+			return task;
 		}
 
+		return AFJOB::TASK_NUM_NO_TASK;
+	}
+
+	int64_t powered_prev = 0;
+	for (int task = 0; task < m_tasks_num; task++)
+	{
 		// Middle task solving:
 		int64_t powered = 1;
 		while (powered < task)
@@ -1058,6 +1071,11 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 			powered = m_tasks_num;
 		}
 
+		// The same power gives the same tasks, that are already tried:
+		if (powered == powered_prev)
+			continue;
+		powered_prev = powered;
+
 		// printf(" task=%d, powered=%lld\n", task, powered);
 		for (int64_t i = 0; i <= powered; i++)
 		{
@@ -1066,11 +1084,16 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 
 			if (index >= m_tasks_num) index = m_tasks_num - 1;
 
-			if (i_tp[index]->isSolved()) continue;
-			i_tp[index]->setSolved();
+			if (false == isTaskReady(i_tp, index)) continue;
+			if (i_tp[index]->isSolved(i_solve_epoch)) continue;
+			i_tp[index]->setSolved(i_solve_epoch);
 
-			if (i_tp[index]->state & AFJOB::STATE_READY_MASK) return index;
+			return index;
 		}
+
+		// All tasks were tried one by one:
+		if (nodivision_needed)
+			break;
 	}
 
 	// No ready tasks found:
@@ -1078,6 +1101,116 @@ int BlockData::getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flag
 	return AFJOB::TASK_NUM_NO_TASK;
 }
 
+void BlockData::setTaskReady(int i_task)
+{
+	if ((m_tasks_ready_num != m_tasks_num) || (i_task < 0) || (i_task >= m_tasks_num))
+		return;
+
+	int word = i_task >> 6;
+	m_tasks_ready[word] |= uint64_t(1) << (i_task & 63);
+
+	if (word < m_tasks_ready_first)
+		m_tasks_ready_first = word;
+}
+
+int BlockData::findTaskReady(int i_task)
+{
+	// Tasks were not stored, all tasks should be checked:
+	if (m_tasks_ready_num != m_tasks_num)
+		return i_task;
+
+	if (i_task < 0)
+		i_task = 0;
+
+	// Skip words that are known to be empty.
+	// Only searching from them can move the first word forward.
+	bool from_first = false;
+	if (i_task <= (m_tasks_ready_first << 6))
+	{
+		from_first = true;
+		i_task = m_tasks_ready_first << 6;
+	}
+
+	int word = i_task >> 6;
+
+	for (; word < int(m_tasks_ready.size()); word++)
+	{
+		uint64_t bits = m_tasks_ready[word];
+		if (word == (i_task >> 6))
+			bits >>= i_task & 63;
+		else
+			i_task = word << 6;
+
+		if (bits == 0)
+			continue;
+
+		if (from_first)
+			m_tasks_ready_first = word;
+
+		while ((bits & 1) == 0)
+		{
+			bits >>= 1;
+			i_task++;
+		}
+
+		return i_task;
+	}
+
+	if (from_first)
+		m_tasks_ready_first = m_tasks_ready.size();
+
+	return m_tasks_num;
+}
+
+int BlockData::findTaskReadyBack(int i_task) const
+{
+	if (m_tasks_ready_num != m_tasks_num)
+		return i_task;
+
+	if (i_task >= m_tasks_num)
+		i_task = m_tasks_num - 1;
+
+	for (int word = i_task >> 6; (word >= 0) && (word >= m_tasks_ready_first); word--)
+	{
+		uint64_t bits = m_tasks_ready[word];
+		if (word == (i_task >> 6))
+			bits <<= 63 - (i_task & 63);
+		else
+			i_task = (word << 6) + 63;
+
+		if (bits == 0)
+			continue;
+
+		while ((bits & (uint64_t(1) << 63)) == 0)
+		{
+			bits <<= 1;
+			i_task--;
+		}
+
+		return i_task;
+	}
+
+	return -1;
+}
+
+bool BlockData::isTaskReady(TaskProgressView *i_tp, int i_task)
+{
+	if (m_tasks_ready_num != m_tasks_num)
+		return i_tp[i_task]->state & AFJOB::STATE_READY_MASK;
+
+	uint64_t bit = uint64_t(1) << (i_task & 63);
+	uint64_t & word = m_tasks_ready[i_task >> 6];
+	if (0 == (word & bit))
+		return false;
+
+	if (i_tp[i_task]->state & AFJOB::STATE_READY_MASK)
+		return true;
+
+	// Task is not ready any more (started or done):
+	word &= ~bit;
+	return false;
+}
+
 TaskExec *BlockData::genTask(int num) const
 {
 	if (num > m_tasks_num)
@@ -1399,112 +1532,231 @@ void BlockData::remSolveCounts(TaskExec *i_exec, Render * i_render)
 }
 
 // Functions to update tasks progress and block progress:
-bool BlockData::updateProgress(JobProgress *progress)
+namespace
 {
-	bool changed = false;
+// Task states that are counted in block progress:
+const uint32_t CountedStates = AFJOB::STATE_READY_MASK | AFJOB::STATE_DONE_MASK | AFJOB::STATE_ERROR_MASK
+	| AFJOB::STATE_SKIPPED_MASK | AFJOB::STATE_WARNING_MASK | AFJOB::STATE_WAITRECONNECT_MASK
+	| AFJOB::STATE_WAITDEP_MASK;
+}
 
-	// Just store depend state, all other flags will be calculated
-	m_state = m_state & AFJOB::STATE_WAITDEP_MASK;
+void BlockData::countedTask(const TaskProgressView &i_tp, TaskCounted &o_task)
+{
+	uint32_t task_state = i_tp->state;
+	int8_t task_percent = 0;
+	int64_t task_run_time = 0;
+
+	if (task_state & AFJOB::STATE_DONE_MASK)
+	{
+		task_percent = 100;
+		if (false == (task_state & AFJOB::STATE_SKIPPED_MASK))
+			task_run_time += i_tp->time_done - i_tp->time_start;
+	}
+	if (task_state & AFJOB::STATE_RUNNING_MASK)
+	{
+		task_percent = i_tp->percent;
+		if (task_percent < 0)
+			task_percent = 0;
+		else if (task_percent > 99)
+			task_percent = 99;
+	}
+	if (task_state & AFJOB::STATE_ERROR_MASK)
+	{
+		task_percent = 0;
+		task_run_time += i_tp->time_done - i_tp->time_start;
+	}
+	if (task_state & AFJOB::STATE_SKIPPED_MASK)
+	{
+		task_percent = 100;
+	}
+
+	o_task.state = task_state;
+	o_task.percent = task_percent;
+	o_task.run_time = task_run_time;
+}
+
+void BlockData::countTask(const TaskCounted &i_task, int i_sign)
+{
+	if (i_task.state & AFJOB::STATE_READY_MASK)         p_tasks_ready   += i_sign;
+	if (i_task.state & AFJOB::STATE_DONE_MASK)          p_tasks_done    += i_sign;
+	if (i_task.state & AFJOB::STATE_ERROR_MASK)         p_tasks_error   += i_sign;
+	if (i_task.state & AFJOB::STATE_SKIPPED_MASK)       p_tasks_skipped += i_sign;
+	if (i_task.state & AFJOB::STATE_WARNING_MASK)       p_tasks_warning += i_sign;
+	if (i_task.state & AFJOB::STATE_WAITRECONNECT_MASK) p_tasks_waitrec += i_sign;
+	if (i_task.state & AFJOB::STATE_WAITDEP_MASK)       p_tasks_waitdep += i_sign;
+
+	m_tasks_percent_sum += i_sign * i_task.percent;
+	p_tasks_run_time += i_sign * i_task.run_time;
+}
 
-	int32_t new_percentage = 0;
-	int32_t new_tasks_ready = 0;
-	int32_t new_tasks_done = 0;
-	int32_t new_tasks_error = 0;
-	int new_tasks_skipped = 0;
-	int new_tasks_warning = 0;
-	int new_tasks_waitrec = 0;
-	int new_tasks_waitdep = 0;
-	long long new_tasks_run_time = 0;
+bool BlockData::updateProgress(JobProgress *progress)
+{
+	int32_t old_tasks_ready = p_tasks_ready;
+	int32_t old_tasks_done = p_tasks_done;
+	int32_t old_tasks_error = p_tasks_error;
+	int old_tasks_skipped = p_tasks_skipped;
+	int old_tasks_warning = p_tasks_warning;
+	int old_tasks_waitrec = p_tasks_waitrec;
+	int old_tasks_waitdep = p_tasks_waitdep;
+	int old_percentage = p_percentage;
+	long long old_tasks_run_time = p_tasks_run_time;
+
+	p_tasks_ready = 0;
+	p_tasks_done = 0;
+	p_tasks_error = 0;
+	p_tasks_skipped = 0;
+	p_tasks_warning = 0;
+	p_tasks_waitrec = 0;
+	p_tasks_waitdep = 0;
+	p_tasks_run_time = 0;
+	m_tasks_percent_sum = 0;
+
+	// Store ready tasks for solving:
+	m_tasks_ready.assign((m_tasks_num + 63) >> 6, 0);
+	m_tasks_ready_num = m_tasks_num;
+	m_tasks_ready_first = 0;
+
+	// Store counted tasks to update progress by changed tasks later:
+	m_tasks_counted.resize(m_tasks_num);
 
 	for (int t = 0; t < m_tasks_num; t++)
 	{
-		uint32_t task_state = progress->tp[m_block_num][t]->state;
-		int8_t task_percent = 0;
+		TaskCounted &task = m_tasks_counted[t];
+		countedTask(progress->tp[m_block_num][t], task);
+		countTask(task, 1);
 
-		if (task_state & AFJOB::STATE_READY_MASK)
-		{
-			new_tasks_ready++;
-		}
-		if (task_state & AFJOB::STATE_DONE_MASK)
-		{
-			new_tasks_done++;
-			task_percent = 100;
-			if (false == (task_state & AFJOB::STATE_SKIPPED_MASK))
-				new_tasks_run_time +=
-					progress->tp[m_block_num][t]->time_done - progress->tp[m_block_num][t]->time_start;
-		}
-		if (task_state & AFJOB::STATE_RUNNING_MASK)
-		{
-			task_percent = progress->tp[m_block_num][t]->percent;
-			if (task_percent < 0)
-				task_percent = 0;
-			else if (task_percent > 99)
-				task_percent = 99;
-		}
-		if (task_state & AFJOB::STATE_ERROR_MASK)
-		{
-			new_tasks_error++;
-			task_percent = 0;
-			new_tasks_run_time +=
-				progress->tp[m_block_num][t]->time_done - progress->tp[m_block_num][t]->time_start;
-		}
-		if (task_state & AFJOB::STATE_SKIPPED_MASK)
-		{
-			new_tasks_skipped++;
-			task_percent = 100;
-		}
-		if (task_state & AFJOB::STATE_WARNING_MASK)
-		{
-			new_tasks_warning++;
-		}
-		if (task_state & AFJOB::STATE_WAITRECONNECT_MASK)
-		{
-			new_tasks_waitrec++;
-		}
-		if (task_state & AFJOB::STATE_WAITDEP_MASK)
+		if (task.state & AFJOB::STATE_READY_MASK)
+			m_tasks_ready[t >> 6] |= uint64_t(1) << (t & 63);
+	}
+	p_percentage = m_tasks_percent_sum / m_tasks_num;
+
+	updateState();
+
+	return (p_tasks_ready != old_tasks_ready) || (p_tasks_done != old_tasks_done)
+		|| (p_tasks_error != old_tasks_error) || (p_tasks_skipped != old_tasks_skipped)
+		|| (p_tasks_warning != old_tasks_warning) || (p_tasks_waitrec != old_tasks_waitrec)
+		|| (p_tasks_waitdep != old_tasks_waitdep)
+		|| (p_percentage != old_percentage) || (p_tasks_run_time != old_tasks_run_time);
+}
+
+bool BlockData::updateTasksProgress(JobProgress *progress, const std::vector<int> &i_tasks)
+{
+	if ((int(m_tasks_counted.size()) != m_tasks_num) || (m_tasks_ready_num != m_tasks_num))
+	{
+		bool changed = updateProgress(progress);
+		updateBars(progress);
+		return changed;
+	}
+
+	bool changed = false;
+	int old_percentage = p_percentage;
+
+	for (int i = 0; i < i_tasks.size(); i++)
+	{
+		int t = i_tasks[i];
+		if ((t < 0) || (t >= m_tasks_num))
+			continue;
+
+		TaskCounted task;
+		countedTask(progress->tp[m_block_num][t], task);
+
+		TaskCounted &old_task = m_tasks_counted[t];
+		if ((task.state == old_task.state) && (task.percent == old_task.percent)
+			&& (task.run_time == old_task.run_time))
+			continue;
+
+		countTask(old_task, -1);
+		countTask(task, 1);
+		if ((task.state ^ old_task.state) & CountedStates)
+			changed = true;
+		if (task.run_time != old_task.run_time)
+			changed = true;
+
+		if (task.state & AFJOB::STATE_READY_MASK)
+			setTaskReady(t);
+		else
+			m_tasks_ready[t >> 6] &= ~(uint64_t(1) << (t & 63));
+
+		bool bar_changed = getBarValue(task.state) != getBarValue(old_task.state);
+
+		old_task = task;
+
+		// Update bar characters this task covers:
+		if (bar_changed)
 		{
-			new_tasks_waitdep++;
+			int pos_a = AFJOB::ASCII_PROGRESS_LENGTH * (t) / m_tasks_num;
+			int pos_b = AFJOB::ASCII_PROGRESS_LENGTH * (t + 1) / m_tasks_num;
+			if (pos_b > pos_a) pos_b--;
+			for (int p = pos_a; (p <= pos_b) && (p < AFJOB::ASCII_PROGRESS_LENGTH); p++)
+				updateBar(progress, p);
 		}
-
-		new_percentage += task_percent;
 	}
-	new_percentage = new_percentage / m_tasks_num;
 
-	if ((p_tasks_ready != new_tasks_ready) || (p_tasks_done != new_tasks_done)
-		|| (p_tasks_error != new_tasks_error) || (p_tasks_skipped != new_tasks_skipped)
-		|| (p_tasks_warning != new_tasks_warning) || (p_tasks_waitrec != new_tasks_waitrec)
-		|| (p_tasks_waitdep != new_tasks_waitdep)
-		|| (p_percentage != new_percentage) || (p_tasks_run_time != new_tasks_run_time))
+	p_percentage = m_tasks_percent_sum / m_tasks_num;
+	if (p_percentage != old_percentage)
 		changed = true;
 
-	p_tasks_ready = new_tasks_ready;
-	p_tasks_done = new_tasks_done;
-	p_tasks_error = new_tasks_error;
-	p_tasks_skipped = new_tasks_skipped;
-	p_tasks_warning = new_tasks_warning;
-	p_tasks_waitrec = new_tasks_waitrec;
-	p_tasks_waitdep = new_tasks_waitdep;
-	p_percentage = new_percentage;
-	p_tasks_run_time = new_tasks_run_time;
-
-	if (new_tasks_ready && (false == (m_state & AFJOB::STATE_WAITDEP_MASK)))
+	updateState();
+
+	return changed;
+}
+
+void BlockData::updateState()
+{
+	// Just store depend state, all other flags are calculated
+	m_state = m_state & AFJOB::STATE_WAITDEP_MASK;
+
+	if (p_tasks_ready && (false == (m_state & AFJOB::STATE_WAITDEP_MASK)))
 		m_state = m_state | AFJOB::STATE_READY_MASK;
 
 	if (m_running_tasks_counter) m_state = m_state | AFJOB::STATE_RUNNING_MASK;
 
-	if (new_tasks_done == m_tasks_num)
+	if (p_tasks_done == m_tasks_num)
 	{
 		if (m_time_done == 0) m_time_done = time(NULL);
 		m_state = m_state | AFJOB::STATE_DONE_MASK;
 	}
 
-	if (new_tasks_warning) m_state = m_state | AFJOB::STATE_WARNING_MASK;
+	if (p_tasks_warning) m_state = m_state | AFJOB::STATE_WARNING_MASK;
 
-	if (new_tasks_error) m_state = m_state | AFJOB::STATE_ERROR_MASK;
+	if (p_tasks_error) m_state = m_state | AFJOB::STATE_ERROR_MASK;
 
-	if (new_tasks_skipped) m_state = m_state | AFJOB::STATE_SKIPPED_MASK;
+	if (p_tasks_skipped) m_state = m_state | AFJOB::STATE_SKIPPED_MASK;
+}
 
-	return changed;
+int BlockData::getBarValue(uint32_t i_state)
+{
+	// Get maximum ASCII state for this task:
+	int value = 0;
+	for (int i = 0; i < AFJOB::ASCII_PROGRESS_COUNT; i++)
+		if ((i_state & AFJOB::ASCII_PROGRESS_MASK) == AFJOB::ASCII_PROGRESS_STATES[i * 2 + 1])
+			if (value < i) // More important for monitoring value
+				value = i;
+	return value;
+}
+
+void BlockData::updateBar(JobProgress *progress, int i_pos)
+{
+	// Tasks that can cover this position:
+	int t_a = i_pos * m_tasks_num / AFJOB::ASCII_PROGRESS_LENGTH - 1;
+	int t_b = (i_pos + 1) * m_tasks_num / AFJOB::ASCII_PROGRESS_LENGTH + 1;
+	if (t_a < 0) t_a = 0;
+	if (t_b > m_tasks_num) t_b = m_tasks_num;
+
+	int value = 0;
+	for (int t = t_a; t < t_b; t++)
+	{
+		int pos_a = AFJOB::ASCII_PROGRESS_LENGTH * (t) / m_tasks_num;
+		int pos_b = AFJOB::ASCII_PROGRESS_LENGTH * (t + 1) / m_tasks_num;
+		if (pos_b > pos_a) pos_b--;
+		if ((i_pos < pos_a) || (i_pos > pos_b))
+			continue;
+
+		int task_value = getBarValue(progress->tp[m_block_num][t]->state);
+		if (value < task_value) value = task_value;
+	}
+
+	p_progressbar[i_pos] = AFJOB::ASCII_PROGRESS_STATES[value * 2];
 }
 
 // (for monitoring purpoces only, no meaning for server)
@@ -1516,13 +1768,7 @@ void BlockData::updateBars(JobProgress *progress)
 
 	for (int t = 0; t < m_tasks_num; t++)
 	{
-		// Get maximum ASCII state for this task:
-		int value = 0;
-		for (int i = 0; i < AFJOB::ASCII_PROGRESS_COUNT; i++)
-			if ((progress->tp[m_block_num][t]->state & AFJOB::ASCII_PROGRESS_MASK)
-				== AFJOB::ASCII_PROGRESS_STATES[i * 2 + 1])
-				if (value < i) // More important for monitoring value
-					value = i;
+		int value = getBarValue(progress->tp[m_block_num][t]->state);
 
 		// Calculate range:
 		int pos_a = AFJOB::ASCII_PROGRESS_LENGTH * (t) / m_tasks_num;
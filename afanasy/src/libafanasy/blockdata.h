@@ -91,7 +91,12 @@ public:
 	bool genNumbers(long long &start, long long &end, int num,
 		long long *frames_num = NULL) const; ///< Generate first and last frame numbers for \c num task.
 	int calcTaskNumber(long long i_frame, bool &o_valid_range) const;
-	int getReadyTaskNumber(TaskProgress **i_tp, const int64_t &i_job_flags, const Render *i_render);
+	int getReadyTaskNumber(TaskProgressView *i_tp, const int64_t &i_job_flags, const Render *i_render, int64_t i_solve_epoch);
+
+	/// Mark that the task became ready, for solving to find it.
+	/// Ready tasks are stored on each progress update,
+	/// this is needed for task state changes between updates.
+	void setTaskReady(int i_task);
 	const std::string genTaskName(int num, long long *fstart = NULL, long long *fend = NULL) const;
 
 	inline bool isNumeric() const { return m_flags & FNumeric; } ///< Whether the block is numeric.
@@ -264,8 +269,15 @@ public:
 	void addSolveCounts(TaskExec * i_exec, Render * i_render);
 	void remSolveCounts(TaskExec * i_exec, Render * i_render);
 
+	/// Count all tasks progress and update block state, returns whether progress changed.
 	bool updateProgress(JobProgress *progress);
 
+	/// Update block progress by changes of \c i_tasks only (server side).
+	/// Other tasks should not be changed since the previous update.
+	/// Progress bar is updated for changed tasks too, block state is always updated.
+	/// If tasks were not counted (or tasks number changed), all tasks are updated.
+	bool updateTasksProgress(JobProgress *progress, const std::vector<int> &i_tasks);
+
 	// Functions to update tasks progress and progress bar:
 	// (for information purpose only, no meaning for server)
 	void updateBars(JobProgress *progress);
@@ -426,11 +438,41 @@ private:
 	void setVariableCapacity(int i_capacity_coeff_min, int i_capacity_coeff_max);
 	bool setMultiHost(int i_min, int i_max, int i_waitmax, const std::string &i_service, int i_waitsrv);
 
+	/// Find a task that can be ready, from \c i_task forward or backward.
+	/// Returns tasks number or -1 if there is no such task.
+	int findTaskReady(int i_task);
+	int findTaskReadyBack(int i_task) const;
+	/// Check task progress state, forget the task if it is not ready any more.
+	bool isTaskReady(TaskProgressView *i_tp, int i_task);
+
 	/// Set one exact \c pos bit in \c array to \c value .
 	static void setProgressBit(uint8_t *array, int pos, bool value);
 	/// Set progress bits in \c array with \c size at \c pos to \c value .
 	void setProgress(uint8_t *array, int task, bool value);
 
+	/// Task state, percent and run time as it is counted in block progress.
+	struct TaskCounted
+	{
+		uint32_t state;
+		int8_t percent;
+		int64_t run_time;
+	};
+
+	/// Get how task progress is counted in block progress.
+	static void countedTask(const TaskProgressView &i_tp, TaskCounted &o_task);
+
+	/// Add (i_sign = 1) or subtract (i_sign = -1) task from block progress counters.
+	void countTask(const TaskCounted &i_task, int i_sign);
+
+	/// Set block state from progress counters.
+	void updateState();
+
+	/// Get the most important ASCII progress value of a task state.
+	static int getBarValue(uint32_t i_state);
+
+	/// Calculate progress bar character from tasks covering it.
+	void updateBar(JobProgress *progress, int i_pos);
+
 private:
 	char p_progressbar[AFJOB::ASCII_PROGRESS_LENGTH];
 	uint8_t p_percentage;	 ///< Tasks average percentage.
@@ -443,6 +485,18 @@ private:
 	int32_t p_tasks_skipped;  ///< Number of skipped tasks.
 	int32_t p_tasks_waitrec;  ///< Number of tasks waiting for reconnect.
 	int32_t p_tasks_waitdep;  ///< Number of tasks waiting for dependencies.
+
+	/// Tasks that can be ready, a bit per task, stored on progress update (server side only).
+	/// Solving skips tasks without a bit, not to check each task progress state.
+	/// It can have a task that is not ready any more, but not miss a ready one.
+	std::vector<uint64_t> m_tasks_ready;
+	int m_tasks_ready_num;   ///< Tasks number ready tasks were stored for, -1 if they were not.
+	int m_tasks_ready_first; ///< All words before this one have no ready tasks.
 	int64_t p_tasks_run_time; ///< Tasks run time summ.
+
+	/// Tasks as they were counted in progress (server side only).
+	/// Progress can be updated by changed tasks only, without all tasks counting.
+	std::vector<TaskCounted> m_tasks_counted;
+	int64_t m_tasks_percent_sum; ///< Counted tasks percentage summ.
 };
 }
@@ -0,0 +1,110 @@
+#include "dlConditionVariable.h"
+
+#include "dlMutex.h"
+
+#ifdef _WIN32
+
+/* Condition variables are available since Vista. */
+#ifndef _WIN32_WINNT
+#	define _WIN32_WINNT 0x0600
+#endif
+#include <windows.h>
+
+DlConditionVariable::DlConditionVariable()
+{
+	CONDITION_VARIABLE *cond = new CONDITION_VARIABLE;
+
+	InitializeConditionVariable(cond);
+
+	m_data = cond;
+}
+
+DlConditionVariable::~DlConditionVariable()
+{
+	delete (CONDITION_VARIABLE*) m_data;
+}
+
+void DlConditionVariable::Wait(DlMutex *i_mutex)
+{
+	SleepConditionVariableCS(
+		(CONDITION_VARIABLE*) m_data, (CRITICAL_SECTION*) &i_mutex->m_data[0], INFINITE);
+}
+
+bool DlConditionVariable::TimedWait(DlMutex *i_mutex, int i_msec)
+{
+	if (i_msec < 0)
+		i_msec = 0;
+
+	return 0 != SleepConditionVariableCS(
+		(CONDITION_VARIABLE*) m_data, (CRITICAL_SECTION*) &i_mutex->m_data[0], i_msec);
+}
+
+void DlConditionVariable::Signal()
+{
+	WakeConditionVariable((CONDITION_VARIABLE*) m_data);
+}
+
+void DlConditionVariable::Broadcast()
+{
+	WakeAllConditionVariable((CONDITION_VARIABLE*) m_data);
+}
+
+#else
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+DlConditionVariable::DlConditionVariable()
+{
+	pthread_cond_t *cond = new pthread_cond_t;
+
+	pthread_cond_init(cond, 0x0);
+
+	m_data = cond;
+}
+
+DlConditionVariable::~DlConditionVariable()
+{
+	pthread_cond_t *cond = (pthread_cond_t*) m_data;
+
+	pthread_cond_destroy(cond);
+
+	delete cond;
+}
+
+void DlConditionVariable::Wait(DlMutex *i_mutex)
+{
+	pthread_cond_wait((pthread_cond_t*) m_data, (pthread_mutex_t*) &i_mutex->m_data[0]);
+}
+
+bool DlConditionVariable::TimedWait(DlMutex *i_mutex, int i_msec)
+{
+	if (i_msec < 0)
+		i_msec = 0;
+
+	/* pthread_cond_timedwait() needs an absolute (real) time. */
+	struct timeval now;
+	gettimeofday(&now, 0x0);
+
+	long long nsec = (long long)(now.tv_usec) * 1000 + (long long)(i_msec % 1000) * 1000000;
+
+	struct timespec abstime;
+	abstime.tv_sec = now.tv_sec + i_msec / 1000 + nsec / 1000000000;
+	abstime.tv_nsec = nsec % 1000000000;
+
+	return ETIMEDOUT != pthread_cond_timedwait(
+		(pthread_cond_t*) m_data, (pthread_mutex_t*) &i_mutex->m_data[0], &abstime);
+}
+
+void DlConditionVariable::Signal()
+{
+	pthread_cond_signal((pthread_cond_t*) m_data);
+}
+
+void DlConditionVariable::Broadcast()
+{
+	pthread_cond_broadcast((pthread_cond_t*) m_data);
+}
+
+#endif
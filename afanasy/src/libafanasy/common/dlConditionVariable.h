@@ -0,0 +1,43 @@
+#ifndef __dlConditionVariable_h
+#define __dlConditionVariable_h
+
+/*
+	DlConditionVariable
+
+	A simple wrapper around system-specific condition variables.
+	It is used together with a DlMutex, which must be locked (once) by the
+	calling thread before Wait() or TimedWait() is called.
+*/
+
+class DlMutex;
+
+class DlConditionVariable
+{
+	DlConditionVariable(const DlConditionVariable&);
+	void operator=(const DlConditionVariable&);
+
+public:
+	DlConditionVariable();
+	~DlConditionVariable();
+
+	/* Release the mutex, wait for a signal and lock the mutex again. */
+	void Wait(DlMutex *i_mutex);
+
+	/*
+		Same as Wait() but returns after i_msec milliseconds if no signal
+		was received. Returns false on timeout.
+	*/
+	bool TimedWait(DlMutex *i_mutex, int i_msec);
+
+	/* Wake one waiting thread. */
+	void Signal();
+
+	/* Wake all waiting threads. */
+	void Broadcast();
+
+private:
+	/* This is opaque because it needs system specific types. */
+	void *m_data;
+};
+
+#endif // __dlConditionVariable_h
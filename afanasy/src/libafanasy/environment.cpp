@@ -61,6 +61,7 @@ int     Environment::task_reconnect_timeout =          AFJOB::TASK_RECONNECT_TIM
 int     Environment::serverport =                      AFADDR::SERVER_PORT;
 
 int     Environment::monitor_zombietime =              AFMONITOR::ZOMBIETIME;
+int     Environment::monitor_events_wait_sec =         AFMONITOR::EVENTS_WAIT_SEC;
 
 int     Environment::watch_get_events_sec =            AFWATCH::GET_EVENTS_SEC;
 int     Environment::watch_connection_lost_time =      AFWATCH::CONNECTION_LOST_TIME;
@@ -88,6 +89,7 @@ std::string Environment::render_networkif =            AFRENDER::NETWORK_IF;
 std::string Environment::render_hddspace_path =        AFRENDER::HDDSPACE_PATH;
 std::string Environment::render_iostat_device =        AFRENDER::IOSTAT_DEVICE;
 bool Environment::render_cut_domain_name =             AFRENDER::CUT_DOMAIN_NAME;
+bool Environment::render_connection_keep =             AFRENDER::CONNECTION_KEEP;
 int Environment::render_overflow_mem  = -1;
 int Environment::render_overflow_swap = -1;
 int Environment::render_overflow_hdd  = -1;
@@ -116,9 +118,25 @@ int Environment::server_sockets_processing_threads_num   = AFSERVER::SOCKETS_PRO
 int Environment::server_sockets_processing_threads_stack = AFSERVER::SOCKETS_PROCESSING_THREADS_STACK;
 
 int Environment::server_linux_epoll      = AFSERVER::LINUX_EPOLL;
+int Environment::server_linux_io_uring   = AFSERVER::LINUX_IO_URING;
 int Environment::server_http_wait_close  = AFSERVER::HTTP_WAIT_CLOSE;
+int Environment::server_http_keep_alive_sec = AFSERVER::HTTP_KEEP_ALIVE_SEC;
+int Environment::server_http_gzip_size_min = AFSERVER::HTTP_GZIP_SIZE_MIN;
+int Environment::server_sockets_queue_max = AFSERVER::SOCKETS_QUEUE_MAX;
+int Environment::server_client_rate       = AFSERVER::CLIENT_RATE;
+int Environment::server_render_register_rate = AFSERVER::RENDER_REGISTER_RATE;
+int Environment::server_store_load_threads = AFSERVER::STORE_LOAD_THREADS;
+int Environment::server_store_log        = AFSERVER::STORE_LOG;
+int Environment::server_store_log_snapshot_sec = AFSERVER::STORE_LOG_SNAPSHOT_SEC;
+int Environment::server_files_write_threads = AFSERVER::FILES_WRITE_THREADS;
 int Environment::server_profiling_sec    = AFSERVER::PROFILING_SEC;
 
+int Environment::server_run_cycle_wakeup     = AFSERVER::RUN_CYCLE_WAKEUP;
+int Environment::server_run_cycle_min_msec   = AFSERVER::RUN_CYCLE_MIN_MSEC;
+int Environment::server_run_cycle_batch_msec = AFSERVER::RUN_CYCLE_BATCH_MSEC;
+
+int Environment::server_list_snapshot_sec    = AFSERVER::LIST_SNAPSHOT_SEC;
+
 /// Socket Options:
 int Environment::so_server_LINGER       = AFNETWORK::SO_SERVER_LINGER;
 int Environment::so_server_REUSEADDR    = AFNETWORK::SO_SERVER_REUSEADDR;
@@ -144,6 +162,9 @@ std::string Environment::db_conninfo =                     AFDATABASE::CONNINFO;
 std::string Environment::db_stringquotes =                 AFDATABASE::STRINGQUOTES;
 int Environment::db_stringnamelen =                AFDATABASE::STRINGNAMELEN;
 int Environment::db_stringexprlen =                AFDATABASE::STRINGEXPRLEN;
+int Environment::db_batchrows =                    AFDATABASE::BATCH_ROWS;
+int Environment::db_batchsec =                     AFDATABASE::BATCH_SEC;
+int Environment::db_queuekb =                      AFDATABASE::QUEUE_KB;
 
 std::string Environment::store_folder = AFGENERAL::STORE_FOLDER;
 std::string Environment::store_folder_branches;
@@ -257,6 +278,9 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, db_stringquotes,                   "af_db_stringquotes"                   );
 	getVar( i_obj, db_stringnamelen,                  "af_db_stringnamelen"                  );
 	getVar( i_obj, db_stringexprlen,                  "af_db_stringexprlen"                  );
+	getVar( i_obj, db_batchrows,                      "af_db_batchrows"                      );
+	getVar( i_obj, db_batchsec,                       "af_db_batchsec"                       );
+	getVar( i_obj, db_queuekb,                        "af_db_queue_kb"                       );
 
 	getVar( i_obj, server_sockets_readwrite_threads_num,    "af_server_sockets_readwrite_threads_num"    );
 	getVar( i_obj, server_sockets_readwrite_threads_stack,  "af_server_sockets_readwrite_threads_stack"  );
@@ -264,9 +288,25 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, server_sockets_processing_threads_stack, "af_server_sockets_processing_threads_stack" );
 
 	getVar( i_obj, server_linux_epoll,                "af_server_linux_epoll"                );
+	getVar( i_obj, server_linux_io_uring,             "af_server_linux_io_uring"             );
 	getVar( i_obj, server_http_wait_close,            "af_server_http_wait_close"            );
+	getVar( i_obj, server_http_keep_alive_sec,        "af_server_http_keep_alive_sec"        );
+	getVar( i_obj, server_http_gzip_size_min,         "af_server_http_gzip_size_min"         );
+	getVar( i_obj, server_sockets_queue_max,          "af_server_sockets_queue_max"          );
+	getVar( i_obj, server_client_rate,                "af_server_client_rate"                );
+	getVar( i_obj, server_render_register_rate,       "af_server_render_register_rate"       );
+	getVar( i_obj, server_store_load_threads,         "af_server_store_load_threads"         );
+	getVar( i_obj, server_store_log,                  "af_server_store_log"                  );
+	getVar( i_obj, server_store_log_snapshot_sec,     "af_server_store_log_snapshot_sec"     );
+	getVar( i_obj, server_files_write_threads,        "af_server_files_write_threads"        );
 	getVar( i_obj, server_profiling_sec,              "af_server_profiling_sec"              );
 
+	getVar( i_obj, server_run_cycle_wakeup,           "af_server_run_cycle_wakeup"           );
+	getVar( i_obj, server_run_cycle_min_msec,         "af_server_run_cycle_min_msec"         );
+	getVar( i_obj, server_run_cycle_batch_msec,       "af_server_run_cycle_batch_msec"       );
+
+	getVar( i_obj, server_list_snapshot_sec,          "af_server_list_snapshot_sec"          );
+
 	/// Socket Options:
 	getVar( i_obj, so_server_LINGER,                  "af_so_server_LINGER"                  );
 	getVar( i_obj, so_server_REUSEADDR,               "af_so_server_REUSEADDR"               );
@@ -306,6 +346,7 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, render_launch_cmds,                "af_render_launch_cmds"                );
 	getVar( i_obj, render_launch_cmds_exit,           "af_render_launch_cmds_exit"           );
 	getVar( i_obj, render_cut_domain_name,            "af_render_cut_domain_name"            );
+	getVar( i_obj, render_connection_keep,            "af_render_connection_keep"            );
 
 	getVar( i_obj, watch_get_events_sec,              "af_watch_get_events_sec"              );
 	getVar( i_obj, watch_refresh_gui_sec,             "af_watch_refresh_gui_sec"             );
@@ -314,6 +355,7 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, watch_work_user_visible,           "af_watch_work_user_visible"           );
 
 	getVar( i_obj, monitor_zombietime,                "af_monitor_zombietime"                );
+	getVar( i_obj, monitor_events_wait_sec,           "af_monitor_events_wait_sec"           );
 
 	getVar( i_obj, errors_forgivetime,                "af_errors_forgivetime"                );
 	getVar( i_obj, errors_avoid_host,                 "af_errors_avoid_host"                 );
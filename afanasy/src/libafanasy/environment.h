@@ -123,6 +123,7 @@ public:
 	static inline const std::vector<std::string> & getRenderLaunchCmdsExit() { return render_launch_cmds_exit; }
 
 	static inline int getMonitorZombieTime()             { return monitor_zombietime;           }
+	static inline int getMonitorEventsWaitSec()          { return monitor_events_wait_sec;      }
 
 	static inline int  getWatchGetEventsSec()       { return watch_get_events_sec;      }
 	static inline int  getWatchRefreshGuiSec()      { return watch_refresh_gui_sec;     }
@@ -183,6 +184,8 @@ public:
 	static inline int getRenderOverflowSwap() {return render_overflow_swap;}
 	static inline int getRenderOverflowHDD()  {return render_overflow_hdd; }
 
+	static inline bool getRenderConnectionKeep() { return render_connection_keep; }
+
 	static inline int getAfNodeLogLinesMax() { return afnode_log_lines_max; }
 
 	static inline const std::string & getStoreFolder()        { return store_folder;         }
@@ -196,6 +199,9 @@ public:
 	static inline const std::string & get_DB_StringQuotes()    { return db_stringquotes; } ///< Get database string quotes.
 	static inline int                 get_DB_StringNameLen()   { return db_stringnamelen;} ///< Get database string name length.
 	static inline int                 get_DB_StringExprLen()   { return db_stringexprlen;} ///< Get database string expression length.
+	static inline int                 get_DB_BatchRows()       { return db_batchrows;    } ///< Get database statistics insert batch rows.
+	static inline int                 get_DB_BatchSec()        { return db_batchsec;     } ///< Get database statistics insert batch seconds.
+	static inline int                 get_DB_QueueKB()         { return db_queuekb;      } ///< Get database queue size to spill queries to journal.
 
 	static inline int getServerSocketsReadWriteThreadsNum()    { return server_sockets_readwrite_threads_num;    }
 	static inline int getServerSocketsReadWriteThreadsStack()  { return server_sockets_readwrite_threads_stack;  }
@@ -203,11 +209,31 @@ public:
 	static inline int getServerSocketsProcessingThreadsStack() { return server_sockets_processing_threads_stack; }
 
 	static inline int getServerLinuxEpoll() { return server_linux_epoll; }
+	static inline int getServerLinuxIOURing() { return server_linux_io_uring; }
 
 	static inline int getServerHTTPWaitClose() { return server_http_wait_close; }
 
+	static inline int getServerHTTPKeepAliveSec() { return server_http_keep_alive_sec; }
+	static inline int getServerHTTPGzipSizeMin()  { return server_http_gzip_size_min;  }
+
+	static inline int getServerSocketsQueueMax()    { return server_sockets_queue_max;    }
+	static inline int getServerClientRate()         { return server_client_rate;          }
+	static inline int getServerRenderRegisterRate() { return server_render_register_rate; }
+
+	static inline int getServerStoreLoadThreads() { return server_store_load_threads; }
+	static inline bool isServerStoreLog()           { return server_store_log;              }
+	static inline int getServerStoreLogSnapshotSec() { return server_store_log_snapshot_sec; }
+
+	static inline int getServerFilesWriteThreads() { return server_files_write_threads; }
+
 	static inline int getServerProfilingSec() { return server_profiling_sec; }
 
+	static inline int getServerRunCycleWakeup()    { return server_run_cycle_wakeup;     }
+	static inline int getServerRunCycleMinMSec()   { return server_run_cycle_min_msec;   }
+	static inline int getServerRunCycleBatchMSec() { return server_run_cycle_batch_msec; }
+
+	static inline int getServerListSnapshotSec() { return server_list_snapshot_sec; }
+
 	/// Socket Options:
 	static inline int getSO_LINGER()       { return m_server ? so_server_LINGER       : so_client_LINGER       ;}
 	static inline int getSO_REUSEADDR()    { return m_server ? so_server_REUSEADDR    : so_client_REUSEADDR    ;}
@@ -325,6 +351,7 @@ private:
 	static bool watch_work_user_visible;
 
 	static int monitor_zombietime;
+	static int monitor_events_wait_sec;
 
 	static std::string timeformat;    ///< Default time format.
 
@@ -350,6 +377,7 @@ private:
 	static std::string render_networkif;
 
 	static bool render_cut_domain_name;
+	static bool render_connection_keep;
 
 	static int render_overflow_mem;
 	static int render_overflow_swap;
@@ -381,6 +409,9 @@ private:
 	static std::string db_stringquotes;   ///< Database string quotes
 	static int         db_stringnamelen;  ///< Database string name length
 	static int         db_stringexprlen;  ///< Database string expression length
+	static int         db_batchrows;      ///< Database statistics insert batch rows
+	static int         db_batchsec;       ///< Database statistics insert batch seconds
+	static int         db_queuekb;        ///< Database queue size to spill queries to journal
 
 	// Server incoming connections:
 	static int server_sockets_readwrite_threads_num;
@@ -389,9 +420,25 @@ private:
 	static int server_sockets_processing_threads_stack;
 
 	static int server_linux_epoll;
+	static int server_linux_io_uring;
 	static int server_http_wait_close;
+	static int server_http_keep_alive_sec;
+	static int server_http_gzip_size_min;
+	static int server_sockets_queue_max;
+	static int server_client_rate;
+	static int server_render_register_rate;
+	static int server_store_load_threads;
+	static int server_store_log;
+	static int server_store_log_snapshot_sec;
+	static int server_files_write_threads;
 	static int server_profiling_sec;
 
+	static int server_run_cycle_wakeup;
+	static int server_run_cycle_min_msec;
+	static int server_run_cycle_batch_msec;
+
+	static int server_list_snapshot_sec;
+
 	/// Socket Options:
 	static int so_server_LINGER;
 	static int so_server_REUSEADDR;
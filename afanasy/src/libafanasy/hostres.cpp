@@ -94,7 +94,14 @@ HostRes::HostRes():
     hdd_busy(0),
 
     net_recv_kbsec(0),
-    net_send_kbsec(0)
+    net_send_kbsec(0),
+
+	gpu_gpu_util(0),
+	gpu_gpu_temp(0),
+	gpu_mem_total_mb(0),
+	gpu_mem_used_mb(0),
+
+	delta(DAll)
 {
 	cpu_loadavg[0] = cpu_loadavg[1] = cpu_loadavg[2] = 0;
 }
@@ -157,6 +164,276 @@ void HostRes::copy( const HostRes & other)
         *(custom[i]) = *(other.custom[i]);
 }
 
+void HostRes::setDelta( const HostRes * i_sent)
+{
+	if( NULL == i_sent )
+	{
+		delta = DAll;
+		return;
+	}
+
+	const HostRes & o = *i_sent;
+	delta = 0;
+
+	if(( cpu_num != o.cpu_num ) || ( cpu_mhz != o.cpu_mhz ))
+		delta |= DCPU;
+
+	if(( cpu_loadavg[0] != o.cpu_loadavg[0] ) || ( cpu_loadavg[1] != o.cpu_loadavg[1] ) || ( cpu_loadavg[2] != o.cpu_loadavg[2] ))
+		delta |= DCPULoadAvg;
+
+	if(( cpu_user != o.cpu_user ) || ( cpu_nice    != o.cpu_nice    ) || ( cpu_system  != o.cpu_system ) ||
+		( cpu_idle != o.cpu_idle ) || ( cpu_iowait != o.cpu_iowait ) || ( cpu_irq != o.cpu_irq ) || ( cpu_softirq != o.cpu_softirq ))
+		delta |= DCPUUsage;
+
+	if(( mem_total_mb  != o.mem_total_mb  ) || ( mem_free_mb    != o.mem_free_mb    ) ||
+		( mem_cached_mb != o.mem_cached_mb ) || ( mem_buffers_mb != o.mem_buffers_mb ))
+		delta |= DMem;
+
+	if(( swap_total_mb != o.swap_total_mb ) || ( swap_used_mb != o.swap_used_mb ))
+		delta |= DSwap;
+
+	if(( hdd_total_gb != o.hdd_total_gb ) || ( hdd_free_gb != o.hdd_free_gb ))
+		delta |= DHDD;
+
+	if(( hdd_rd_kbsec != o.hdd_rd_kbsec ) || ( hdd_wr_kbsec != o.hdd_wr_kbsec ) || ( hdd_busy != o.hdd_busy ))
+		delta |= DHDDIO;
+
+	if(( net_recv_kbsec != o.net_recv_kbsec ) || ( net_send_kbsec != o.net_send_kbsec ))
+		delta |= DNet;
+
+	if(( gpu_gpu_util     != o.gpu_gpu_util     ) || ( gpu_gpu_temp    != o.gpu_gpu_temp    ) ||
+		( gpu_mem_total_mb != o.gpu_mem_total_mb ) || ( gpu_mem_used_mb != o.gpu_mem_used_mb ))
+		delta |= DGPU;
+
+	if( gpu_string != o.gpu_string )
+		delta |= DGPUString;
+
+	if( logged_in_users != o.logged_in_users )
+		delta |= DUsers;
+
+	if( custom.size() != o.custom.size())
+		delta |= DCustom;
+	else
+		for( unsigned i = 0; i < custom.size(); i++)
+		{
+			const HostResCustom & c = *custom[i];
+			const HostResCustom & oc = *o.custom[i];
+
+			if(( c.width    != oc.width    ) || ( c.height   != oc.height   ) ||
+				( c.graphr   != oc.graphr   ) || ( c.graphg   != oc.graphg   ) || ( c.graphb   != oc.graphb   ) ||
+				( c.labelsize != oc.labelsize ) ||
+				( c.labelr   != oc.labelr   ) || ( c.labelg   != oc.labelg   ) || ( c.labelb   != oc.labelb   ) ||
+				( c.bgcolorr != oc.bgcolorr ) || ( c.bgcolorg != oc.bgcolorg ) || ( c.bgcolorb != oc.bgcolorb ) ||
+				( c.label    != oc.label    ) || ( c.tooltip  != oc.tooltip  ))
+			{
+				delta |= DCustom;
+				break;
+			}
+
+			if(( c.value != oc.value ) || ( c.valuemax != oc.valuemax ))
+				delta |= DCustomValues;
+		}
+}
+
+void HostRes::copyDelta( const HostRes & i_delta)
+{
+	const HostRes & o = i_delta;
+
+	if( o.delta & DCPU )
+	{
+		cpu_num = o.cpu_num;
+		cpu_mhz = o.cpu_mhz;
+	}
+
+	if( o.delta & DCPULoadAvg )
+	{
+		cpu_loadavg[0] = o.cpu_loadavg[0];
+		cpu_loadavg[1] = o.cpu_loadavg[1];
+		cpu_loadavg[2] = o.cpu_loadavg[2];
+	}
+
+	if( o.delta & DCPUUsage )
+	{
+		cpu_user    = o.cpu_user;
+		cpu_nice    = o.cpu_nice;
+		cpu_system  = o.cpu_system;
+		cpu_idle    = o.cpu_idle;
+		cpu_iowait  = o.cpu_iowait;
+		cpu_irq     = o.cpu_irq;
+		cpu_softirq = o.cpu_softirq;
+	}
+
+	if( o.delta & DMem )
+	{
+		mem_total_mb   = o.mem_total_mb;
+		mem_free_mb    = o.mem_free_mb;
+		mem_cached_mb  = o.mem_cached_mb;
+		mem_buffers_mb = o.mem_buffers_mb;
+	}
+
+	if( o.delta & DSwap )
+	{
+		swap_total_mb = o.swap_total_mb;
+		swap_used_mb  = o.swap_used_mb;
+	}
+
+	if( o.delta & DHDD )
+	{
+		hdd_total_gb = o.hdd_total_gb;
+		hdd_free_gb  = o.hdd_free_gb;
+	}
+
+	if( o.delta & DHDDIO )
+	{
+		hdd_rd_kbsec = o.hdd_rd_kbsec;
+		hdd_wr_kbsec = o.hdd_wr_kbsec;
+		hdd_busy     = o.hdd_busy;
+	}
+
+	if( o.delta & DNet )
+	{
+		net_recv_kbsec = o.net_recv_kbsec;
+		net_send_kbsec = o.net_send_kbsec;
+	}
+
+	if( o.delta & DGPU )
+	{
+		gpu_gpu_util     = o.gpu_gpu_util;
+		gpu_gpu_temp     = o.gpu_gpu_temp;
+		gpu_mem_total_mb = o.gpu_mem_total_mb;
+		gpu_mem_used_mb  = o.gpu_mem_used_mb;
+	}
+
+	if( o.delta & DGPUString )
+		gpu_string = o.gpu_string;
+
+	if( o.delta & DUsers )
+		logged_in_users = o.logged_in_users;
+
+	if( o.delta & DCustom )
+	{
+		for( unsigned i = 0; i < custom.size(); i++)
+			if( custom[i] ) delete custom[i];
+		custom.clear();
+
+		for( unsigned i = 0; i < o.custom.size(); i++)
+			custom.push_back( new HostResCustom( *o.custom[i]));
+	}
+	else if(( o.delta & DCustomValues ) && ( custom.size() == o.custom.size()))
+	{
+		for( unsigned i = 0; i < custom.size(); i++)
+		{
+			custom[i]->value    = o.custom[i]->value;
+			custom[i]->valuemax = o.custom[i]->valuemax;
+		}
+	}
+}
+
+void HostRes::readwriteDelta( Msg * msg)
+{
+	rw_uint16_t( delta, msg);
+
+	if( delta & DCPU )
+	{
+		rw_int32_t( cpu_num, msg);
+		rw_int32_t( cpu_mhz, msg);
+	}
+
+	if( delta & DCPULoadAvg )
+	{
+		rw_uint8_t( cpu_loadavg[0], msg);
+		rw_uint8_t( cpu_loadavg[1], msg);
+		rw_uint8_t( cpu_loadavg[2], msg);
+	}
+
+	if( delta & DCPUUsage )
+	{
+		rw_uint8_t( cpu_user,    msg);
+		rw_uint8_t( cpu_nice,    msg);
+		rw_uint8_t( cpu_system,  msg);
+		rw_uint8_t( cpu_idle,    msg);
+		rw_uint8_t( cpu_iowait,  msg);
+		rw_uint8_t( cpu_irq,     msg);
+		rw_uint8_t( cpu_softirq, msg);
+	}
+
+	if( delta & DMem )
+	{
+		rw_int32_t( mem_total_mb,   msg);
+		rw_int32_t( mem_free_mb,    msg);
+		rw_int32_t( mem_cached_mb,  msg);
+		rw_int32_t( mem_buffers_mb, msg);
+	}
+
+	if( delta & DSwap )
+	{
+		rw_int32_t( swap_total_mb, msg);
+		rw_int32_t( swap_used_mb,  msg);
+	}
+
+	if( delta & DHDD )
+	{
+		rw_int32_t( hdd_total_gb, msg);
+		rw_int32_t( hdd_free_gb,  msg);
+	}
+
+	if( delta & DHDDIO )
+	{
+		rw_int32_t( hdd_rd_kbsec, msg);
+		rw_int32_t( hdd_wr_kbsec, msg);
+		rw_int8_t ( hdd_busy,     msg);
+	}
+
+	if( delta & DNet )
+	{
+		rw_int32_t( net_recv_kbsec, msg);
+		rw_int32_t( net_send_kbsec, msg);
+	}
+
+	if( delta & DGPU )
+	{
+		rw_int8_t ( gpu_gpu_util,     msg);
+		rw_int8_t ( gpu_gpu_temp,     msg);
+		rw_int32_t( gpu_mem_total_mb, msg);
+		rw_int32_t( gpu_mem_used_mb,  msg);
+	}
+
+	if( delta & DGPUString )
+		rw_String( gpu_string, msg);
+
+	if( delta & DUsers )
+		rw_StringVect( logged_in_users, msg);
+
+	if( delta & ( DCustom | DCustomValues ))
+	{
+		uint8_t custom_count = uint8_t( custom.size());
+
+		if( msg->isReading())
+		{
+			for( int i = 0; i < custom_count; i++) delete custom[i];
+			custom.clear();
+		}
+
+		rw_uint8_t( custom_count, msg);
+
+		for( int i = 0; i < custom_count; i++)
+		{
+			if( msg->isReading())
+				custom.push_back( new HostResCustom());
+
+			if( delta & DCustom )
+			{
+				custom[i]->v_readwrite( msg);
+			}
+			else
+			{
+				rw_int32_t( custom[i]->value,    msg);
+				rw_int32_t( custom[i]->valuemax, msg);
+			}
+		}
+	}
+}
+
 void HostRes::jsonWrite( std::ostringstream & o_str) const
 {
 	o_str << "\"host_resources\":{";
@@ -84,6 +84,31 @@ public:
 
 	std::vector<HostResCustom*> custom;
 
+	/// Delta mode fields presence bits.
+	/// Render updates send only fields that changed since resources were sent last time.
+	/// Custom resources descriptors are sent only on changes (and on registration), values otherwise.
+	enum DeltaBits
+	{
+		DCPU          = 1 << 0,  ///< cpu_num, cpu_mhz
+		DCPULoadAvg   = 1 << 1,
+		DCPUUsage     = 1 << 2,  ///< cpu_user ... cpu_softirq
+		DMem          = 1 << 3,
+		DSwap         = 1 << 4,
+		DHDD          = 1 << 5,  ///< hdd_total_gb, hdd_free_gb
+		DHDDIO        = 1 << 6,  ///< hdd_rd_kbsec, hdd_wr_kbsec, hdd_busy
+		DNet          = 1 << 7,
+		DGPU          = 1 << 8,  ///< gpu utilization, temperature and memory
+		DGPUString    = 1 << 9,
+		DUsers        = 1 << 10,
+		DCustomValues = 1 << 11, ///< Only custom resources values
+		DCustom       = 1 << 12, ///< Custom resources with descriptors
+
+		DAll          = (1 << 13) - 1
+	};
+
+	/// Fields presence bits in delta mode.
+	uint16_t delta;
+
 public:
 	/// Generate information.
 	void v_generateInfoStream( std::ostringstream & stream, bool full = false) const;
@@ -93,6 +118,16 @@ public:
 
 	void copy( const HostRes & other);
 
+	/// Set delta bits of fields that differ from resources sent last time.
+	/// NULL means that nothing was sent, all fields will be present.
+	void setDelta( const HostRes * i_sent);
+
+	/// Copy only fields that are present in delta.
+	void copyDelta( const HostRes & i_delta);
+
+	/// Read or write only fields that are present in delta.
+	void readwriteDelta( Msg * msg);
+
 	void jsonWrite( std::ostringstream & o_str) const;
 
 	void v_readwrite( Msg * msg); ///< Read or write Host Resources in message.
@@ -1,5 +1,7 @@
 #include "jobprogress.h"
 
+#include <map>
+
 #include "msg.h"
 #include "job.h"
 #include "blockdata.h"
@@ -109,8 +111,8 @@ bool JobProgress::initBlocks()
       return false;
    }
 
-   tasksnum = new int32_t        [ m_blocks_num];
-   tp       = new TaskProgress **[ m_blocks_num]();
+   tasksnum = new int32_t          [ m_blocks_num];
+   tp       = new TaskProgressView *[ m_blocks_num]();
 
    return true;
 }
@@ -126,8 +128,8 @@ void JobProgress::appendBlocks(int numblocks)
 		tasksnum[b] = b < old_blocks_num ? old_tasksnum[b] : 0;
 	if( old_tasksnum != NULL) delete [] old_tasksnum;
 
-	TaskProgress ***old_tp = tp;
-	tp = new TaskProgress **[ m_blocks_num]();
+	TaskProgressView **old_tp = tp;
+	tp = new TaskProgressView *[ m_blocks_num]();
 	for (int b = 0; b < m_blocks_num; b++)
 		tp[b] = b < old_blocks_num ? old_tp[b] : 0;
 	if( old_tp != NULL) delete [] old_tp;
@@ -140,9 +142,10 @@ bool JobProgress::initTasks( int block, int numtasks)
       AFERROR("JobProgress::initTasks: numtasks == 0\n");
       return false;
    }
-   tp[block] = new TaskProgress*[ numtasks];
+   tp[block] = new TaskProgressView[ numtasks];
+   TaskProgressColumns * columns = newTasksProgress( tasksnum[block]);
    for( int t = 0; t < tasksnum[block]; t++)
-      tp[block][t] = newTaskProgress();
+      tp[block][t] = TaskProgressView( columns, t);
 
    return true;
 }
@@ -150,20 +153,24 @@ bool JobProgress::initTasks( int block, int numtasks)
 void JobProgress::appendTasks(int block, int numtasks)
 {
 	int32_t old_tasksnum = tasksnum[block];
-	TaskProgress **old_tp = tp[block];
+	TaskProgressView *old_tp = tp[block];
 
 	tasksnum[block] += numtasks;
-	tp[block] = new TaskProgress*[ tasksnum[block]];
+	tp[block] = new TaskProgressView[ tasksnum[block]];
 
+	// Existing tasks progress can't be moved, as tasks and executions have views on them:
+	TaskProgressColumns * columns = newTasksProgress( numtasks);
 	for( int t = 0; t < tasksnum[block]; t++)
-		tp[block][t] = t < old_tasksnum ? old_tp[t] : newTaskProgress();
+		tp[block][t] = t < old_tasksnum ? old_tp[t] : TaskProgressView( columns, t - old_tasksnum);
 
 	if( old_tp != NULL) delete [] old_tp;
 }
 
-TaskProgress * JobProgress::newTaskProgress() const
+TaskProgressColumns * JobProgress::newTasksProgress( int i_count)
 {
-   return new TaskProgress;
+	TaskProgressColumns * columns = new TaskProgressColumns( i_count, &m_strings);
+	m_columns.push_back( columns);
+	return columns;
 }
 
 JobProgress::~JobProgress()
@@ -175,16 +182,12 @@ AFINFA("JobProgress::~JobProgress: Job Id = %d", m_job_id)
       for( int b = 0; b < m_blocks_num; b++)
       {
          if( tp[b] != NULL )
-         {
-            for( int t = 0; t < tasksnum[b]; t++)
-            {
-               if( tp[b][t] != NULL) delete tp[b][t];
-            }
             delete [] tp[b];
-         }
       }
       delete [] tp;
    }
+   for( int i = 0; i < m_columns.size(); i++)
+      delete m_columns[i];
    if( tasksnum != NULL ) delete [] tasksnum;
 }
 
@@ -244,6 +247,159 @@ void JobProgress::jsonWrite( std::ostringstream & o_str) const
 	o_str << "\n]}}";
 }
 
+namespace
+{
+template <typename T> void jw_column( const char * i_name, const std::vector<T> & i_values, std::ostringstream & o_str)
+{
+	bool empty = true;
+	for( int i = 0; i < i_values.size(); i++)
+		if( i_values[i] != 0 )
+		{
+			empty = false;
+			break;
+		}
+	if( empty )
+		return;
+
+	o_str << ",\n\"" << i_name << "\":[";
+	for( int i = 0; i < i_values.size(); i++)
+	{
+		if( i > 0 ) o_str << ",";
+		o_str << int64_t( i_values[i]);
+	}
+	o_str << "]";
+}
+
+void jw_column( const char * i_name, const std::vector<std::string> & i_values, std::ostringstream & o_str)
+{
+	bool empty = true;
+	for( int i = 0; i < i_values.size(); i++)
+		if( i_values[i].size())
+		{
+			empty = false;
+			break;
+		}
+	if( empty )
+		return;
+
+	o_str << ",\n\"" << i_name << "\":[";
+	for( int i = 0; i < i_values.size(); i++)
+	{
+		if( i > 0 ) o_str << ",";
+		o_str << "\"" << i_values[i] << "\"";
+	}
+	o_str << "]";
+}
+}
+
+void JobProgress::jsonWriteCompact( std::ostringstream & o_str) const
+{
+	o_str << "{\"job_progress\":{";
+	o_str << "\"id\":" << m_job_id << ",\n";
+	o_str << "\"compact\":true,\n";
+	o_str << "\"progress\":[\n";
+	for( int b = 0; b < m_blocks_num; b++)
+	{
+		int count = tasksnum[b];
+
+		std::map<int64_t,int> states_map;
+		std::vector<int64_t> states;
+		std::map<std::string,int> hosts_map;
+		std::vector<std::string> hosts;
+
+		std::vector<int> s( count), hst( count);
+		std::vector<int> per( count), pfr( count), str( count), err( count);
+		std::vector<int64_t> frm( count), tst( count), tdn( count);
+		std::vector<std::string> act( count), res( count);
+
+		for( int t = 0; t < count; t++)
+		{
+			const TaskProgressView & p = tp[b][t];
+
+			std::map<int64_t,int>::const_iterator sIt = states_map.find( p->state);
+			if( sIt == states_map.end())
+			{
+				s[t] = states.size();
+				states_map[p->state] = s[t];
+				states.push_back( p->state);
+			}
+			else
+				s[t] = sIt->second;
+
+			hst[t] = -1;
+			if( p->hostname.size())
+			{
+				std::map<std::string,int>::const_iterator hIt = hosts_map.find( p->hostname);
+				if( hIt == hosts_map.end())
+				{
+					hst[t] = hosts.size();
+					hosts_map[p->hostname] = hst[t];
+					hosts.push_back( p->hostname);
+				}
+				else
+					hst[t] = hIt->second;
+			}
+
+			per[t] = p->percent;
+			frm[t] = p->frame;
+			pfr[t] = p->percentframe;
+			str[t] = p->starts_count;
+			err[t] = p->errors_count;
+			tst[t] = p->time_start;
+			tdn[t] = p->time_done;
+			act[t] = p->activity;
+			res[t] = p->resources;
+		}
+
+		if( b > 0 )
+			o_str << ",\n";
+		o_str << "{\"tasks\":" << count;
+
+		o_str << ",\n\"states\":[";
+		for( int i = 0; i < states.size(); i++)
+		{
+			if( i > 0 ) o_str << ",";
+			o_str << "{";
+			jw_stateJob( states[i], o_str);
+			o_str << ",\"st\":" << states[i] << "}";
+		}
+		o_str << "]";
+
+		o_str << ",\n\"s\":[";
+		for( int t = 0; t < count; t++)
+		{
+			if( t > 0 ) o_str << ",";
+			o_str << s[t];
+		}
+		o_str << "]";
+
+		if( hosts.size())
+		{
+			jw_column("hosts", hosts, o_str);
+			o_str << ",\n\"hst\":[";
+			for( int t = 0; t < count; t++)
+			{
+				if( t > 0 ) o_str << ",";
+				o_str << hst[t];
+			}
+			o_str << "]";
+		}
+
+		jw_column("per", per, o_str);
+		jw_column("frm", frm, o_str);
+		jw_column("pfr", pfr, o_str);
+		jw_column("str", str, o_str);
+		jw_column("err", err, o_str);
+		jw_column("tst", tst, o_str);
+		jw_column("tdn", tdn, o_str);
+		jw_column("act", act, o_str);
+		jw_column("res", res, o_str);
+
+		o_str << "}";
+	}
+	o_str << "\n]}}";
+}
+
 int JobProgress::calcWeight() const
 {
    int weight  = sizeof(JobProgress);
@@ -251,9 +407,10 @@ int JobProgress::calcWeight() const
    {
       weight += sizeof(*tasksnum);
       weight += tasksnum[b] * sizeof(**tp);
-      for( int t = 0; t < tasksnum[b]; t++)
-         weight += tp[b][t]->calcWeight();
    }
+   for( int i = 0; i < m_columns.size(); i++)
+      weight += m_columns[i]->calcWeight();
+   weight += m_strings.calcWeight();
    return weight;
 }
 
@@ -41,8 +41,15 @@ public:
 
 	void jsonWrite( std::ostringstream & o_str) const;
 
+	/// Write progress in columns: each block is an object of per task values arrays.
+	/** States and hosts are written once per block, tasks have indexes in them.
+	*** Columns with no values are not written.
+	**/
+	void jsonWriteCompact( std::ostringstream & o_str) const;
+
 public:
-   TaskProgress  ***tp;
+   /// Tasks progress views per block per task, values are stored in columns.
+   TaskProgressView **tp;
 
 protected:
    bool construct( Job * job);               ///< Construct progress blocks and tasks data.
@@ -56,7 +63,16 @@ protected:
 
 private:
 	void initProperties();
-	virtual TaskProgress * newTaskProgress() const;
+
+	/// Allocate tasks progress columns, tasks progress views are pointing in them.
+	TaskProgressColumns * newTasksProgress( int i_count);
+
+private:
+	/// Allocated tasks columns, each block has columns for initial tasks and for each tasks appending.
+	std::vector<TaskProgressColumns*> m_columns;
+
+	/// Tasks hosts, activities and resources, shared by all job tasks.
+	TaskProgressStrings m_strings;
 
 private:
    int32_t m_job_id;               ///< Job id.
@@ -10,6 +10,7 @@
 #include "msgclasses/mctest.h"
 #include "environment.h"
 #include "address.h"
+#include "msgbufferpool.h"
 
 #define AFOUTPUT
 #undef AFOUTPUT
@@ -70,9 +71,38 @@ Msg::Msg( const char * rawData, int rawDataLen):
 	rw_header( false);                     // Read header information from the buffer.
 }
 
+Msg::Msg( int i_type, char * i_buffer, int i_buffer_size, int i_data_len):
+	m_version( Msg::Version),
+	m_type( i_type),
+	m_int32( i_data_len),
+	m_buffer( i_buffer),
+	m_writing( false),
+	m_buffer_size( i_buffer_size),
+	m_writtensize( 0),
+	m_header_offset( 0),
+	m_http_accept_gzip( false),
+	m_http_gzip( false)
+{
+	m_data         = m_buffer      + Msg::SizeHeader;
+	m_data_maxsize = m_buffer_size - Msg::SizeHeader;
+
+	if(( i_type < Msg::TDATA ) || ( i_data_len <= 0 ) || ( i_data_len > m_data_maxsize ))
+	{
+		AFERRAR("Msg::Msg: Invalid buffer to adopt: type=%d, data length=%d, buffer size=%d.", i_type, i_data_len, i_buffer_size)
+		setInvalid();
+		return;
+	}
+
+	// Default header type for JSON - not binary, as in setData
+	if(( m_type == Msg::TJSON ) || ( m_type == Msg::THTTPGET ))
+		m_header_offset = Msg::SizeHeader;
+
+	rw_header( true);
+}
+
 Msg::~Msg()
 {
-	if( m_buffer != NULL) delete [] m_buffer;
+	MsgBufferPool::Release( m_buffer, m_buffer_size);
 }
 //
 //########################## Message methods: #################################
@@ -85,6 +115,9 @@ void Msg::construct()
 
 	m_header_offset = 0;
 
+	m_http_accept_gzip = false;
+	m_http_gzip = false;
+
 	m_writing = false;
 	m_writtensize = 0;
 
@@ -104,9 +137,10 @@ bool Msg::allocateBuffer( int i_size, int i_copy_len, int i_copy_offset)
 	}
 
 	char * old_buffer = m_buffer;
+	int old_buffer_size = m_buffer_size;
 	m_buffer_size = i_size;
 	AFINFA("Msg::allocateBuffer(%s): trying %d bytes ( %d written at %p)", TNAMES[m_type], i_size, m_writtensize, old_buffer)
-	m_buffer = new char[m_buffer_size];
+	m_buffer = MsgBufferPool::Acquire( m_buffer_size);
 	if( m_buffer == NULL )
 	{
 		AFERRAR("Msg::allocateBuffer: can't allocate %d bytes for buffer.", m_buffer_size)
@@ -121,7 +155,7 @@ bool Msg::allocateBuffer( int i_size, int i_copy_len, int i_copy_offset)
 	{
 //printf("Copying old buffer: offset=%d size=%d\n", i_copy_offset, i_copy_len);
 		if( i_copy_len > 0) memcpy( m_data, old_buffer + i_copy_offset, i_copy_len);
-		delete [] old_buffer;
+		MsgBufferPool::Release( old_buffer, old_buffer_size);
 	}
 
 	return true;
@@ -133,8 +167,9 @@ char * Msg::writtenBuffer( int size)
 //printf("Msg::writtenBuffer: size=%d, msgwrittensize=%d, address=%p\n", size, msgwrittensize, mdata + msgwrittensize);
 	if( m_writtensize+size > m_data_maxsize)
 	{
-		int newsize = m_buffer_size << 3;
-		if( m_writtensize+size > newsize) newsize = m_writtensize+size+Msg::SizeHeader;
+		// Pooled buffers sizes are doubled
+		int newsize = m_buffer_size << 1;
+		if( m_writtensize+size+Msg::SizeHeader > newsize) newsize = m_writtensize+size+Msg::SizeHeader;
 		if( allocateBuffer( newsize, m_writtensize) == false ) return NULL;
 	}
 	char * wBuffer = m_data + m_writtensize;
@@ -240,7 +275,7 @@ bool Msg::set( int msgType, Af * afClass)
 	afClass->write( this);
 	if( m_type == Msg::TInvalid)
 	{
-		delete m_buffer;
+		MsgBufferPool::Release( m_buffer, m_buffer_size);
 		m_buffer = NULL;
 		m_type = TNULL;
 		allocateBuffer(100);
@@ -529,8 +564,9 @@ const char * Msg::TNAMES[]=
 	"TJobsWeightRequest",         ///< Request all jobs weight.
 
 
-	"TRESERVED00",
-	"TRESERVED01",
+	"TRenderConnect",             ///< Render asks to keep connection to receive pushed events, contains render id.
+	"TMonitorEventsWait",         ///< Server internal: monitor request waits for events, contains monitor id.
+
 	"TRESERVED02",
 	"TRESERVED03",
 	"TRESERVED04",
@@ -29,6 +29,12 @@ public:
 
 	Msg( const char * rawData, int rawDataLen);
 
+	/// Construct a data message adopting a buffer with already written data.
+	/** Buffer should be acquired from \c MsgBufferPool with \c Msg::SizeHeader bytes reserved
+	*** at its beginning for the header, data of \c i_data_len bytes follows it.
+	*** Message takes buffer ownership. **/
+	Msg( int i_type, char * i_buffer, int i_buffer_size, int i_data_len);
+
 	~Msg();///< Destructor.
 
 	void v_generateInfoStream( std::ostringstream & stream, bool full = false) const;
@@ -96,7 +102,10 @@ public:
 /**/TJobsWeightRequest/**/,         ///< Request all jobs weight.
 
 
-TRESERVED00,TRESERVED01,TRESERVED02,TRESERVED03,TRESERVED04,TRESERVED05,TRESERVED06,TRESERVED07,TRESERVED08,TRESERVED09,
+/**/TRenderConnect/**/,             ///< Render asks to keep connection to receive pushed events, contains render id.
+/**/TMonitorEventsWait/**/,         ///< Server internal: monitor request waits for events, contains monitor id.
+
+TRESERVED02,TRESERVED03,TRESERVED04,TRESERVED05,TRESERVED06,TRESERVED07,TRESERVED08,TRESERVED09,
 
 /*---------------------------------------------------------------------------------------------------------*/
 /*--------------------------------- DATA MESSAGES ---------------------------------------------------------*/
@@ -208,6 +217,14 @@ TLAST
 
 	inline int getHeaderOffset() const { return m_header_offset;}
 
+	/// HTTP request client accepts gzip content encoding.
+	inline void setHTTPAcceptGzip()       { m_http_accept_gzip = true; }
+	inline bool isHTTPAcceptGzip() const  { return m_http_accept_gzip; }
+
+	/// HTTP answer data is gzip encoded.
+	inline void setHTTPGzip()       { m_http_gzip = true; }
+	inline bool isHTTPGzip() const  { return m_http_gzip; }
+
 private:
 
 // header:
@@ -226,6 +243,8 @@ private:
 	int  m_writtensize;              ///< Number of bytes already written in message buffer.
 	int  m_header_offset;            ///< From where begin to write, for exampl to send json to browser
 	                                 ///< we should skip header at all ( m_header_offset = Msg::SizeHeader )
+	bool m_http_accept_gzip;
+	bool m_http_gzip;
 
 // communication parameters:
 	Address m_address;                ///< Address, where message came from or will be send.
@@ -236,7 +255,7 @@ private:
 	bool checkZero( bool outerror ); ///< Check Zero type, data length and pointer.
 	bool checkValidness();           ///< Check message header validness and magic number;
 
-	/// Allocate memory for buffer, copy \c to_copy_len bytes in new buffer if any
+	/// Allocate memory for buffer from pool, copy \c to_copy_len bytes in new buffer if any
 	bool allocateBuffer( int i_size, int i_copy_len = 0, int i_copy_offset = Msg::SizeHeader);
 
 	void rw_header( bool write); ///< Read or write message header.
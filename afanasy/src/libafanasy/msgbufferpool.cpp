@@ -0,0 +1,216 @@
+#include "msgbufferpool.h"
+
+#include <string.h>
+#include <vector>
+
+#include "common/dlMutex.h"
+#include "common/dlScopeLocker.h"
+
+#include "msg.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "logger.h"
+
+using namespace af;
+
+namespace
+{
+// Size classes: 16 KB, 32 KB, ..., 2 MB.
+const int Classes = 8;
+// Maximum free buffers of a class and maximum free bytes of a class.
+const int ClassFreeMax = 64;
+const int ClassFreeBytesMax = 1 << 23;
+
+DlMutex s_mutex;
+std::vector<char*> s_free[Classes];
+
+int64_t s_stat_acquired = 0;
+int64_t s_stat_reused   = 0;
+int64_t s_stat_big      = 0;
+int64_t s_stat_deleted  = 0;
+}
+
+int MsgBufferPool::SizeClass( int i_size)
+{
+	int size = Msg::SizeBuffer;
+	for( int c = 0; c < Classes; c++, size <<= 1)
+		if( i_size <= size )
+			return c;
+	return -1;
+}
+
+char * MsgBufferPool::Acquire( int & io_size)
+{
+	int c = SizeClass( io_size);
+	if( c < 0 )
+	{
+		DlScopeLocker lock( &s_mutex);
+		s_stat_acquired++;
+		s_stat_big++;
+		return new char[io_size];
+	}
+
+	io_size = Msg::SizeBuffer << c;
+
+	{
+		DlScopeLocker lock( &s_mutex);
+		s_stat_acquired++;
+		if( s_free[c].size())
+		{
+			char * buffer = s_free[c].back();
+			s_free[c].pop_back();
+			s_stat_reused++;
+			return buffer;
+		}
+	}
+
+	return new char[io_size];
+}
+
+void MsgBufferPool::Release( char * i_buffer, int i_size)
+{
+	if( NULL == i_buffer )
+		return;
+
+	int c = SizeClass( i_size);
+	if(( c >= 0 ) && ( i_size == ( Msg::SizeBuffer << c )))
+	{
+		DlScopeLocker lock( &s_mutex);
+		if(( int( s_free[c].size()) < ClassFreeMax ) &&
+			( int64_t( s_free[c].size() + 1) * i_size <= ClassFreeBytesMax ))
+		{
+			s_free[c].push_back( i_buffer);
+			return;
+		}
+		s_stat_deleted++;
+	}
+
+	delete [] i_buffer;
+}
+
+void MsgBufferPool::WriteStat( std::ostringstream & o_str)
+{
+	DlScopeLocker lock( &s_mutex);
+
+	int64_t free_count = 0;
+	int64_t free_bytes = 0;
+	for( int c = 0; c < Classes; c++)
+	{
+		free_count += s_free[c].size();
+		free_bytes += int64_t( s_free[c].size()) * ( Msg::SizeBuffer << c );
+	}
+
+	o_str << "\nMessage buffers: acquired " << s_stat_acquired;
+	if( s_stat_acquired )
+		o_str << ", reused " << ( 100 * s_stat_reused / s_stat_acquired ) << "%";
+	o_str << ", big " << s_stat_big;
+	o_str << ", deleted " << s_stat_deleted;
+	o_str << ", pooled " << free_count << " (" << ( free_bytes >> 10 ) << " KB)";
+
+	s_stat_acquired = 0;
+	s_stat_reused   = 0;
+	s_stat_big      = 0;
+	s_stat_deleted  = 0;
+}
+
+MsgStreamBuf::MsgStreamBuf():
+	m_buffer( NULL),
+	m_buffer_size( Msg::SizeBuffer),
+	m_header_size( Msg::SizeHeader)
+{
+	m_buffer = MsgBufferPool::Acquire( m_buffer_size);
+	setp( m_buffer + m_header_size, m_buffer + m_buffer_size);
+}
+
+MsgStreamBuf::~MsgStreamBuf()
+{
+	MsgBufferPool::Release( m_buffer, m_buffer_size);
+}
+
+char * MsgStreamBuf::release( int & o_size)
+{
+	char * buffer = m_buffer;
+	o_size = m_buffer_size;
+
+	m_buffer = NULL;
+	m_buffer_size = 0;
+	setp( NULL, NULL);
+
+	return buffer;
+}
+
+bool MsgStreamBuf::grow( int i_size)
+{
+	if( NULL == m_buffer )
+		return false;
+
+	int written = int( pptr() - m_buffer);
+	int size = m_buffer_size << 1;
+	if( size < written + i_size )
+		size = written + i_size;
+
+	if( size > Msg::SizeBufferLimit )
+	{
+		AF_ERR << "Message stream size limit reached: " << size << " > " << Msg::SizeBufferLimit;
+		return false;
+	}
+
+	char * buffer = MsgBufferPool::Acquire( size);
+	memcpy( buffer, m_buffer, written);
+	MsgBufferPool::Release( m_buffer, m_buffer_size);
+
+	m_buffer = buffer;
+	m_buffer_size = size;
+	setp( m_buffer + written, m_buffer + m_buffer_size);
+
+	return true;
+}
+
+MsgStreamBuf::int_type MsgStreamBuf::overflow( int_type i_c)
+{
+	if( traits_type::eq_int_type( i_c, traits_type::eof()))
+		return traits_type::not_eof( i_c);
+
+	if(( pptr() == epptr()) && ( false == grow(1)))
+		return traits_type::eof();
+
+	*pptr() = traits_type::to_char_type( i_c);
+	pbump(1);
+
+	return i_c;
+}
+
+std::streamsize MsgStreamBuf::xsputn( const char * i_s, std::streamsize i_n)
+{
+	if(( epptr() - pptr() < i_n ) && ( false == grow( int( i_n))))
+		return 0;
+
+	memcpy( pptr(), i_s, i_n);
+	pbump( int( i_n));
+
+	return i_n;
+}
+
+MsgStream::MsgStream()
+{
+	std::ios::rdbuf( &m_buf);
+}
+
+MsgStream::~MsgStream()
+{
+}
+
+Msg * MsgStream::toMsg( int i_type)
+{
+	int size = m_buf.size();
+	if( size <= 0 )
+		return new Msg( Msg::TInvalid);
+
+	int buffer_size;
+	char * buffer = m_buf.release( buffer_size);
+	setstate( std::ios::badbit);
+
+	return new Msg( i_type, buffer, buffer_size, size);
+}
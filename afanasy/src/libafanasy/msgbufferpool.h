@@ -0,0 +1,77 @@
+#pragma once
+
+#include <sstream>
+#include <stdint.h>
+
+namespace af
+{
+/// Messages buffers pool.
+/** Buffers are allocated by size classes: Msg::SizeBuffer and its doubles up to a limit.
+*** Released buffers are kept in per class free lists and are given to next messages.
+*** Bigger buffers are allocated and deleted directly.
+**/
+class MsgBufferPool
+{
+public:
+	/// Get a buffer of at least \c io_size bytes, \c io_size is set to the real buffer size.
+	static char * Acquire( int & io_size);
+
+	/// Give buffer back to pool, \c i_size must be the size returned by \c Acquire.
+	static void Release( char * i_buffer, int i_size);
+
+	/// Write pool statistics since the previous call.
+	static void WriteStat( std::ostringstream & o_str);
+
+private:
+	static int SizeClass( int i_size);
+};
+
+/// Stream to construct message data directly in a pooled buffer.
+/** Message header place is reserved at the buffer beginning,
+*** so a message adopts written buffer with no data copy.
+*** It is an \c std::ostringstream to be passed to all JSON writing functions,
+*** but \c str() of base class is empty, use \c size() to get written size.
+**/
+class MsgStreamBuf : public std::streambuf
+{
+public:
+	MsgStreamBuf();
+	~MsgStreamBuf();
+
+	/// Written data size.
+	inline int size() const { return int( pptr() - m_buffer) - m_header_size; }
+
+	/// Release buffer ownership, \c o_size is set to the whole buffer size.
+	char * release( int & o_size);
+
+protected:
+	virtual int_type overflow( int_type i_c);
+	virtual std::streamsize xsputn( const char * i_s, std::streamsize i_n);
+
+private:
+	bool grow( int i_size);
+
+private:
+	char * m_buffer;
+	int m_buffer_size;
+	int m_header_size;
+};
+
+class Msg;
+
+class MsgStream : public std::ostringstream
+{
+public:
+	MsgStream();
+	~MsgStream();
+
+	inline int size() const { return m_buf.size(); }
+
+	/// Construct a message of \c i_type from written data.
+	/// Stream should not be used after it.
+	Msg * toMsg( int i_type);
+
+private:
+	MsgStreamBuf m_buf;
+};
+}
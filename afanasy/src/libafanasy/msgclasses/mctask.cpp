@@ -1,5 +1,6 @@
 #include "mctask.h"
 
+#include "../msgbufferpool.h"
 #include "../taskexec.h"
 
 #define AFOUTPUT
@@ -154,23 +155,14 @@ const std::string & MCTask::getListened() const
 //
 Msg * MCTask::generateMessage( bool i_binary)
 {
-	Msg * msg = new Msg();
-
 	if( i_binary )
-	{
-		msg->set( Msg::TTask, this);
-	}
-	else
-	{
-		std::ostringstream str;
-		str << "{\"task\":";
-		jsonWrite( str);
-		str << "}";
-		std::string text = str.str();
-		msg->setData( text.size(), text.c_str(), af::Msg::TJSON);
-	}
+		return new Msg( Msg::TTask, this);
 
-	return msg;
+	MsgStream str;
+	str << "{\"task\":";
+	jsonWrite( str);
+	str << "}";
+	return str.toMsg( af::Msg::TJSON);
 }
 
 void MCTask::v_readwrite( Msg * io_msg)
@@ -8,23 +8,21 @@ using namespace af;
 
 MCTasksProgress::MCTasksProgress( int JobId):
    clientside( false),
-   jobid( JobId)
+   jobid( JobId),
+   columns( NULL)
 {
 }
 
 MCTasksProgress::MCTasksProgress( Msg * msg):
-   clientside( true)
+   clientside( true),
+   columns( NULL)
 {
    read( msg);
 }
 
 MCTasksProgress::~MCTasksProgress()
 {
-   if( clientside)
-   {
-      std::list<TaskProgress*>::iterator trIt = tasksprogress.begin();
-      while( trIt != tasksprogress.end()) delete *(trIt++);
-   }
+   if( columns ) delete columns;
 }
 
 void MCTasksProgress::v_readwrite( Msg * msg)
@@ -35,7 +33,7 @@ void MCTasksProgress::v_readwrite( Msg * msg)
 
    if( msg->isWriting())
    {
-      std::list<TaskProgress*>::iterator trIt = tasksprogress.begin();
+      std::list<TaskProgressView>::iterator trIt = tasksprogress.begin();
       while( trIt != tasksprogress.end())
       {
          (*trIt)->v_readwrite( msg);
@@ -45,12 +43,16 @@ void MCTasksProgress::v_readwrite( Msg * msg)
    else
    {
       int count = int(tasks.size());
+      columns = new TaskProgressColumns( count);
       for( int i = 0; i < count; i++)
-         tasksprogress.push_back( new TaskProgress( msg));
+      {
+         tasksprogress.push_back( TaskProgressView( columns, i));
+         tasksprogress.back()->v_readwrite( msg);
+      }
    }
 }
 
-void MCTasksProgress::add( int block, int task, TaskProgress * tp)
+void MCTasksProgress::add( int block, int task, const TaskProgressView & tp)
 {
    int count = int( tasks.size());
 
@@ -71,7 +73,7 @@ void MCTasksProgress::v_generateInfoStream( std::ostringstream & stream, bool fu
    std::list<int32_t>::const_iterator bIt = blocks.begin();
    std::list<int32_t>::const_iterator tIt =  tasks.begin();
 
-   std::list<TaskProgress*>::const_iterator trIt = tasksprogress.begin();
+   std::list<TaskProgressView>::const_iterator trIt = tasksprogress.begin();
 
    stream << "Job id = " << jobid;
    for( int i = 0; i < count; i++)
@@ -16,14 +16,14 @@ public:
 
    void v_generateInfoStream( std::ostringstream & stream, bool full = false) const;
 
-   void add( int block, int task, TaskProgress * tp);
+   void add( int block, int task, const TaskProgressView & tp);
 
    inline int getJobId() const { return jobid;      }
    inline size_t getCount() const { return tasks.size();}
 
    inline const std::list<int32_t> * getBlocks() const { return &blocks; }
    inline const std::list<int32_t> * getTasks()  const { return &tasks;  }
-   inline std::list<TaskProgress*> * getTasksRun() { return &tasksprogress; }
+   inline const std::list<TaskProgressView> * getTasksRun() const { return &tasksprogress; }
 
 private:
    bool clientside;
@@ -32,7 +32,10 @@ private:
    std::list<int32_t> blocks;
    std::list<int32_t> tasks;
 
-   std::list<TaskProgress*> tasksprogress;
+   std::list<TaskProgressView> tasksprogress;
+
+   /// Client side storage of read tasks progress.
+   TaskProgressColumns * columns;
 
 private:
    void v_readwrite( Msg * msg);
@@ -20,6 +20,8 @@
 #else
 #include <arpa/inet.h>
 #include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 extern char **environ;
 #endif
@@ -216,6 +218,39 @@ void af::sleep_msec( int i_mseconds)
 #endif
 }
 
+int64_t af::getMonotonicMSec()
+{
+#ifdef WINNT
+	return GetTickCount64();
+#elif defined(MACOSX)
+	struct timeval tv;
+	gettimeofday( &tv, NULL);
+	return int64_t(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+#else
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+int64_t af::getMonotonicUSec()
+{
+#ifdef WINNT
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter( &counter);
+	QueryPerformanceFrequency( &frequency);
+	return int64_t( counter.QuadPart * 1000000 / frequency.QuadPart);
+#elif defined(MACOSX)
+	struct timeval tv;
+	gettimeofday( &tv, NULL);
+	return int64_t(tv.tv_sec) * 1000000 + tv.tv_usec;
+#else
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
 void af::printTime( time_t time_sec, const char * time_format)
 {
    std::cout << time2str( time_sec, time_format);
@@ -57,6 +57,7 @@ namespace af
 	class Msg;
 	class MsgQueue;
 	class MsgStat;
+	class MsgStream;
 
 	class Environment;
 
@@ -103,6 +104,7 @@ namespace af
 	class TaskData;
 	class TaskExec;
 	class TaskProgress;
+	class TaskProgressView;
 	class JobProgress;
 
 	enum VerboseMode
@@ -129,6 +131,12 @@ namespace af
 	void sleep_sec(  int i_seconds  );
 	void sleep_msec( int i_mseconds );
 
+	/// Milliseconds from some unspecified point, not affected by system time changes.
+	int64_t getMonotonicMSec();
+
+	/// Microseconds from some unspecified point, not affected by system time changes.
+	int64_t getMonotonicUSec();
+
 
 	// String functions:
 	long long stoi( const std::string & str, bool * ok = NULL);
@@ -252,6 +260,13 @@ namespace af
 	// Read message header from message buffer;
 	int processHeader( af::Msg * io_msg, int i_bytes);
 
+	/// Return HTTP request header size (with empty line), or 0 if header end is not found.
+	int httpHeaderSize( const char * i_data, int i_bytes);
+
+	/// Whether HTTP request asks to keep connection alive.
+	/// HTTP/1.1 connections are persistent by default, unless "Connection: close" is specified.
+	bool httpKeepAlive( const char * i_header, int i_size);
+
 	void setSocketOptions( int i_fd);
 
 	/// Recieve message from given file discriptor \c desc to \c buffer
@@ -262,12 +277,20 @@ namespace af
 	/** Return true if success.**/
 	bool msgwrite( int i_desc, const af::Msg * i_msg);
 
-	std::string msgMakeWriteHeader( const af::Msg * i_msg);
-	std::string getHttpHeader(int file_size, const std::string &mimeType, const std::string &status);
+	std::string msgMakeWriteHeader( const af::Msg * i_msg, bool i_keep_alive = false);
+	std::string getHttpHeader(int file_size, const std::string &mimeType, const std::string &status, bool i_keep_alive = false, bool i_gzip = false);
 
 	/// Send a message to all its addresses and receive an answer if needed
 	Msg * sendToServer( Msg * i_msg, bool & o_ok, VerboseMode i_verbose);
 
+	/// Connect to server to keep connection. Return socket descriptor or -1 on any error.
+	int connectToServer( VerboseMode i_verbose);
+
+	void socketClose( int i_sfd);
+
+	/// Wait socket to have data to read. Return false on timeout or error.
+	bool socketWaitRead( int i_sfd, int i_msec);
+
 	// Read/Write binary data
 	void rw_bool     ( bool     & boolean,  Msg * msg);
 	void rw_int8_t   ( int8_t   & integer,  Msg * msg);
@@ -337,6 +360,7 @@ namespace af
 
 	af::Msg * jsonMsg( const std::string & i_str);
 	af::Msg * jsonMsg( const std::ostringstream & i_stream);
+	af::Msg * jsonMsg( af::MsgStream & i_stream);
 	af::Msg * jsonMsg( const std::string & i_type, const std::string & i_name, const std::list<std::string> & i_list);
 	af::Msg * jsonMsg( const std::string & i_type, const std::string & i_name, const std::string & i_string);
 	af::Msg * jsonMsg( const std::string & i_type, const std::string & i_name, char * i_data, int i_size);
@@ -3,6 +3,7 @@
 
 #include "environment.h"
 #include "msg.h"
+#include "msgbufferpool.h"
 #include "pool.h"
 #include "regexp.h"
 #include "render.h"
@@ -113,6 +114,11 @@ af::Msg * af::jsonMsg( const std::ostringstream & i_stream)
 	return af::jsonMsg( i_stream.str());
 }
 
+af::Msg * af::jsonMsg( af::MsgStream & i_stream)
+{
+	return i_stream.toMsg( af::Msg::TJSON);
+}
+
 af::Msg * af::jsonMsg( const std::string & i_type, const std::string & i_name, char * i_data, int i_size)
 {
 	return af::jsonMsg( i_type, i_name, std::string( i_data, i_size));
@@ -7,7 +7,9 @@
 #include <netinet/tcp.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/select.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #define closesocket close
 #else
 #define strncasecmp _strnicmp
@@ -61,9 +63,9 @@ bool writedata( int fd, const char * data, int len)
 	while( written_bytes < len)
 	{
 #ifdef WINNT
-		int w = send( fd, data+written_bytes, len, 0);
+		int w = send( fd, data+written_bytes, len-written_bytes, 0);
 #else
-		int w = write( fd, data+written_bytes, len);
+		int w = write( fd, data+written_bytes, len-written_bytes);
 #endif
 		if( w < 0)
 		{
@@ -108,6 +110,16 @@ int af::processHeader( af::Msg * io_msg, int i_bytes)
 					break;
 				}
 
+				// Client can accept compressed answer:
+				if( strncasecmp("Accept-Encoding:", buffer+offset, 16) == 0)
+				{
+					int end = offset + 16;
+					while(( end < i_bytes ) && ( buffer[end] != '\n' ))
+						end++;
+					if( std::string( buffer + offset + 16, end - offset - 16).find("gzip") != std::string::npos )
+						io_msg->setHTTPAcceptGzip();
+				}
+
 				// Look for a special header:
 				if( strncasecmp("AFANASY: ", buffer+offset, 9) == 0)
 				{
@@ -201,35 +213,65 @@ int af::processHeader( af::Msg * io_msg, int i_bytes)
 	return af::Msg::SizeHeader;
 }
 
-af::Msg * msgsendtoaddress( const af::Msg * i_msg, const af::Address & i_address,
-						    bool & o_ok, af::VerboseMode i_verbose)
+int af::httpHeaderSize( const char * i_data, int i_bytes)
 {
-	if( af::Environment::isServer())
+	for( int i = 3; i < i_bytes; i++)
+		if(( i_data[i] == '\n' ) && ( i_data[i-1] == '\r' ) && ( i_data[i-2] == '\n' ) && ( i_data[i-3] == '\r' ))
+			return i + 1;
+
+	return 0;
+}
+
+bool af::httpKeepAlive( const char * i_header, int i_size)
+{
+	// Request line, like "GET /index.html HTTP/1.1":
+	int line_end = 0;
+	while(( line_end < i_size ) && ( i_header[line_end] != '\n' ))
+		line_end++;
+
+	bool keep_alive = ( line_end > 9 ) && ( strncmp( i_header + line_end - 9, "HTTP/1.1", 8) == 0 );
+
+	static const char connection[] = "Connection:";
+	static const int connection_len = strlen( connection);
+
+	for( int offset = line_end + 1; offset + connection_len < i_size; offset++)
 	{
-		AFERROR("msgsendtoaddress: Server should not connect and send messages itself.\n")
-		o_ok = false;
-		return NULL;
+		if(( i_header[offset-1] != '\n' ) || ( strncasecmp( i_header + offset, connection, connection_len) != 0 ))
+			continue;
+
+		int end = offset + connection_len;
+		while(( end < i_size ) && ( i_header[end] != '\n' ))
+			end++;
+		std::string value( i_header + offset + connection_len, end - offset - connection_len);
+		std::transform( value.begin(), value.end(), value.begin(), ::tolower);
+
+		if( value.find("close") != std::string::npos )
+			return false;
+		if( value.find("keep-alive") != std::string::npos )
+			return true;
 	}
 
-	o_ok = true;
+	return keep_alive;
+}
 
+/// Connect to address. Return socket descriptor or -1 on any error.
+int connecttoaddress( const af::Address & i_address, const char * i_what, af::VerboseMode i_verbose)
+{
 	if( i_address.isEmpty() )
 	{
-		AFERROR("msgsendtoaddress: Address is empty.")
-		o_ok = false;
-		return NULL;
+		AFERROR("connecttoaddress: Address is empty.")
+		return -1;
 	}
 
 	int socketfd;
 	struct sockaddr_storage client_addr;
 
-	if( false == i_address.setSocketAddress( &client_addr)) return NULL;
+	if( false == i_address.setSocketAddress( &client_addr)) return -1;
 
 	if(( socketfd = socket( client_addr.ss_family, SOCK_STREAM, 0)) < 0 )
 	{
-		AFERRPE("msgsendtoaddress: socket() call failed")
-		o_ok = false;
-		return NULL;
+		AFERRPE("connecttoaddress: socket() call failed")
+		return -1;
 	}
 
 
@@ -239,15 +281,36 @@ af::Msg * msgsendtoaddress( const af::Msg * i_msg, const af::Address & i_address
 
 	//
 	// connect to address
-	AFINFO("msgsendtoaddress: tying to connect to client.")
+	AFINFO("connecttoaddress: tying to connect to client.")
 	if( connect(socketfd, (struct sockaddr*)&client_addr, i_address.sizeofAddr()) != 0 )
 	{
 		if( i_verbose == af::VerboseOn )
 		{
-			AFERRPA("msgsendtoaddress: connect failure for msgType '%s':\n%s: ",
-				af::Msg::TNAMES[i_msg->type()], i_address.v_generateInfoString().c_str())
+			AFERRPA("connecttoaddress: connect failure for '%s':\n%s: ",
+				i_what, i_address.v_generateInfoString().c_str())
 		}
 		closesocket(socketfd);
+		return -1;
+	}
+
+	return socketfd;
+}
+
+af::Msg * msgsendtoaddress( const af::Msg * i_msg, const af::Address & i_address,
+						    bool & o_ok, af::VerboseMode i_verbose)
+{
+	if( af::Environment::isServer())
+	{
+		AFERROR("msgsendtoaddress: Server should not connect and send messages itself.\n")
+		o_ok = false;
+		return NULL;
+	}
+
+	o_ok = true;
+
+	int socketfd = connecttoaddress( i_address, af::Msg::TNAMES[i_msg->type()], i_verbose);
+	if( socketfd < 0 )
+	{
 		o_ok = false;
 		return NULL;
 	}
@@ -520,13 +583,13 @@ AFINFO("af::msgread:\n");
 	return true;
 }
 
-std::string af::msgMakeWriteHeader( const af::Msg * i_msg)
+std::string af::msgMakeWriteHeader( const af::Msg * i_msg, bool i_keep_alive)
 {
 	int size = i_msg->writeSize() - i_msg->getHeaderOffset();
 	std::string header;
 	if( i_msg->type() == af::Msg::THTTP )
 	{
-		header = af::getHttpHeader(size, "application/json", "200 OK");
+		header = af::getHttpHeader(size, "application/json", "200 OK", i_keep_alive, i_msg->isHTTPGzip());
 	}
 	else if( i_msg->type() == af::Msg::TJSON )
 	{
@@ -535,16 +598,21 @@ std::string af::msgMakeWriteHeader( const af::Msg * i_msg)
 	return header;
 }
 
-std::string af::getHttpHeader(int file_size, const std::string &mimeType, const std::string &status)
+std::string af::getHttpHeader(int file_size, const std::string &mimeType, const std::string &status, bool i_keep_alive, bool i_gzip)
 {
 	int maxAge = 0;
 	if (mimeType == "text/css" || mimeType == "text/javascript" || mimeType.find("image/") != -1)
 		maxAge = 60 * 60; // enable caching for all static resources (css, js, images)
 
+	std::string connection = "Connection: close";  // instruct browser to close the connection after receiving data
+	if (i_keep_alive)
+		connection = "Connection: keep-alive\r\nKeep-Alive: timeout=" + af::itos(af::Environment::getServerHTTPKeepAliveSec());
+
 	return "HTTP/1.1 " + status + "\r\n"  // set the http status code
-			 + "Connection: close" + "\r\n"   // instruct browser to close the connection after receiving data
+			 + connection + "\r\n"
 			 + "Content-Length: " + af::itos(file_size) + "\r\n"         // tell how long the content is
 			 + "Content-Type: " + mimeType + "\r\n"                            // set the mime type of the result
+			 + (i_gzip ? "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n" : "") // compressed content
 			 + "Cache-Control: max-age=" + af::itos(maxAge) + "\r\n"     // optional browser caching
 			 + "Server: afanasy/" + af::Environment::getVersionCGRU() + "\r\n" // identify server
 			 + "\r\n";
@@ -553,12 +621,42 @@ std::string af::getHttpHeader(int file_size, const std::string &mimeType, const
 bool af::msgwrite( int i_desc, const af::Msg * i_msg)
 {
 	std::string header = af::msgMakeWriteHeader( i_msg);
-	if( NULL != header.c_str() )
+
+	const char * data = i_msg->buffer() + i_msg->getHeaderOffset();
+	int data_len = i_msg->writeSize() - i_msg->getHeaderOffset();
+
+#ifndef WINNT
+	// Write header and data with no copy by a gather write:
+	if( header.size())
 	{
-		::writedata( i_desc, header.c_str(), header.size());
+		int header_len = header.size();
+		int written = 0;
+		while( written < header_len )
+		{
+			struct iovec iov[2];
+			iov[0].iov_base = const_cast<char*>( header.data()) + written;
+			iov[0].iov_len  = header_len - written;
+			iov[1].iov_base = const_cast<char*>( data);
+			iov[1].iov_len  = data_len;
+			int w = writev( i_desc, iov, 2);
+			if( w < 0 )
+			{
+				AFERRPE("af::msgwrite: writev:");
+				return false;
+			}
+			written += w;
+		}
+		// Some data can be already written with header:
+		data     += written - header_len;
+		data_len -= written - header_len;
+		header.clear();
 	}
+#else
+	if( header.size())
+		::writedata( i_desc, header.c_str(), header.size());
+#endif
 
-	if( false == ::writedata( i_desc, i_msg->buffer() + i_msg->getHeaderOffset(), i_msg->writeSize() - i_msg->getHeaderOffset() ))
+	if(( data_len > 0 ) && ( false == ::writedata( i_desc, data, data_len)))
 	{
 		AFERROR("af::msgwrite: Error writing message.")
 		return false;
@@ -574,6 +672,35 @@ af::Msg * af::sendToServer( Msg * i_msg, bool & o_ok, VerboseMode i_verbose )
 	return ::msgsendtoaddress( i_msg, af::Environment::getServerAddress(), o_ok, i_verbose);
 }
 
+int af::connectToServer( VerboseMode i_verbose)
+{
+	if( af::Environment::isServer())
+	{
+		AFERROR("af::connectToServer: Server should not connect itself.")
+		return -1;
+	}
+
+	return ::connecttoaddress( af::Environment::getServerAddress(), "server", i_verbose);
+}
+
+void af::socketClose( int i_sfd)
+{
+	closesocket( i_sfd);
+}
+
+bool af::socketWaitRead( int i_sfd, int i_msec)
+{
+	fd_set rfds;
+	FD_ZERO( &rfds);
+	FD_SET( i_sfd, &rfds);
+
+	timeval tv;
+	tv.tv_sec  = i_msec / 1000;
+	tv.tv_usec = ( i_msec % 1000 ) * 1000;
+
+	return select( i_sfd + 1, &rfds, NULL, NULL, &tv) > 0;
+}
+
 af::Msg * af::msgString( const std::string & i_str)
 {
 	af::Msg * o_msg = new af::Msg();
@@ -27,6 +27,10 @@ RenderEvents::RenderEvents( Msg * msg)
 
 RenderEvents::RenderEvents(RE_Status i_status, const std::string & i_log):
 	m_id(i_status),
+	m_heartbeat_sec(0),
+	m_resources_update_period(0),
+	m_zombie_time(0),
+	m_exit_no_task_time(0),
 	m_log(i_log)
 {
 }
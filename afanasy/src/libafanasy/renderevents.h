@@ -19,7 +19,8 @@ public:
 	enum RE_Status
 	{
 		RE_Status_Reconnect = -1,
-		RE_Status_Exit      = -2
+		RE_Status_Exit      = -2,
+		RE_Status_Retry     = -3  ///< Server is busy, render should retry after \c m_heartbeat_sec.
 	};
 	// On error, server constructs a log message with a special status ID
 	RenderEvents(RE_Status i_status, const std::string & i_log);
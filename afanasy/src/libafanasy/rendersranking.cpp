@@ -0,0 +1,86 @@
+#include "rendersranking.h"
+
+#include <algorithm>
+
+#include "render.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+
+using namespace af;
+
+namespace
+{
+// Functor for heap algorithm, heap top is the most ready render.
+struct LessReadyRender
+{
+	inline bool operator()( const RendersRanking::Rank & i_a, const RendersRanking::Rank & i_b) const
+	{
+		return RendersRanking::LessReady( i_a, i_b);
+	}
+};
+}
+
+RendersRanking::RendersRanking():
+	m_count( 0)
+{
+}
+
+void RendersRanking::reset( int i_count)
+{
+	m_ranks.clear();
+	m_ranks.reserve( i_count);
+	m_count = 0;
+}
+
+bool RendersRanking::LessReady( const Rank & i_a, const Rank & i_b)
+{
+	const Key & a = i_b.key;
+	const Key & b = i_a.key;
+
+	// Offline renders needed for Wake-On-Lan.
+	// Offline render is less ready.
+	if( a.online && ( false == b.online)) return true;
+	if(( false == a.online) && b.online) return false;
+
+	if( a.pool_priority > b.pool_priority) return true;
+	if( a.pool_priority < b.pool_priority) return false;
+
+	if( a.tasks_num < b.tasks_num) return true;
+	if( a.tasks_num > b.tasks_num) return false;
+
+	if( a.capacity_free > b.capacity_free) return true;
+	if( a.capacity_free < b.capacity_free) return false;
+
+	if( a.priority > b.priority) return true;
+	if( a.priority < b.priority) return false;
+
+	if( a.tasks_start_finish_time < b.tasks_start_finish_time) return true;
+	if( a.tasks_start_finish_time > b.tasks_start_finish_time) return false;
+
+	if( a.capacity > b.capacity) return true;
+	if( a.capacity < b.capacity) return false;
+
+	if( a.max_tasks > b.max_tasks) return true;
+	if( a.max_tasks < b.max_tasks) return false;
+
+	return i_b.render->getName().compare( i_a.render->getName()) < 0;
+}
+
+void RendersRanking::rank()
+{
+	m_count = int( m_ranks.size());
+	std::make_heap( m_ranks.begin(), m_ranks.end(), LessReadyRender());
+}
+
+Render * RendersRanking::next()
+{
+	if( m_count <= 0 )
+		return NULL;
+
+	std::pop_heap( m_ranks.begin(), m_ranks.begin() + m_count, LessReadyRender());
+	m_count--;
+
+	return m_ranks[m_count].render;
+}
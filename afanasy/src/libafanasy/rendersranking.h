@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+namespace af
+{
+class Render;
+
+/// Gives renders one by one, from the most ready to the less ready one.
+/** Renders are not sorted entirely, as a job usually takes the first one,
+*** the next render is selected from a heap only when it is asked.
+*** Renders are compared by keys, that are stored by server on each render change,
+*** so render parameters are not calculated on each comparison.
+**/
+class RendersRanking
+{
+public:
+	/// Render parameters to choose the most ready render to solve a task on.
+	struct Key
+	{
+		bool online;
+		int pool_priority;
+		int tasks_num;
+		int capacity_free;
+		int priority;
+		long long tasks_start_finish_time;
+		int capacity;
+		int max_tasks;
+	};
+
+	struct Rank
+	{
+		Key key;
+		Render * render;
+	};
+
+	RendersRanking();
+
+	/// Remove all renders and reserve place for \c i_count renders.
+	void reset( int i_count);
+
+	inline void add( const Key & i_key, Render * i_render)
+	{
+		m_ranks.push_back( Rank());
+		m_ranks.back().key = i_key;
+		m_ranks.back().render = i_render;
+	}
+
+	/// Should be called after all renders are added, before getting them.
+	void rank();
+
+	/// Returns NULL when there are no more renders.
+	Render * next();
+
+	/// Whether render \c i_a is less ready than \c i_b (ranked after it).
+	static bool LessReady( const Rank & i_a, const Rank & i_b);
+
+private:
+	std::vector<Rank> m_ranks;
+	int m_count;
+};
+}
@@ -14,11 +14,13 @@ using namespace af;
 RenderUpdate::RenderUpdate():
 	m_hres( NULL),
 	m_has_hres( false),
+	m_hres_bytes( 0),
 	m_server_side( false)
 {
 }
 
 RenderUpdate::RenderUpdate( Msg * msg):
+	m_hres_bytes( 0),
 	m_server_side( true)
 {
 	read( msg);
@@ -93,14 +95,19 @@ void RenderUpdate::v_readwrite( Msg * msg)
 	}
 
 
-	// Resources:
+	// Resources, only changed fields:
 	rw_bool( m_has_hres, msg);
 	if( m_has_hres )
 	{
 		if( msg->isReading())
-			m_hres = new HostRes( msg);
+		{
+			int pos = msg->getWrittenSize();
+			m_hres = new HostRes();
+			m_hres->readwriteDelta( msg);
+			m_hres_bytes = msg->getWrittenSize() - pos;
+		}
 		else
-			m_hres->v_readwrite( msg);
+			m_hres->readwriteDelta( msg);
 	}
 }
 
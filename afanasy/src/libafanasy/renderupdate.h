@@ -31,6 +31,9 @@ public:
 	inline bool hasResources() const { return m_has_hres; }
 	inline const HostRes * getResources() const { return m_hres; }
 
+	/// Resources size in a received message, resources are sent in delta mode.
+	inline int getResourcesBytes() const { return m_hres_bytes; }
+
 	void v_generateInfoStream( std::ostringstream & stream, bool full = false) const;
 
 public:
@@ -48,6 +51,7 @@ private:
 
 	bool m_has_hres;
 	HostRes * m_hres;
+	int32_t m_hres_bytes;
 
 	bool m_server_side;
 
@@ -74,7 +74,7 @@ void TaskExec::initDefaults()
 	m_flags = 0;
 	m_number = 0;
 	m_capacity_coeff = 0;
-	m_progress = NULL;
+	m_progress = TaskProgressView();
 }
 
 TaskExec::~TaskExec()
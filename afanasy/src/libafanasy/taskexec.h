@@ -182,8 +182,8 @@ public:
 	void jsonWrite( std::ostringstream & o_str, int i_type) const;
 
 	/// Needed for af::Render to write running tasks percents:
-	inline void setProgress( const TaskProgress * i_progress ) { m_progress = i_progress; }
-	inline int getPercent() const { if( m_progress ) return m_progress->percent; else return -1; }
+	inline void setProgress( const TaskProgressView & i_progress ) { m_progress = i_progress; }
+	inline int getPercent() const { if( false == m_progress.isNull()) return m_progress->percent; else return -1; }
 
 
 	/// Read or write task in message buffer.
@@ -246,6 +246,6 @@ private:
 
 private:
 	/// Needed for af::Render to write running tasks percents:
-	const TaskProgress * m_progress;
+	TaskProgressView m_progress;
 };
 }
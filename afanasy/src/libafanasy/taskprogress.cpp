@@ -6,6 +6,94 @@
 
 using namespace af;
 
+namespace
+{
+// Task progress values and view fields have the same names,
+// so they are read and written by the same code.
+
+inline const std::string & tp_str( const std::string & i_str) { return i_str; }
+
+inline void tp_rwString( std::string & io_str, Msg * msg) { rw_String( io_str, msg); }
+void tp_rwString( TaskProgressString & io_str, Msg * msg)
+{
+	std::string str = io_str;
+	rw_String( str, msg);
+	if( msg->isReading())
+		io_str = str;
+}
+
+inline void tp_jrString( const char * i_name, std::string & o_str, const JSON & i_obj) { jr_string( i_name, o_str, i_obj); }
+void tp_jrString( const char * i_name, TaskProgressString & o_str, const JSON & i_obj)
+{
+	std::string str;
+	if( jr_string( i_name, str, i_obj))
+		o_str = str;
+}
+
+template <typename P> void tp_readwrite( P & p, Msg * msg)
+{
+	rw_int64_t( p.state,        msg);
+	rw_int8_t ( p.percent,      msg);
+	rw_int64_t( p.frame,        msg);
+	rw_int8_t ( p.percentframe, msg);
+	rw_int32_t( p.starts_count, msg);
+	rw_int32_t( p.errors_count, msg);
+	rw_int64_t( p.time_start,   msg);
+	rw_int64_t( p.time_done,    msg);
+
+	tp_rwString( p.hostname,  msg);
+	tp_rwString( p.activity,  msg);
+	tp_rwString( p.resources, msg);
+}
+
+template <typename P> void tp_jsonRead( P & p, const JSON & i_obj)
+{
+	jr_int64 ("st",  p.state,        i_obj);
+	jr_int32 ("str", p.starts_count, i_obj);
+	jr_int32 ("err", p.errors_count, i_obj);
+	jr_int64 ("tst", p.time_start,   i_obj);
+	jr_int64 ("tdn", p.time_done,    i_obj);
+	tp_jrString("hst", p.hostname,  i_obj);
+	tp_jrString("res", p.resources, i_obj);
+}
+
+template <typename P> void tp_jsonWrite( const P & p, std::ostringstream & o_str)
+{
+	o_str << "{";
+	jw_stateJob(p.state, o_str);
+	o_str << ",\"st\":" << p.state;
+	if (p.percent      > 0) o_str << ",\"per\":" << int(p.percent);
+	if (p.frame        > 0) o_str << ",\"frm\":" << p.frame;
+	if (p.percentframe > 0) o_str << ",\"pfr\":" << int(p.percentframe);
+	if (p.starts_count > 0) o_str << ",\"str\":" << p.starts_count;
+	if (p.errors_count > 0) o_str << ",\"err\":" << p.errors_count;
+	if (p.time_start   > 0) o_str << ",\"tst\":" << p.time_start;
+	if (p.time_done    > 0) o_str << ",\"tdn\":" << p.time_done;
+	if (p.hostname.size() ) o_str << ",\"hst\":\"" << tp_str( p.hostname)  << "\"";
+	if (p.activity.size() ) o_str << ",\"act\":\"" << tp_str( p.activity)  << "\"";
+	if (p.resources.size()) o_str << ",\"res\":\"" << tp_str( p.resources) << "\"";
+//	int no_progress_for = last_progress_change - time(NULL);
+//	if (no_progress_for > 0) o_str << ",\"npf\":" << no_progress_for;
+	o_str << "}";
+}
+
+template <typename P> void tp_generateInfoStream( const P & p, std::ostringstream & stream)
+{
+   static const char time_format[] = "%H:%M.%S";
+   stream << "s" << p.state;
+   stream << " p" << int(p.percent) << "%";
+   stream << " (" << p.frame << "-" << int(p.percentframe) << "%)";
+   stream << "s" << p.starts_count << "/" << p.starts_count << "e";
+   stream << " (" << af::time2str( p.time_start, time_format);
+   stream << "-" << af::time2str( p.time_done, time_format);
+   stream << "=" << af::time2str( p.time_done - p.time_start, time_format) << ")";
+//	int no_progress_for = last_progress_change - time(NULL);
+//	if( no_progress_for > 0 ) stream << " npf" << no_progress_for;
+   if( false == p.hostname.empty()) stream << " - " << tp_str( p.hostname);
+}
+}
+
+
 TaskProgress::TaskProgress():
    state(0),
    percent(0),
@@ -14,11 +102,13 @@ TaskProgress::TaskProgress():
    starts_count(0),
    errors_count(0),
    time_start(0),
-   time_done(0)
+   time_done(0),
+   solve_epoch(0)
 {
 }
 
-TaskProgress::TaskProgress( Msg * msg)
+TaskProgress::TaskProgress( Msg * msg):
+   solve_epoch(0)
 {
    read( msg);
 }
@@ -29,48 +119,17 @@ TaskProgress::~TaskProgress()
 
 void TaskProgress::v_readwrite( Msg * msg)
 {
-	rw_int64_t( state,        msg);
-   rw_int8_t  ( percent,      msg);
-   rw_int64_t ( frame,        msg);
-   rw_int8_t  ( percentframe, msg);
-   rw_int32_t ( starts_count, msg);
-   rw_int32_t ( errors_count, msg);
-   rw_int64_t ( time_start,   msg);
-   rw_int64_t ( time_done,    msg);
-   rw_String  ( hostname,     msg);
-	rw_String ( activity,     msg);
-	rw_String ( resources,      msg);
+	tp_readwrite( *this, msg);
 }
 
 void TaskProgress::jsonRead( const JSON & i_obj)
 {
-	jr_int64 ("st",  state,        i_obj);
-	jr_int32 ("str", starts_count, i_obj);
-	jr_int32 ("err", errors_count, i_obj);
-	jr_int64 ("tst", time_start,   i_obj);
-	jr_int64 ("tdn", time_done,    i_obj);
-	jr_string("hst", hostname,     i_obj);
-	jr_string("res", resources,    i_obj);
+	tp_jsonRead( *this, i_obj);
 }
 
 void TaskProgress::jsonWrite( std::ostringstream & o_str) const
 {
-	o_str << "{";
-	jw_stateJob(state, o_str);
-	o_str << ",\"st\":" << state;
-	if (percent      > 0) o_str << ",\"per\":" << int(percent);
-	if (frame        > 0) o_str << ",\"frm\":" << frame;
-	if (percentframe > 0) o_str << ",\"pfr\":" << int(percentframe);
-	if (starts_count > 0) o_str << ",\"str\":" << starts_count;
-	if (errors_count > 0) o_str << ",\"err\":" << errors_count;
-	if (time_start   > 0) o_str << ",\"tst\":" << time_start;
-	if (time_done    > 0) o_str << ",\"tdn\":" << time_done;
-	if (hostname.size() ) o_str << ",\"hst\":\"" << hostname << "\"";
-	if (activity.size() ) o_str << ",\"act\":\"" << activity << "\"";
-	if (resources.size()) o_str << ",\"res\":\"" << resources << "\"";
-//	int no_progress_for = last_progress_change - time(NULL);
-//	if (no_progress_for > 0) o_str << ",\"npf\":" << no_progress_for;
-	o_str << "}";
+	tp_jsonWrite( *this, o_str);
 }
 
 int TaskProgress::calcWeight() const
@@ -82,15 +141,202 @@ int TaskProgress::calcWeight() const
 
 void TaskProgress::v_generateInfoStream( std::ostringstream & stream, bool full ) const
 {
-   static const char time_format[] = "%H:%M.%S";
-   stream << "s" << state;
-   stream << " p" << int(percent) << "%";
-   stream << " (" << frame << "-" << int(percentframe) << "%)";
-   stream << "s" << starts_count << "/" << starts_count << "e";
-   stream << " (" << af::time2str( time_start, time_format);
-   stream << "-" << af::time2str( time_done, time_format);
-   stream << "=" << af::time2str( time_done - time_start, time_format) << ")";
-//	int no_progress_for = last_progress_change - time(NULL);
-//	if( no_progress_for > 0 ) stream << " npf" << no_progress_for;
-   if( false == hostname.empty()) stream << " - " << hostname;
+	tp_generateInfoStream( *this, stream);
+}
+
+const std::string TaskProgressStrings::ms_empty;
+
+TaskProgressStrings::TaskProgressStrings()
+{
+	// Zero id is reserved for an empty string:
+	m_strings.push_back( m_refs.end());
+}
+
+TaskProgressStrings::~TaskProgressStrings()
+{
+}
+
+uint32_t TaskProgressStrings::acquire( const std::string & i_str)
+{
+	if( i_str.empty())
+		return 0;
+
+	RefsMap::iterator it = m_refs.find( i_str);
+	if( it != m_refs.end())
+	{
+		it->second.count++;
+		return it->second.id;
+	}
+
+	// String is stored with a released or a new id:
+	Ref ref;
+	ref.count = 1;
+	if( m_free_ids.size())
+	{
+		ref.id = m_free_ids.back();
+		m_free_ids.pop_back();
+	}
+	else
+	{
+		ref.id = m_strings.size();
+		m_strings.push_back( m_refs.end());
+	}
+
+	m_strings[ref.id] = m_refs.insert( std::pair<std::string, Ref>( i_str, ref)).first;
+
+	return ref.id;
+}
+
+void TaskProgressStrings::release( uint32_t i_id)
+{
+	if( i_id == 0 )
+		return;
+
+	RefsMap::iterator it = m_strings[i_id];
+	it->second.count--;
+	if( it->second.count > 0 )
+		return;
+
+	m_refs.erase( it);
+	m_strings[i_id] = m_refs.end();
+	m_free_ids.push_back( i_id);
+}
+
+int TaskProgressStrings::calcWeight() const
+{
+	int weight = sizeof( TaskProgressStrings);
+	for( RefsMap::const_iterator it = m_refs.begin(); it != m_refs.end(); it++)
+		weight += weigh( it->first) + sizeof( Ref);
+	weight += m_strings.capacity() * sizeof( RefsMap::iterator);
+	weight += m_free_ids.capacity() * sizeof( uint32_t);
+	return weight;
+}
+
+TaskProgressColumns::TaskProgressColumns( int i_count, TaskProgressStrings * i_strings):
+	strings( i_strings),
+	m_count( i_count),
+	m_own_strings( false)
+{
+	if( NULL == strings )
+	{
+		strings = new TaskProgressStrings();
+		m_own_strings = true;
+	}
+
+	state                = new int64_t [m_count]();
+	percent              = new int8_t  [m_count]();
+	frame                = new int64_t [m_count]();
+	percentframe         = new int8_t  [m_count]();
+	starts_count         = new int32_t [m_count]();
+	errors_count         = new int32_t [m_count]();
+	time_start           = new int64_t [m_count]();
+	time_done            = new int64_t [m_count]();
+	last_progress_change = new int64_t [m_count]();
+	solve_epoch          = new int64_t [m_count]();
+	hostname             = new uint32_t[m_count]();
+	activity             = new uint32_t[m_count]();
+	resources            = new uint32_t[m_count]();
+}
+
+TaskProgressColumns::~TaskProgressColumns()
+{
+	delete [] state;
+	delete [] percent;
+	delete [] frame;
+	delete [] percentframe;
+	delete [] starts_count;
+	delete [] errors_count;
+	delete [] time_start;
+	delete [] time_done;
+	delete [] last_progress_change;
+	delete [] solve_epoch;
+	delete [] hostname;
+	delete [] activity;
+	delete [] resources;
+
+	// Job strings are deleted with all job columns, so strings are released only if they are shared:
+	if( m_own_strings )
+		delete strings;
+}
+
+int TaskProgressColumns::calcWeight() const
+{
+	int weight = sizeof( TaskProgressColumns);
+	weight += m_count * ( 8 * sizeof( int64_t) + 2 * sizeof( int8_t) + 2 * sizeof( int32_t) + 3 * sizeof( uint32_t));
+	if( m_own_strings )
+		weight += strings->calcWeight();
+	return weight;
+}
+
+TaskProgressString & TaskProgressString::operator=( const std::string & i_str)
+{
+	// Acquire first, as the new string can be the same:
+	uint32_t id = m_strings->acquire( i_str);
+	m_strings->release( m_id);
+	m_id = id;
+	return *this;
+}
+
+void TaskProgressString::clear()
+{
+	m_strings->release( m_id);
+	m_id = 0;
+}
+
+TaskProgressView::Fields::Fields( TaskProgressColumns * i_columns, int i_index):
+	state(                i_columns->state               [i_index]),
+	percent(              i_columns->percent             [i_index]),
+	frame(                i_columns->frame               [i_index]),
+	percentframe(         i_columns->percentframe        [i_index]),
+	starts_count(         i_columns->starts_count        [i_index]),
+	errors_count(         i_columns->errors_count        [i_index]),
+	time_start(           i_columns->time_start          [i_index]),
+	time_done(            i_columns->time_done           [i_index]),
+	last_progress_change( i_columns->last_progress_change[i_index]),
+	solve_epoch(          i_columns->solve_epoch         [i_index]),
+	hostname(  i_columns->strings, i_columns->hostname [i_index]),
+	activity(  i_columns->strings, i_columns->activity [i_index]),
+	resources( i_columns->strings, i_columns->resources[i_index])
+{
+}
+
+void TaskProgressView::Fields::v_readwrite( Msg * msg)
+{
+	tp_readwrite( *this, msg);
+}
+
+void TaskProgressView::Fields::jsonRead( const JSON & i_obj)
+{
+	tp_jsonRead( *this, i_obj);
+}
+
+void TaskProgressView::Fields::jsonWrite( std::ostringstream & o_str) const
+{
+	tp_jsonWrite( *this, o_str);
+}
+
+void TaskProgressView::Fields::v_generateInfoStream( std::ostringstream & stream, bool full) const
+{
+	tp_generateInfoStream( *this, stream);
+}
+
+TaskProgress TaskProgressView::operator*() const
+{
+	Fields p( m_columns, m_index);
+
+	TaskProgress tp;
+	tp.state                = p.state;
+	tp.percent              = p.percent;
+	tp.frame                = p.frame;
+	tp.percentframe         = p.percentframe;
+	tp.starts_count         = p.starts_count;
+	tp.errors_count         = p.errors_count;
+	tp.time_start           = p.time_start;
+	tp.time_done            = p.time_done;
+	tp.last_progress_change = p.last_progress_change;
+	tp.solve_epoch          = p.solve_epoch;
+	tp.hostname             = p.hostname;
+	tp.activity             = p.activity;
+	tp.resources            = p.resources;
+	return tp;
 }
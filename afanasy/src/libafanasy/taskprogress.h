@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "../include/afjob.h"
 
 #include "name_af.h"
@@ -7,6 +9,8 @@
 
 namespace af
 {
+/// Task progress values, used in messages, events and clients.
+/// Job tasks progress is stored in columns and is accessed by TaskProgressView.
 class TaskProgress : public Af
 {
 public:
@@ -29,10 +33,12 @@ public:
 	int64_t time_done;     ///< Task finish time ( or last update time if still running ).
 	int64_t last_progress_change; ///< Time of the last time that `progress` has been changed
 
-	inline void setSolved() { state |= AFJOB::STATE_SOLVED_MASK; }
-	inline void setNotSolved() { state &= (~AFJOB::STATE_SOLVED_MASK); }
-	inline bool isSolved() const { return state & AFJOB::STATE_SOLVED_MASK; }
-	inline bool isNotSolved() const { return false == (state & AFJOB::STATE_SOLVED_MASK); }
+	int64_t solve_epoch;   ///< Job solving attempt, task was tried on (not stored and not sent).
+
+	/// Task is solved in some solving attempt if it was tried in it.
+	/// Each new attempt has a new number, so there is no need to reset all tasks.
+	inline void setSolved( int64_t i_epoch) { solve_epoch = i_epoch; }
+	inline bool isSolved( int64_t i_epoch) const { return solve_epoch == i_epoch; }
 
 	std::string hostname; ///< Host, last event occurs where.
 	std::string activity; ///< Task activity that was parsed.
@@ -43,4 +49,157 @@ public:
 	void jsonRead( const JSON & i_obj);
 	void jsonWrite( std::ostringstream & o_str) const;
 };
+/// Tasks progress strings, each different string is stored once.
+/** Job tasks run on the same hosts and often have the same activity and resources.
+*** Strings are counted by references, not used strings are removed and their ids are reused.
+**/
+class TaskProgressStrings
+{
+public:
+	TaskProgressStrings();
+	~TaskProgressStrings();
+
+	/// Get string id, zero for an empty string. String references count is incremented.
+	uint32_t acquire( const std::string & i_str);
+
+	/// String is not used by a task any more.
+	void release( uint32_t i_id);
+
+	inline const std::string & get( uint32_t i_id) const
+		{ if( i_id == 0 ) return ms_empty; return m_strings[i_id]->first; }
+
+	int calcWeight() const;
+
+private:
+	static const std::string ms_empty;
+
+	struct Ref
+	{
+		uint32_t id;
+		int32_t count;
+	};
+	typedef std::map<std::string, Ref> RefsMap;
+
+	/// String id and references count by string.
+	RefsMap m_refs;
+	/// String by id, id is an index here. Zero id is an empty string.
+	std::vector<RefsMap::iterator> m_strings;
+	/// Released strings ids to reuse.
+	std::vector<uint32_t> m_free_ids;
+};
+
+/// Tasks progress stored in columns, each value of all tasks is an array.
+/** Solving and progress counting scan tasks states, that are packed together.
+*** Columns are allocated once and never moved, as tasks and executions keep views on them.
+**/
+class TaskProgressColumns
+{
+public:
+	/// If strings are not provided (system job task), columns have their own.
+	TaskProgressColumns( int i_count, TaskProgressStrings * i_strings = NULL);
+	~TaskProgressColumns();
+
+	inline int getCount() const { return m_count; }
+
+	int calcWeight() const;
+
+public:
+	int64_t * state;
+	int8_t  * percent;
+	int64_t * frame;
+	int8_t  * percentframe;
+	int32_t * starts_count;
+	int32_t * errors_count;
+	int64_t * time_start;
+	int64_t * time_done;
+	int64_t * last_progress_change;
+	int64_t * solve_epoch;
+
+	// Strings ids:
+	uint32_t * hostname;
+	uint32_t * activity;
+	uint32_t * resources;
+
+	TaskProgressStrings * strings;
+
+private:
+	int m_count;
+	bool m_own_strings;
+};
+
+/// Task progress string value, stored in tasks progress strings.
+class TaskProgressString
+{
+public:
+	inline TaskProgressString( TaskProgressStrings * i_strings, uint32_t & i_id): m_strings( i_strings), m_id( i_id) {}
+
+	inline operator const std::string & () const { return m_strings->get( m_id); }
+	inline const std::string & str() const { return m_strings->get( m_id); }
+
+	inline size_t size()  const { return str().size();  }
+	inline bool   empty() const { return str().empty(); }
+
+	TaskProgressString & operator=( const std::string & i_str);
+	inline TaskProgressString & operator=( const TaskProgressString & i_str) { return operator=( i_str.str()); }
+
+	void clear();
+
+private:
+	TaskProgressStrings * m_strings;
+	uint32_t & m_id;
+};
+
+/// Job task progress, stored in tasks progress columns.
+/** View is small, it is kept by tasks and executions instead of a pointer.
+*** Task progress is accessed by "->" as a TaskProgress object, values are read and written in columns.
+**/
+class TaskProgressView
+{
+public:
+	inline TaskProgressView(): m_columns( NULL), m_index( 0) {}
+	inline TaskProgressView( TaskProgressColumns * i_columns, int i_index): m_columns( i_columns), m_index( i_index) {}
+
+	/// Task progress values references, temporary object for a TaskProgress like access.
+	class Fields
+	{
+	public:
+		Fields( TaskProgressColumns * i_columns, int i_index);
+
+		inline Fields * operator->() { return this; }
+
+		int64_t & state;
+		int8_t  & percent;
+		int64_t & frame;
+		int8_t  & percentframe;
+		int32_t & starts_count;
+		int32_t & errors_count;
+		int64_t & time_start;
+		int64_t & time_done;
+		int64_t & last_progress_change;
+		int64_t & solve_epoch;
+
+		inline void setSolved( int64_t i_epoch) { solve_epoch = i_epoch; }
+		inline bool isSolved( int64_t i_epoch) const { return solve_epoch == i_epoch; }
+
+		TaskProgressString hostname;
+		TaskProgressString activity;
+		TaskProgressString resources;
+
+		void v_readwrite( Msg * msg);
+		void jsonRead( const JSON & i_obj);
+		void jsonWrite( std::ostringstream & o_str) const;
+		void v_generateInfoStream( std::ostringstream & stream, bool full = false) const;
+	};
+
+	inline Fields operator->() const { return Fields( m_columns, m_index); }
+
+	/// Copy task progress values, for messages and events.
+	TaskProgress operator*() const;
+
+	inline bool isNull() const { return m_columns == NULL; }
+
+private:
+	TaskProgressColumns * m_columns;
+	int32_t m_index;
+};
 }
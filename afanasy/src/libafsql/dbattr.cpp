@@ -144,6 +144,44 @@ const std::string DBAttr::DBString( const std::string * str) const
 	return dbstr;
 }
 
+void DBAttr::appendDBString( std::string & o_str, const std::string & i_str) const
+{
+	if( i_str.empty())
+	{
+		o_str += "''";
+		return;
+	}
+
+	int size = i_str.size();
+	if(( size > DBLength[type] ) && ( DBLength[type] != 0))
+		size = DBLength[type];
+
+	const std::string & quotes = af::Environment::get_DB_StringQuotes();
+	o_str += quotes;
+	o_str.append( i_str, 0, size);
+	o_str += quotes;
+}
+
+void DBAttr::appendInt( std::string & o_str, long long i_value)
+{
+	char buf[24];
+	char * end = buf + sizeof(buf);
+	char * ptr = end;
+
+	unsigned long long value = i_value < 0 ? 0ULL - (unsigned long long)( i_value) : i_value;
+	do
+	{
+		*--ptr = '0' + ( value % 10 );
+		value /= 10;
+	}
+	while( value );
+
+	if( i_value < 0 )
+		*--ptr = '-';
+
+	o_str.append( ptr, end - ptr);
+}
+
 DBAttrInt8  ::DBAttrInt8      ( int type,   int8_t * parameter):     DBAttr( type), pointer( parameter) {}
 DBAttrInt8  ::~DBAttrInt8     (){}
 DBAttrUInt8 ::DBAttrUInt8     ( int type,  uint8_t * parameter):     DBAttr( type), pointer( parameter) {}
@@ -118,6 +118,11 @@ public:
 	};
 
 	virtual const std::string getString() const = 0;
+
+	/// Append value string, it is the same as getString but with no temporary strings.
+	/// Used for multi-row inserts, where values serialization cost matters.
+	inline virtual void appendString( std::string & o_str) const { o_str += getString();}
+
 	inline virtual void set( long long value) {};
 	inline virtual void set( const std::string & value) {};
 
@@ -129,6 +134,8 @@ public:
 protected:
 	const std::string DBString( const std::string * str) const;
 	inline const std::string DBString( const std::string str)  const { return DBString( &str);}
+	void appendDBString( std::string & o_str, const std::string & i_str) const;
+	static void appendInt( std::string & o_str, long long i_value);
 
 private:
 	static std::string DBName[_LAST_];
@@ -145,6 +152,7 @@ public:
 	DBAttrInt8( int type, int8_t * parameter);
 	~DBAttrInt8();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: int8_t * pointer;
 };
@@ -155,6 +163,7 @@ public:
 	DBAttrUInt8( int type, uint8_t * parameter);
 	~DBAttrUInt8();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: uint8_t * pointer;
 };
@@ -165,6 +174,7 @@ public:
 	DBAttrInt16( int type, int16_t * parameter);
 	~DBAttrInt16();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: int16_t * pointer;
 };
@@ -175,6 +185,7 @@ public:
 	DBAttrUInt16( int type, uint16_t * parameter);
 	~DBAttrUInt16();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: uint16_t * pointer;
 };
@@ -185,6 +196,7 @@ public:
 	DBAttrInt32( int type, int32_t * parameter);
 	~DBAttrInt32();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: int32_t * pointer;
 };
@@ -195,6 +207,7 @@ public:
 	DBAttrInt64( int type, int64_t * parameter);
 	~DBAttrInt64();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: int64_t * pointer;
 };
@@ -205,6 +218,7 @@ public:
 	DBAttrUInt32( int type, uint32_t * parameter);
 	~DBAttrUInt32();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 	inline void set( long long value) { *pointer = value;}
 private: uint32_t * pointer;
 };
@@ -215,6 +229,7 @@ public:
 	DBAttrInt32Const( int type, const int32_t * parameter);
 	~DBAttrInt32Const();
 	inline const std::string getString() const { return af::itos(*pointer);}
+	inline void appendString( std::string & o_str) const { appendInt( o_str, *pointer);}
 private: const int32_t * pointer;
 };
 
@@ -224,6 +239,7 @@ public:
 	DBAttrString( int type, std::string * parameter);
 	~DBAttrString();
 	inline const std::string getString() const { return DBString( pointer);}
+	inline void appendString( std::string & o_str) const { appendDBString( o_str, *pointer);}
 	inline void set( const std::string & value) { *pointer = value;}
 private: std::string * pointer;
 };
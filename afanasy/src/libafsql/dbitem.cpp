@@ -55,6 +55,32 @@ void DBItem::v_dbInsert( std::list<std::string> * queries) const
 	queries->push_back( str);
 }
 
+const std::string DBItem::dbInsertPrefix() const
+{
+	std::string str = std::string("INSERT INTO ") + v_dbGetTableName() + " (";
+	for( int i = 0; i < dbAttributes.size(); i++)
+	{
+		if( i != 0 ) str += ",";
+		str += dbAttributes[i]->getName();
+	}
+	str += ") VALUES ";
+	return str;
+}
+
+void DBItem::dbInsertValues( std::string & o_values) const
+{
+	if( o_values.size())
+		o_values += ",\n";
+
+	o_values += "(";
+	for( int i = 0; i < dbAttributes.size(); i++)
+	{
+		if( i != 0 ) o_values += ",";
+		dbAttributes[i]->appendString( o_values);
+	}
+	o_values += ")";
+}
+
 void DBItem::v_dbDelete( std::list<std::string> * queries) const
 {
  	queries->push_back( std::string("DELETE FROM ") + v_dbGetTableName()
@@ -16,6 +16,12 @@ public:
 	void dbDropTable(   std::list<std::string> * queries) const;
 
 	virtual void v_dbInsert( std::list<std::string> * queries) const;
+
+	/// Multi-row insert query beginning: "INSERT INTO table (columns) VALUES ".
+	const std::string dbInsertPrefix() const;
+
+	/// Append values row "(values)" of a multi-row insert, rows are separated by a comma.
+	void dbInsertValues( std::string & o_values) const;
 	virtual void v_dbDelete( std::list<std::string> * queries) const;
 	virtual void v_dbUpdate( std::list<std::string> * queries, int attr = -1) const;
 	virtual bool v_dbSelect( PGconn * i_conn, const std::string * i_where = NULL);
@@ -33,6 +33,33 @@ DBJob::~DBJob()
 }
 
 void DBJob::add( const af::Job * i_job, std::list<std::string> * o_queries)
+{
+	if( false == setJob( i_job))
+		return;
+
+	// Inserting each block in table:
+	for( int b = 0; b < i_job->getBlocksNum(); b++)
+		if( setBlock( i_job, b))
+			v_dbInsert( o_queries);
+}
+
+int DBJob::add( const af::Job * i_job, std::string & o_values)
+{
+	if( false == setJob( i_job))
+		return 0;
+
+	int rows = 0;
+	for( int b = 0; b < i_job->getBlocksNum(); b++)
+		if( setBlock( i_job, b))
+		{
+			dbInsertValues( o_values);
+			rows++;
+		}
+
+	return rows;
+}
+
+bool DBJob::setJob( const af::Job * i_job)
 {
 	// Get job parameters:
 	m_serial      = i_job->getSerial();
@@ -46,31 +73,31 @@ void DBJob::add( const af::Job * i_job, std::list<std::string> * o_queries)
 	m_time_done   = i_job->getTimeDone();
 
 	// Skip not started i_job:
-	if( m_time_start == 0 ) return;
+	if( m_time_start == 0 ) return false;
 	// Skip job with no running time:
-	if( m_time_start == m_time_done ) return;
+	if( m_time_start == m_time_done ) return false;
 	// Set done time to current time, if job was not done:
 	if( m_time_done < m_time_start ) m_time_done = time( NULL);
 
-	// Inserting each block in table:
-	for( int b = 0; b < i_job->getBlocksNum(); b++)
-	{
-		// Get block parameters:
-		af::BlockData * block = i_job->getBlockData(b);
-		m_block_id = block->getBlockNum();
-		m_blockname = block->getName();
-		m_capacity = block->getCapacity();
-		m_service = block->getService();
-		m_tasks_quantity = block->getTasksNum();
-		m_tasks_done = block->getProgressTasksDone();
-		m_run_time_sum = block->getProgressTasksSumRunTime();
-
-		// Skip blocks with no run time:
-		if( m_tasks_quantity == 0 ) continue;
-		if( m_tasks_done == 0 ) continue;
-		if( m_run_time_sum == 0 ) continue;
-
-		// Insert row:
-		v_dbInsert( o_queries);
-	}
+	return true;
+}
+
+bool DBJob::setBlock( const af::Job * i_job, int i_block)
+{
+	// Get block parameters:
+	af::BlockData * block = i_job->getBlockData( i_block);
+	m_block_id = block->getBlockNum();
+	m_blockname = block->getName();
+	m_capacity = block->getCapacity();
+	m_service = block->getService();
+	m_tasks_quantity = block->getTasksNum();
+	m_tasks_done = block->getProgressTasksDone();
+	m_run_time_sum = block->getProgressTasksSumRunTime();
+
+	// Skip blocks with no run time:
+	if( m_tasks_quantity == 0 ) return false;
+	if( m_tasks_done == 0 ) return false;
+	if( m_run_time_sum == 0 ) return false;
+
+	return true;
 }
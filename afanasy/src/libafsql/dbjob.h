@@ -14,8 +14,18 @@ public:
 
 	void add( const af::Job * i_job, std::list<std::string> * o_queries);
 
+	/// Append multi-row insert values rows of job blocks, returns number of rows.
+	int add( const af::Job * i_job, std::string & o_values);
+
 	inline const std::string & v_dbGetTableName()  const { return ms_TableName;}
 
+private:
+	/// Set job values, returns false if job was not running.
+	bool setJob( const af::Job * i_job);
+
+	/// Set block values, returns false if block has no run time.
+	bool setBlock( const af::Job * i_job, int i_block);
+
 private:
 	std::string m_annotation;
 	std::string m_blockname;
@@ -44,6 +44,30 @@ void DBTask::add(
 	const af::Job * i_job,
 	const af::Render * i_render,
 	std::list<std::string> * o_queries)
+{
+	if( set( i_exec, i_progress, i_job, i_render))
+		v_dbInsert( o_queries);
+}
+
+bool DBTask::add(
+	const af::TaskExec * i_exec,
+	const af::TaskProgress * i_progress,
+	const af::Job * i_job,
+	const af::Render * i_render,
+	std::string & o_values)
+{
+	if( false == set( i_exec, i_progress, i_job, i_render))
+		return false;
+
+	dbInsertValues( o_values);
+	return true;
+}
+
+bool DBTask::set(
+	const af::TaskExec * i_exec,
+	const af::TaskProgress * i_progress,
+	const af::Job * i_job,
+	const af::Render * i_render)
 {
 	m_job_serial = i_job->getSerial();
 
@@ -72,12 +96,11 @@ void DBTask::add(
 	m_annotation  = i_job->getAnnotation();
 
 	// Skip not started exec:
-	if( m_time_start == 0 ) return;
+	if( m_time_start == 0 ) return false;
 	// Skip exec with no running time:
-	if( m_time_start == m_time_done ) return;
+	if( m_time_start == m_time_done ) return false;
 	// Set done time to current time, if exec was not done:
 	if( m_time_done < m_time_start ) m_time_done = time( NULL);
 
-	// Insert row:
-	v_dbInsert( o_queries);
+	return true;
 }
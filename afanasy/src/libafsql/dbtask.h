@@ -19,8 +19,24 @@ public:
 		const af::Render * i_render,
 		std::list<std::string> * o_queries);
 
+	/// Append a multi-row insert values row, returns false if task should not be inserted.
+	bool add(
+		const af::TaskExec * i_exec,
+		const af::TaskProgress * i_progress,
+		const af::Job * i_job,
+		const af::Render * i_render,
+		std::string & o_values);
+
 	inline const std::string & v_dbGetTableName()  const { return ms_TableName;}
 
+private:
+	/// Set task values, returns false if task was not running.
+	bool set(
+		const af::TaskExec * i_exec,
+		const af::TaskProgress * i_progress,
+		const af::Job * i_job,
+		const af::Render * i_render);
+
 private:
 	std::string m_annotation;
 	std::string m_blockname;
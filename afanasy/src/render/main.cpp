@@ -34,6 +34,7 @@ int HeartBeatSec          = AFRENDER::HEARTBEAT_SEC;
 int ResourcesUpdatePeriod = AFRENDER::RESOURCES_UPDATE_PERIOD;
 int ZombieTime            = AFRENDER::ZOMBIETIME;
 int ExitNoTaskTime        = -1;
+int RetrySec              = 0; ///< Server asked to retry registration after this time.
 
 //######################### Signal handlers ############################################
 #ifdef WINNT
@@ -191,7 +192,24 @@ int main(int argc, char *argv[])
 
 		// Sleep till the next heartbeat:
 		if( AFRunning )
-			af::sleep_sec(HeartBeatSec);
+		{
+			int64_t heartbeat_time = af::getMonotonicMSec() + 1000 * ( RetrySec > 0 ? RetrySec : HeartBeatSec );
+			RetrySec = 0;
+
+			// React on events pushed by server on kept connection immediately:
+			while( AFRunning && render->isConnectionKept())
+			{
+				int64_t now = af::getMonotonicMSec();
+				if( now >= heartbeat_time )
+					break;
+
+				msgCase( render->waitServer( int( heartbeat_time - now)), *render);
+			}
+
+			int64_t now = af::getMonotonicMSec();
+			if( AFRunning && ( now < heartbeat_time ))
+				af::sleep_msec( int( heartbeat_time - now));
+		}
 	}
 
 	delete render;
@@ -295,6 +313,13 @@ AF_LOG << i_re;
 				AF_ERR << "Exit signal received from server.";
 			AFRunning = false;
 			return;
+
+		case af::RenderEvents::RE_Status_Retry:
+			// Server is busy (registration storm), it gives each render its own time to retry:
+			RetrySec = i_re.m_heartbeat_sec;
+			AF_WARN << "SERVER: " << i_re.m_log << " Retrying in " << RetrySec << " seconds.";
+			i_render.registrationPostponed();
+			return;
 	}
 
 
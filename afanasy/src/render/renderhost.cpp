@@ -38,6 +38,9 @@ RenderHost::RenderHost():
 	m_updateMsgType( af::Msg::TRenderRegister),
 	m_connected( false),
 	m_server_update_time(0),
+	m_socket(-1),
+	m_socket_refused_time(0),
+	m_hres_sent_valid( false),
 	m_no_output_redirection( false)
 {
 	m_has_tasks_time = time(NULL);
@@ -83,6 +86,8 @@ RenderHost::~RenderHost()
         if( m_pyres[i])
             delete m_pyres[i];
 
+    closeConnection();
+
     // Send deregister message if connected:
     if( m_connected )
     {
@@ -127,10 +132,20 @@ void RenderHost::setRegistered( int i_id)
 {
 	m_connected = true;
     m_id = i_id;
+	// Server can keep connection after a new registration:
+	m_socket_refused_time = 0;
     AF_LOG << "Render registered.";
 	RenderHost::connectionEstablished();
 }
 
+void RenderHost::registrationPostponed()
+{
+	// Any server answer switches not connected render to updates,
+	// but it is still not registered:
+	if (false == m_connected)
+		setUpdateMsgType(af::Msg::TRenderRegister);
+}
+
 void RenderHost::serverUpdateFailed()
 {
     if (m_connected == false)
@@ -161,6 +176,8 @@ void RenderHost::connectionLost()
 
 	m_connected = false;
 
+	closeConnection();
+
     // Begin to try to register again:
     setUpdateMsgType( af::Msg::TRenderRegister);
     
@@ -226,7 +243,11 @@ void RenderHost::getResources()
 		m_pyres[i]->update();
 
 	//hres.stdOut();
-	m_up.setResources( &m_hres);
+
+	// Send only fields changed since the last sent resources:
+	m_hres.setDelta( m_hres_sent_valid ? &m_hres_sent : NULL);
+	if( m_hres.delta )
+		m_up.setResources( &m_hres);
 
 	std::ostringstream str;
 	m_hres.jsonWrite(str);
@@ -271,10 +292,39 @@ af::Msg * RenderHost::updateServer()
 	AF_LOG << " <<< " << msg;
 	#endif
 
+	// Stream update on kept connection, server answer will be received while waiting:
+	if(( m_updateMsgType == af::Msg::TRenderUpdate ) && af::Environment::getRenderConnectionKeep())
+	{
+		// Server should answer each update, silence means that something is wrong:
+		if( isConnectionKept() && ( time(NULL) >= ( m_server_update_time + ZombieTime )))
+		{
+			AF_WARN << "No answer from server on kept connection for " << ZombieTime << " seconds.";
+			closeConnection();
+		}
+		else if(( false == isConnectionKept()) && ( time(NULL) >= ( m_socket_refused_time + ZombieTime )))
+			keepConnection();
+
+		if( isConnectionKept())
+		{
+			if( af::msgwrite( m_socket, msg))
+			{
+				resourcesSent( true);
+				delete msg;
+				m_up.clear();
+				return NULL;
+			}
+
+			AF_WARN << "Failed to send update on kept connection.";
+			closeConnection();
+		}
+	}
+
 	bool ok;
 	af::Msg * server_answer = af::sendToServer( msg, ok,
 		msg->type() == af::Msg::TRenderRegister ? af::VerboseOff : af::VerboseOn);
 
+	resourcesSent( ok);
+
 	if (ok)
 		connectionEstablished();
 	else
@@ -287,6 +337,87 @@ af::Msg * RenderHost::updateServer()
 	return server_answer;
 }
 
+void RenderHost::resourcesSent( bool i_ok)
+{
+	// Registration sends all resources, update only changed fields (if any):
+	if(( m_updateMsgType != af::Msg::TRenderRegister ) && ( false == m_up.hasResources()))
+		return;
+
+	// Server state is unknown on failure, next update will send all fields:
+	m_hres_sent_valid = i_ok;
+	if( i_ok )
+		m_hres_sent.copy( m_hres);
+}
+
+void RenderHost::keepConnection()
+{
+	// Failed connect is reported by the update itself:
+	int sfd = af::connectToServer( af::VerboseOff);
+	if( sfd == -1 )
+		return;
+
+	af::Msg msg( af::Msg::TRenderConnect, getId());
+	af::Msg * answer = NULL;
+	if( af::msgwrite( sfd, &msg))
+	{
+		answer = new af::Msg();
+		if( false == af::msgread( sfd, answer))
+		{
+			delete answer;
+			answer = NULL;
+		}
+	}
+
+	// Server sends back render id if it keeps connection:
+	if( answer && ( answer->type() == af::Msg::TRenderId ) && ( answer->int32() == getId()))
+	{
+		m_socket = sfd;
+		m_socket_refused_time = 0;
+		AF_LOG << "Server keeps connection.";
+	}
+	else
+	{
+		// Do not ask again on each update, retry after zombie time or a new registration:
+		m_socket_refused_time = time(NULL);
+		AF_WARN << "Server does not keep connection, connecting on each update.";
+		af::socketClose( sfd);
+	}
+
+	if( answer )
+		delete answer;
+}
+
+void RenderHost::closeConnection()
+{
+	if( false == isConnectionKept())
+		return;
+
+	af::socketClose( m_socket);
+	m_socket = -1;
+}
+
+af::Msg * RenderHost::waitServer( int i_msec)
+{
+	if( false == isConnectionKept())
+		return NULL;
+
+	if( false == af::socketWaitRead( m_socket, i_msec))
+		return NULL;
+
+	af::Msg * msg = new af::Msg();
+	if( false == af::msgread( m_socket, msg))
+	{
+		AF_WARN << "Kept connection closed by server.";
+		delete msg;
+		closeConnection();
+		return NULL;
+	}
+
+	connectionEstablished();
+
+	return msg;
+}
+
 #ifdef WINNT
 void RenderHost::windowsMustDie()
 {
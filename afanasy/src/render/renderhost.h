@@ -41,6 +41,11 @@ public:
 	*/
 	void setRegistered( int i_id);
 
+	/**
+	* @brief Server is busy and asked render to retry registration later.
+	*/
+	void registrationPostponed();
+
 	/**
 	* @brief Task monitoring cycle, checking how task processes are doing
 	*/
@@ -51,6 +56,18 @@ public:
 	*/
 	af::Msg * updateServer();
 
+	/**
+	* @brief Whether render keeps connection to server to receive pushed events.
+	*/
+	inline bool isConnectionKept() const { return m_socket != -1; }
+
+	/**
+	* @brief Wait for a message pushed by server on kept connection.
+	* @param i_msec Milliseconds to wait.
+	* @return Received message or NULL on timeout or error.
+	*/
+	af::Msg * waitServer( int i_msec);
+
 	/**
 	* @brief Get machine resources.
 	* Custom resources also called there.
@@ -127,6 +144,22 @@ private:
 	*/
 	void serverUpdateFailed();
 
+	/**
+	* @brief Store resources that were sent to server, to send only changes next time.
+	* @param i_ok Whether the message was sent successfully.
+	*/
+	void resourcesSent( bool i_ok);
+
+	/**
+	* @brief Ask server to keep a new connection.
+	*/
+	void keepConnection();
+
+	/**
+	* @brief Close kept connection, render will connect to server on each update.
+	*/
+	void closeConnection();
+
 private:
 	/// Windows to kill on windows
 	/// Bad mswin applications like to raise a gui window with an error and waits for some 'Ok' button.
@@ -140,6 +173,11 @@ private:
 	/// Times when render send last update message to server
 	time_t m_server_update_time;
 
+	/// Kept connection socket descriptor, -1 if render connects on each update.
+	int m_socket;
+	/// Time when server refused to keep connection, render does not ask again for some time.
+	time_t m_socket_refused_time;
+
 	/// Heartbeat message to sent at each update.
 	/// It is initially a `TRenderRegister` and as soon as the server
 	/// registered the render, it becomes a `TRenderUpdate`.
@@ -157,6 +195,10 @@ private:
 	/// Render resources string
 	std::string m_resources_string;
 
+	/// Resources that server has, updates send only changed fields.
+	af::HostRes m_hres_sent;
+	bool m_hres_sent_valid;
+
 	/// Time when render has at least on task:
 	time_t m_has_tasks_time;
 };
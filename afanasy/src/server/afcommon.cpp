@@ -30,6 +30,7 @@
 
 #include "../include/afanasy.h"
 
+#include "storelog.h"
 #include "threadargs.h"
 
 #define AFOUTPUT
@@ -49,7 +50,7 @@ LogQueue *AFCommon::OutputLogQueue = NULL;
 */
 AFCommon::AFCommon(ThreadArgs *i_threadArgs)
 {
-	FileWriteQueue = new FileQueue("Writing Files");
+	FileWriteQueue = new FileQueue("Writing Files", af::Environment::getServerFilesWriteThreads());
 	OutputLogQueue = new LogQueue("Log Output");
 	ms_DBQueue = new DBQueue("AFDB_update", i_threadArgs->monitors);
 
@@ -61,6 +62,8 @@ AFCommon::~AFCommon()
 	delete FileWriteQueue;
 	delete OutputLogQueue;
 	delete ms_DBQueue;
+
+	StoreLog::Close();
 }
 
 /*
@@ -96,6 +99,8 @@ const std::string AFCommon::getStoreDir(const std::string &i_folder, int i_id, c
 
 const std::vector<std::string> AFCommon::getStoredFolders(const std::string &i_folder)
 {
+	if (StoreLog::Enabled()) return StoreLog::GetFolders(i_folder);
+
 	std::vector<std::string> o_folders;
 
 #ifdef WINNT
@@ -244,6 +249,37 @@ const std::vector<std::string> AFCommon::getStoredFoldersSortedPath(const std::s
 	return folders;
 }
 
+bool AFCommon::writeStoreFile(const std::string &i_str, const std::string &i_file_name)
+{
+	if (StoreLog::Manages(i_file_name)) return StoreLog::Write(i_str.c_str(), i_str.size(), i_file_name);
+
+	return writeFile(i_str, i_file_name);
+}
+
+char *AFCommon::readStoreFile(const std::string &i_file_name, int *o_size)
+{
+	if (StoreLog::Manages(i_file_name)) return StoreLog::Read(i_file_name, o_size);
+
+	return af::fileRead(i_file_name, o_size);
+}
+
+bool AFCommon::storeFileExists(const std::string &i_file_name)
+{
+	if (StoreLog::Manages(i_file_name)) return StoreLog::Exists(i_file_name);
+
+	return af::pathFileExists(i_file_name);
+}
+
+bool AFCommon::removeStoreDir(const std::string &i_folder)
+{
+	if (StoreLog::Enabled()) StoreLog::Remove(i_folder);
+
+	// Folder can exist in store log mode too, for tasks output and files:
+	if (false == af::pathIsFolder(i_folder)) return true;
+
+	return af::removeDir(i_folder);
+}
+
 void AFCommon::executeCmd(const std::string &cmd)
 {
 	std::cout << af::time2str() << ": Executing command:\n" << cmd.c_str() << std::endl;
@@ -319,3 +355,40 @@ bool AFCommon::writeFile(const char *data, const int length, const std::string &
 	AFINFA("AFCommon::writeFile - \"%s\"", filename.c_str())
 	return true;
 }
+
+bool AFCommon::appendFile(const char *data, const int length, const std::string &filename)
+{
+	if (filename.size() == 0)
+	{
+		QueueLogError("AFCommon::appendFile: File name is empty.");
+		return false;
+	}
+
+#ifdef WINNT
+	int fd = _open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0644);
+#else
+	int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+	if (fd == -1)
+	{
+		QueueLogErrno(std::string("AFCommon::appendFile: ") + filename);
+		return false;
+	}
+	int bytes = 0;
+	while (bytes < length)
+	{
+		int written = write(fd, data + bytes, length - bytes);
+		if (written == -1)
+		{
+			QueueLogErrno(std::string("AFCommon::appendFile: ") + filename);
+			close(fd);
+			return false;
+		}
+		bytes += written;
+	}
+
+	close(fd);
+
+	AFINFA("AFCommon::appendFile - \"%s\"", filename.c_str())
+	return true;
+}
@@ -19,6 +19,7 @@
 #include "../libafanasy/environment.h"
 #include "../libafanasy/msgqueue.h"
 #include "../libafanasy/name_af.h"
+#include "../libafanasy/taskprogress.h"
 
 #include "../libafsql/name_afsql.h"
 
@@ -46,6 +47,7 @@ public:
 		const std::list<std::string> &log, const std::string &dirname, const std::string &filename);
 
 	static bool writeFile(const char *data, const int length, const std::string &filename); ///< Write a file
+	static bool appendFile(const char *data, const int length, const std::string &filename); ///< Append to a file end
 	inline static bool writeFile(const std::string &i_str, const std::string &i_file_name)
 	{
 		return writeFile(i_str.c_str(), i_str.size(), i_file_name);
@@ -93,6 +95,14 @@ public:
 
 	static const std::vector<std::string> getStoredFolders(const std::string &i_folder);
 
+	//
+	// Nodes store files, they are kept in folders or in the store log:
+	//
+	static bool writeStoreFile(const std::string &i_str, const std::string &i_file_name);
+	static char *readStoreFile(const std::string &i_file_name, int *o_size);
+	static bool storeFileExists(const std::string &i_file_name);
+	static bool removeStoreDir(const std::string &i_folder);
+
 	// Get stored foders sorted by specially node name,
 	// assuming that name represents path (branches, pools),
 	// and parent node should be always before childs.
@@ -109,6 +119,7 @@ public:
 
 	inline static void QueueFileWrite(FileData *i_filedata) { FileWriteQueue->pushFile(i_filedata); }
 	inline static void QueueNodeCleanUp(const AfNodeSrv *i_node) { FileWriteQueue->pushNode(i_node); }
+	inline static void writeFilesStat(std::ostringstream &o_str) { FileWriteQueue->writeStat(o_str); }
 
 	inline static void QueueLog(const std::string &log) { OutputLogQueue->pushLog(log, LogData::Info); }
 	inline static void QueueLogError(const std::string &log) { OutputLogQueue->pushLog(log, LogData::Error); }
@@ -118,10 +129,26 @@ public:
 	{
 		if (ms_DBQueue) ms_DBQueue->addJob(i_job);
 	}
-	inline static void DBAddTask(const af::TaskExec *i_exec, const af::TaskProgress *i_progress,
+	inline static void DBAddTask(const af::TaskExec *i_exec, const af::TaskProgressView &i_progress,
 		const af::Job *i_job, const af::Render *i_render)
 	{
-		if (ms_DBQueue) ms_DBQueue->addTask(i_exec, i_progress, i_job, i_render);
+		if (ms_DBQueue)
+		{
+			af::TaskProgress progress = *i_progress;
+			ms_DBQueue->addTask(i_exec, &progress, i_job, i_render);
+		}
+	}
+	inline static void DBFlush()
+	{
+		if (ms_DBQueue) ms_DBQueue->flush();
+	}
+	inline static void DBWriteStat(std::ostringstream &o_str)
+	{
+		if (ms_DBQueue) ms_DBQueue->writeStat(o_str);
+	}
+	inline static void DBJsonWrite(std::ostringstream &o_str)
+	{
+		if (ms_DBQueue) ms_DBQueue->jsonWrite(o_str);
 	}
 
 private:
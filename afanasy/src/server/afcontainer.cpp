@@ -17,7 +17,11 @@
 #include "afcontainer.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgclasses/mcafnodes.h"
 #include "../libafanasy/regexp.h"
 
@@ -37,8 +41,21 @@ AfContainer::AfContainer(std::string containerName, int maximumSize)
 	  m_name(containerName),
 	  m_first_ptr(NULL),
 	  m_last_ptr(NULL),
-	  m_initialized(false)
+	  m_initialized(false),
+	  m_snapshot_type(0)
 {
+	// Client can keep a version from the previous server run, versions increase slower than microseconds:
+	int64_t version = int64_t(time(NULL)) * 1000000;
+
+	m_snapshot_json.valid = false;
+	m_snapshot_json.dirty = true;
+	m_snapshot_json.version = version;
+	m_snapshot_json.request_time = 0;
+	m_snapshot_bin.valid = false;
+	m_snapshot_bin.dirty = true;
+	m_snapshot_bin.version = version;
+	m_snapshot_bin.request_time = 0;
+
 	m_nodes_table = new AfNodeSrv *[m_capacity];
 	if (m_nodes_table == NULL)
 	{
@@ -49,6 +66,9 @@ AfContainer::AfContainer(std::string containerName, int maximumSize)
 	for (int i = 0; i < m_capacity; i++)
 		m_nodes_table[i] = NULL;
 
+	memset(&m_lock_stat_read,  0, sizeof(LockStat));
+	memset(&m_lock_stat_write, 0, sizeof(LockStat));
+
 	m_initialized = true;
 }
 
@@ -229,7 +249,7 @@ af::Msg *AfContainer::generateList(int i_type, const std::string &i_type_name,
 	const std::vector<int32_t> &i_ids, const std::string &i_mask, bool i_json)
 {
 	af::MCAfNodes mcnodes;
-	std::ostringstream str;
+	af::MsgStream str;
 
 	if (i_json) str << "{\"" << i_type_name << "\":[\n";
 
@@ -240,18 +260,152 @@ af::Msg *AfContainer::generateList(int i_type, const std::string &i_type_name,
 	else
 		generateListAll(i_type, mcnodes, str, i_json);
 
-	af::Msg *msg = new af::Msg();
-
 	if (i_json)
 	{
 		str << "\n]}";
-		std::string s = str.str();
-		msg->setData(s.size(), s.c_str(), af::Msg::TJSON);
+		return af::jsonMsg(str);
+	}
+
+	return new af::Msg(i_type, &mcnodes);
+}
+
+void AfContainer::setSnapshotType(int i_type, const std::string &i_type_name)
+{
+	m_snapshot_type = i_type;
+	m_snapshot_type_name = i_type_name;
+}
+
+void AfContainer::setSnapshotDirty()
+{
+	DlScopeLocker lock(&m_snapshot_mutex);
+
+	m_snapshot_json.dirty = true;
+	m_snapshot_bin.dirty = true;
+}
+
+void AfContainer::updateSnapshot()
+{
+	if (m_snapshot_type == 0)
+		return;
+
+	int64_t now = af::getMonotonicMSec();
+	int64_t period = 1000 * int64_t(af::Environment::getServerListSnapshotSec());
+
+	bool json, bin;
+	{
+		DlScopeLocker lock(&m_snapshot_mutex);
+
+		json = m_snapshot_json.request_time && (now - m_snapshot_json.request_time < period);
+		bin  = m_snapshot_bin.request_time  && (now - m_snapshot_bin.request_time  < period);
+
+		// Not requested lists are not prepared and should not be served, as they become outdated.
+		if (false == json)
+		{
+			m_snapshot_json.valid = false;
+			m_snapshot_json.data.clear();
+		}
+		if (false == bin)
+		{
+			m_snapshot_bin.valid = false;
+			m_snapshot_bin.data.clear();
+		}
+
+		// Lists are prepared again only if nodes were changed:
+		json = json && (m_snapshot_json.dirty || (false == m_snapshot_json.valid));
+		bin  = bin  && (m_snapshot_bin.dirty  || (false == m_snapshot_bin.valid));
+
+		// Clear flags before generation, nodes can be changed during it (renders updates):
+		if (json) m_snapshot_json.dirty = false;
+		if (bin)  m_snapshot_bin.dirty  = false;
+	}
+
+	if ((false == json) && (false == bin))
+		return;
+
+	// Generate lists without snapshot mutex locked, requests are served from the previous snapshot.
+	std::string json_data, bin_data;
+
+	if (json)
+	{
+		af::MCAfNodes mcnodes;
+		std::ostringstream str;
+		str << "{\"" << m_snapshot_type_name << "\":[\n";
+		generateListAll(m_snapshot_type, mcnodes, str, true);
+		str << "\n]";
+		json_data = str.str();
+	}
+
+	if (bin)
+	{
+		af::MCAfNodes mcnodes;
+		std::ostringstream str;
+		generateListAll(m_snapshot_type, mcnodes, str, false);
+		af::Msg msg(m_snapshot_type, &mcnodes);
+		bin_data.assign(msg.data(), msg.dataLen());
+	}
+
+	DlScopeLocker lock(&m_snapshot_mutex);
+
+	// Node change event does not always change list data:
+	if (json)
+	{
+		if (json_data != m_snapshot_json.data)
+		{
+			m_snapshot_json.data.swap(json_data);
+			m_snapshot_json.version++;
+		}
+		m_snapshot_json.valid = true;
+	}
+
+	if (bin)
+	{
+		if (bin_data != m_snapshot_bin.data)
+		{
+			m_snapshot_bin.data.swap(bin_data);
+			m_snapshot_bin.version++;
+		}
+		m_snapshot_bin.valid = true;
+	}
+}
+
+af::Msg *AfContainer::generateSnapshot(bool i_json, int64_t i_version)
+{
+	if (m_snapshot_type == 0)
+		return NULL;
+
+	if (af::Environment::getServerListSnapshotSec() <= 0)
+		return NULL;
+
+	DlScopeLocker lock(&m_snapshot_mutex);
+
+	Snapshot & snapshot = i_json ? m_snapshot_json : m_snapshot_bin;
+
+	// Run thread will prepare snapshot while it is requested:
+	snapshot.request_time = af::getMonotonicMSec();
+
+	if (false == snapshot.valid)
+		return NULL;
+
+	if (false == i_json)
+	{
+		af::Msg *msg = new af::Msg();
+		msg->setData(snapshot.data.size(), snapshot.data.c_str(), m_snapshot_type);
+		return msg;
+	}
+
+	af::MsgStream str;
+	if (i_version == snapshot.version)
+	{
+		str << "{\"not_modified\":{\"type\":\"" << m_snapshot_type_name << "\"";
+		str << ",\"version\":" << snapshot.version << "}}";
 	}
 	else
-		msg->set(i_type, &mcnodes);
+	{
+		str << snapshot.data;
+		str << ",\"version\":" << snapshot.version << "}";
+	}
 
-	return msg;
+	return af::jsonMsg(str);
 }
 
 void AfContainer::generateListAll(
@@ -400,6 +554,47 @@ void AfContainer::freeZombies()
 	}
 }
 
+void AfContainer::lockStat(bool i_write, int64_t i_wait_usec, int64_t i_hold_usec)
+{
+	DlScopeLocker lock(&m_lock_stat_mutex);
+
+	LockStat & stat = i_write ? m_lock_stat_write : m_lock_stat_read;
+
+	stat.count++;
+	stat.wait += i_wait_usec;
+	stat.hold += i_hold_usec;
+	if (i_wait_usec > stat.wait_max)
+		stat.wait_max = i_wait_usec;
+	if (i_hold_usec > stat.hold_max)
+		stat.hold_max = i_hold_usec;
+}
+
+void AfContainer::writeLockStat(std::ostringstream &o_str)
+{
+	LockStat read, write;
+	{
+		DlScopeLocker lock(&m_lock_stat_mutex);
+		read  = m_lock_stat_read;
+		write = m_lock_stat_write;
+		memset(&m_lock_stat_read,  0, sizeof(LockStat));
+		memset(&m_lock_stat_write, 0, sizeof(LockStat));
+	}
+
+	o_str << "\n" << m_name << ":";
+
+	const char * names[2] = {"read", "write"};
+	const LockStat * stats[2] = {&read, &write};
+	for (int i = 0; i < 2; i++)
+	{
+		const LockStat & stat = *stats[i];
+		o_str << " " << names[i] << " " << stat.count;
+		if (stat.count == 0)
+			continue;
+		o_str << " (wait avg " << (stat.wait / stat.count) << " max " << stat.wait_max;
+		o_str << ", hold avg " << (stat.hold / stat.count) << " max " << stat.hold_max << " us)";
+	}
+}
+
 af::Msg * AfContainer::action(Action & i_action, const af::Msg * i_msg)
 {
 	bool found = false;
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/common/dlRWLock.h"
 
 #include "../libafanasy/msg.h"
@@ -45,6 +46,22 @@ public:
 	af::Msg *generateList(int i_type, const std::string &i_type_name, const std::vector<int32_t> &i_ids,
 		const std::string &i_mask, bool i_json);
 
+	/// Set whole nodes list type that can be served from a snapshot.
+	void setSnapshotType(int i_type, const std::string &i_type_name);
+
+	/// Prepare whole list snapshot, if it was requested recently and nodes were changed.
+	/// Called by run thread once per cycle, container should be locked for reading.
+	void updateSnapshot();
+
+	/// Nodes were added, changed or deleted, snapshot should be prepared again.
+	/// Can be called by any thread, for example on render update that does not produce an event.
+	void setSnapshotDirty();
+
+	/// Generate whole nodes list message from snapshot, container lock is not needed.
+	/// If i_version is equal to JSON snapshot version, "not modified" JSON is returned.
+	/// Returns NULL if there is no snapshot, list should be generated from nodes.
+	af::Msg *generateSnapshot(bool i_json, int64_t i_version);
+
 	bool setZombie(int id);
 
 	/// Free zombie nodes memory.
@@ -64,6 +81,12 @@ public:
 	void ReadUnlock(void) { m_rw_lock.ReadUnlock(); }
 	void WriteUnlock(void) { m_rw_lock.WriteUnlock(); }
 
+	/// Collect lock wait and hold time, called by AfContainerLock on unlock.
+	void lockStat(bool i_write, int64_t i_wait_usec, int64_t i_hold_usec);
+
+	/// Write locks statistics collected since previous call and reset it.
+	void writeLockStat(std::ostringstream &o_str);
+
 	friend class AfContainerIt;
 	friend class AfContainerLock;
 	friend class AfList;
@@ -91,6 +114,34 @@ private:
 
 	DlRWLock m_rw_lock;
 
+	/// Lock statistics, times are in microseconds.
+	struct LockStat
+	{
+		int64_t count;
+		int64_t wait;
+		int64_t wait_max;
+		int64_t hold;
+		int64_t hold_max;
+	};
+	LockStat m_lock_stat_read;
+	LockStat m_lock_stat_write;
+	DlMutex m_lock_stat_mutex;
+
+	/// Whole nodes list snapshot, prepared by run thread.
+	struct Snapshot
+	{
+		bool valid;
+		bool dirty;           ///< Nodes changed since data generation started.
+		int64_t version;      ///< Starts from server start time, so it differs from the previous run versions.
+		int64_t request_time; ///< Last request time, milliseconds.
+		std::string data;
+	};
+	int m_snapshot_type;
+	std::string m_snapshot_type_name;
+	Snapshot m_snapshot_json;
+	Snapshot m_snapshot_bin;
+	DlMutex m_snapshot_mutex;
+
 	int m_count;			   ///< Number of nodes in container.
 	int m_capacity;			   ///< Container size ( maximun number of node can be stored).
 	AfNodeSrv *m_first_ptr;	///< Pointer to first node.
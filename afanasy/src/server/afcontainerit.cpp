@@ -14,6 +14,8 @@ AfContainerLock::AfContainerLock( AfContainer* afcontainer, LockType locktype):
 	m_container(afcontainer),
 	m_type(locktype)
 {
+	m_wait_start = af::getMonotonicUSec();
+
 	switch( m_type )
 	{
 		case READLOCK:
@@ -29,10 +31,14 @@ AfContainerLock::AfContainerLock( AfContainer* afcontainer, LockType locktype):
 		default:
 			AF_ERR << "invalid lock type.";
 	}
+
+	m_hold_start = af::getMonotonicUSec();
 }
 
 AfContainerLock::~AfContainerLock()
 {
+	int64_t now = af::getMonotonicUSec();
+
 	if( m_type == READLOCK )
 		m_container->ReadUnlock();
 	else
@@ -40,6 +46,8 @@ AfContainerLock::~AfContainerLock()
 		assert( m_type == WRITELOCK );
 		m_container->WriteUnlock();
 	}
+
+	m_container->lockStat( m_type == WRITELOCK, m_hold_start - m_wait_start, now - m_hold_start);
 }
 
 AfContainerIt::AfContainerIt( AfContainer* af_container, bool skip_zombies):
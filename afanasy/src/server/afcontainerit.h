@@ -6,7 +6,8 @@
 #include "afcontainer.h"
 
 /// Afanasy nodes container locker.
-/* Node is a base class of user, render and job */
+/* Node is a base class of user, render and job.
+   Lock wait and hold times are collected to container statistics. */
 
 class AfContainerLock
 {
@@ -24,6 +25,9 @@ public:
 private:
 	AfContainer* m_container;
 	int m_type;
+
+	int64_t m_wait_start;  ///< Lock request time, microseconds.
+	int64_t m_hold_start;  ///< Lock acquire time, microseconds.
 };
 
 /// Afanasy container nodes iterator.
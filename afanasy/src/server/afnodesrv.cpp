@@ -6,6 +6,7 @@
 
 #include "action.h"
 #include "afcommon.h"
+#include "storelog.h"
 #include "usercontainer.h"
 
 #define AFOUTPUT
@@ -75,15 +76,16 @@ bool AfNodeSrv::createStoreDir() const
 	}
 
 	// Try to remove previous (old node) folder:
-	if( af::pathIsFolder( m_store_dir))
+	if( false == AFCommon::removeStoreDir( m_store_dir))
 	{
-		if( false == af::removeDir( m_store_dir))
-		{
-			AFCommon::QueueLogError( std::string("Unable to remove old store folder:\n") + m_store_dir);
-			return false;
-		}
+		AFCommon::QueueLogError( std::string("Unable to remove old store folder:\n") + m_store_dir);
+		return false;
 	}
 
+	// Node files are written in the store log, folder is not needed:
+	if( StoreLog::Enabled())
+		return true;
+
 	// Make path (all needed folders):
 	if( af::pathMakePath( m_store_dir) == false)
 	{
@@ -173,6 +175,8 @@ void AfNodeSrv::action( Action & i_action)
 
 	v_action( i_action);
 
+	v_postAction( i_action);
+
 	if( i_action.log.size())
 	{
 		if( i_action.log[0] == '\n' )
@@ -187,6 +191,8 @@ void AfNodeSrv::action( Action & i_action)
 
 void AfNodeSrv::v_action( Action & i_action){}
 
+void AfNodeSrv::v_postAction( Action & i_action){}
+
 void AfNodeSrv::appendLog( const std::string & message)
 {
 	m_log.push_back( af::time2str() + " : " + message);
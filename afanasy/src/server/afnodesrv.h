@@ -28,6 +28,9 @@ public:
 
 	virtual void v_action( Action & i_action);
 
+	/// Called after action processed, node can update data depending on changed parameters.
+	virtual void v_postAction( Action & i_action);
+
 	/// Refresh node information
 	virtual void v_refresh( time_t currentTime, AfContainer * pointer, MonitorContainer * monitoring);
 
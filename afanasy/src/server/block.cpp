@@ -23,7 +23,8 @@ Block::Block( JobAf * blockJob, af::BlockData * blockData, af::JobProgress * pro
    m_tasks( NULL),
    m_user( NULL),
    m_jobprogress( progress),
-   m_initialized( false)
+   m_initialized( false),
+   m_refresh_all( true)
 {
    if (!allocateTasks())
       return;
@@ -49,7 +50,7 @@ bool Block::storeTasks()
 	m_data->jsonWriteTasks( str);
 	str << "\n}";
 
-	return AFCommon::writeFile( str, getStoreTasksFileName());
+	return AFCommon::writeStoreFile( str.str(), getStoreTasksFileName());
 }
 
 bool Block::readStoredTasks()
@@ -57,7 +58,7 @@ bool Block::readStoredTasks()
 	if( m_data->isNumeric()) return true;
 
 	int size;
-	char * data = af::fileRead( getStoreTasksFileName(), &size);
+	char * data = AFCommon::readStoreFile( getStoreTasksFileName(), &size);
 	if( data == NULL ) return false;
 
 	rapidjson::Document document;
@@ -338,11 +339,32 @@ bool Block::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCon
    }
 
    // refresh tasks
-   for( int t = 0; t < m_data->getTasksNum(); t++)
+   std::vector<int> refresh_tasks;
+   refresh_tasks.swap( m_refresh_tasks);
+   bool refresh_all = m_refresh_all;
+   if( refresh_all )
    {
+      m_refresh_all = false;
+      refresh_tasks.clear();
+      for( int t = 0; t < m_data->getTasksNum(); t++)
+      {
+         m_tasks[t]->m_refresh = true;
+         refresh_tasks.push_back( t);
+      }
+   }
+
+   for( int i = 0; i < refresh_tasks.size(); i++)
+   {
+      int t = refresh_tasks[i];
       int errorHostId = -1;
 	  m_tasks[t]->v_refresh( currentTime, renders, monitoring, errorHostId);
       if( errorHostId != -1 ) v_errorHostsAppend( t, errorHostId, renders);
+
+      // Keep task to refresh it next time, if it still needs it:
+      if( m_tasks[t]->isRefreshNeeded())
+         m_refresh_tasks.push_back( t);
+      else
+         m_tasks[t]->m_refresh = false;
    }
 
    // For block progress monitoring in jobs list and in tasks list
@@ -401,12 +423,24 @@ bool Block::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCon
 			if (checkTasksDependStatus(monitoring))
 				blockProgress_changed = true;
 
-		// Update block tasks progress and status
-		if (m_data->updateProgress(m_jobprogress))
-			blockProgress_changed = true;
+		if (refresh_all)
+		{
+			// Update block tasks progress and status
+			if (m_data->updateProgress(m_jobprogress))
+				blockProgress_changed = true;
 
-		// Update progress bars for GUIs:
-		m_data->updateBars(m_jobprogress);
+			// Update progress bars for GUIs:
+			m_data->updateBars(m_jobprogress);
+		}
+		else
+		{
+			// Tasks progress can be changed only in refreshed tasks and by depends,
+			// block progress, state and bars are updated by their changes:
+			refresh_tasks.insert( refresh_tasks.end(), m_changed_tasks.begin(), m_changed_tasks.end());
+			if (m_data->updateTasksProgress(m_jobprogress, refresh_tasks))
+				blockProgress_changed = true;
+		}
+		m_changed_tasks.clear();
 	}
 
 	if (old_block_state != m_data->getState())
@@ -419,6 +453,15 @@ bool Block::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCon
    return blockProgress_changed;
 }
 
+void Block::addRefreshTask( int i_task)
+{
+	if( m_tasks[i_task]->m_refresh )
+		return;
+
+	m_tasks[i_task]->m_refresh = true;
+	m_refresh_tasks.push_back( i_task);
+}
+
 bool Block::checkBlockDependStatus(MonitorContainer * i_monitoring)
 {
 	bool was_depend = m_data->getState() & AFJOB::STATE_WAITDEP_MASK;
@@ -442,7 +485,8 @@ bool Block::checkBlockDependStatus(MonitorContainer * i_monitoring)
 		{
 			// If the block just stop to depend, its status should be recalculated.
 			// Or it will loose depend state and will not get ready state evet if it has ready tasks.
-			m_data->updateProgress(m_jobprogress);
+			// Tasks are already counted on block refresh, only state is updated.
+			m_data->updateTasksProgress(m_jobprogress, std::vector<int>());
 		}
 
 		if( i_monitoring )
@@ -473,6 +517,7 @@ bool Block::resetTasksDependStatus(MonitorContainer * i_monitoring)
 
 		m_jobprogress->tp[m_data->getBlockNum()][task]->state = state;
 		m_tasks[task]->v_monitor(i_monitoring);
+		m_changed_tasks.push_back(task);
 		some_task_state_changed = true;
 	}
 
@@ -545,6 +590,7 @@ bool Block::checkTasksDependStatus(MonitorContainer * i_monitoring)
 		{
 			m_jobprogress->tp[m_data->getBlockNum()][task]->state = state;
 			m_tasks[task]->v_monitor(i_monitoring);
+			m_changed_tasks.push_back(task);
 			some_task_state_changed = true;
 		}
 	}
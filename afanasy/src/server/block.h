@@ -53,8 +53,17 @@ public:
 	void reconnectTask( af::TaskExec * i_taskexec, RenderAf & i_render, MonitorContainer * i_monitoring);
 
 	/// Refresh block. Retrun true if block progress changed, needed for jobs monitoring (watch jobs list).
+	/// Only tasks that need refresh (running, with errors to retry or waiting) are refreshed,
+	/// block tasks progress is updated by refreshed and depend changed tasks only.
 	virtual bool v_refresh( time_t currentTime, RenderContainer * renders, MonitorContainer * monitoring);
 
+	/// Task started or changed, so it needs refresh.
+	void addRefreshTask( int i_task);
+
+	/// Refresh all tasks and recalculate progress on the next refresh.
+	/// Needed on job actions, as they can change any task or block parameter.
+	inline void setRefreshAll() { m_refresh_all = true; }
+
 	bool checkBlockDependStatus(MonitorContainer * i_monitoring);
 	bool checkTasksDependStatus(MonitorContainer * i_monitoring);
 	void constructDependTasks();
@@ -91,6 +100,10 @@ private:
 	std::list<int> m_dependTasksBlocks;
 	bool m_initialized;             ///< Where the block was successfully  initialized.
 
+	std::vector<int> m_refresh_tasks; ///< Tasks to refresh, all others are idle (ready, done, waiting depends).
+	std::vector<int> m_changed_tasks; ///< Tasks changed not by refresh (depends), to update block progress.
+	bool m_refresh_all;               ///< Refresh all tasks, not only stored ones.
+
 private:
 	/// Allocate, or reallocate when appending tasks, Task objects.
 	/// When reallocating, one must provide the number of alread allocated tasks
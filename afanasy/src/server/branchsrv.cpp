@@ -50,7 +50,7 @@ BranchSrv::BranchSrv(const std::string & i_store_dir):
 	AfNodeSolve(this, i_store_dir)
 {
 	int size;
-	char * data = af::fileRead(getStoreFile(), &size);
+	char * data = AFCommon::readStoreFile(getStoreFile(), &size);
 	if (data == NULL) return;
 
 	rapidjson::Document document;
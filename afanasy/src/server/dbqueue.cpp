@@ -1,7 +1,15 @@
 #include "dbqueue.h"
 
+#include <stdio.h>
+#ifdef WINNT
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "../include/afanasy.h"
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/environment.h"
 
 #include "../libafsql/dbconnection.h"
@@ -15,13 +23,93 @@ extern bool AFRunning;
 #define AFOUTPUT
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+/*
+	Journal is a sequence of records, one record for each queries item:
+	int32 queries count, and int32 length and data for each query.
+	A broken record at the journal end means that server was stopped while writing,
+	journal is truncated there on start.
+*/
+namespace
+{
+const int32_t JournalQueriesMax = 1 << 20;
+const int32_t JournalQueryMax = 1 << 30;
+// Journal tail is copied by buffers of this size:
+const int JournalBufferSize = 1 << 20;
+
+void journalRecord( const Queries * i_queries, std::string & o_record)
+{
+	int32_t count = i_queries->size();
+	o_record.append((const char*)&count, 4);
+	for( Queries::const_iterator it = i_queries->begin(); it != i_queries->end(); it++)
+	{
+		int32_t length = (*it).size();
+		o_record.append((const char*)&length, 4);
+		o_record.append( *it);
+	}
+}
+
+bool journalRead( FILE * i_file, Queries * o_queries, int64_t & o_size)
+{
+	int32_t count;
+	if( fread( &count, 4, 1, i_file) != 1 ) return false;
+	if(( count < 0 ) || ( count > JournalQueriesMax )) return false;
+	o_size = 4;
+
+	for( int32_t i = 0; i < count; i++)
+	{
+		int32_t length;
+		if( fread( &length, 4, 1, i_file) != 1 ) return false;
+		if(( length < 0 ) || ( length > JournalQueryMax )) return false;
+
+		o_queries->push_back( std::string());
+		std::string & query = o_queries->back();
+		query.resize( length);
+		if( length && ( fread( &query[0], length, 1, i_file) != 1 )) return false;
+
+		o_size += 4 + length;
+	}
+
+	return true;
+}
+
+bool truncateFile( FILE * i_file, int64_t i_size)
+{
+#ifdef WINNT
+	return _chsize_s( _fileno( i_file), i_size) == 0;
+#else
+	return ftruncate( fileno( i_file), i_size) == 0;
+#endif
+}
+}
 
 DBQueue::DBQueue( const std::string & i_name, MonitorContainer * i_monitorcontainer):
 	af::AfQueue( i_name, af::AfQueue::e_start_thread),
 	m_monitors( i_monitorcontainer),
 	m_working( false),
-	m_conn( NULL)
+	m_conn( NULL),
+	m_batch_rows( 0),
+	m_batch_time( 0),
+	m_stat_rows( 0),
+	m_stat_batches( 0),
+	m_stat_bytes( 0),
+	m_stat_retried( 0),
+	m_journal_write( NULL),
+	m_journal_read( NULL),
+	m_journal_written( 0),
+	m_journal_replayed( 0),
+	m_journal_records( 0),
+	m_replay_queued( false),
+	m_replay_queries( NULL),
+	m_queue_bytes( 0),
+	m_connected( false),
+	m_stat_spilled( 0),
+	m_stat_replayed( 0),
+	m_stat_dropped( 0)
 {
+	m_journal_file = af::Environment::getStoreFolder() + AFGENERAL::PATH_SEPARATOR + AFDATABASE::JOURNAL_FILE;
+
 	if( false == afsql::DBConnection::enabled() )
 		return;
 
@@ -35,11 +123,100 @@ DBQueue::DBQueue( const std::string & i_name, MonitorContainer * i_monitorcontai
 	{
 		connectionEstablished();
 		m_working = true;
+		openJournal();
 	}
 }
 
 DBQueue::~DBQueue()
 {
+	if( m_working )
+	{
+		// Queue thread can write an item or read journal, it is stopped before journal rewrite:
+		stopThread();
+
+		DlScopeLocker batch_lock( &m_batch_mutex);
+		DlScopeLocker spill_lock( &m_spill_mutex);
+
+		// Queued queries are older than journal ones, except collected rows.
+		// If there are such queries, or journal is partly replayed, it is rewritten.
+		std::list<Queries*> queued;
+		while( af::AfQueueItem * item = pop( af::AfQueue::e_no_wait))
+		{
+			Queries * queries = (Queries*)item;
+			if( queries->isReplay())
+				delete queries;
+			else
+				queued.push_back( queries);
+		}
+
+		if( queued.size() || m_replay_queries || m_journal_replayed )
+		{
+			std::string filetemp = m_journal_file + ".tmp";
+			FILE * file = fopen( filetemp.c_str(), "wb");
+			bool ok = ( file != NULL );
+
+			std::string record;
+			for( std::list<Queries*>::iterator it = queued.begin(); it != queued.end(); it++)
+				journalRecord( *it, record);
+			if( m_replay_queries )
+				journalRecord( m_replay_queries, record);
+			if( ok && record.size())
+				ok = ( fwrite( record.data(), record.size(), 1, file) == 1 );
+
+			if( ok && ( m_journal_written > m_journal_replayed ))
+			{
+				if( NULL == m_journal_read )
+					m_journal_read = fopen( m_journal_file.c_str(), "rb");
+				ok = ( m_journal_read != NULL );
+
+				std::vector<char> buffer( JournalBufferSize);
+				size_t bytes;
+				while( ok && (( bytes = fread( &buffer[0], 1, buffer.size(), m_journal_read)) > 0 ))
+					ok = ( fwrite( &buffer[0], bytes, 1, file) == 1 );
+			}
+
+			if( file && ( fclose( file) != 0 ))
+				ok = false;
+
+			if( ok )
+			{
+				if( m_journal_write ) fclose( m_journal_write);
+				if( m_journal_read  ) fclose( m_journal_read);
+				m_journal_write = NULL;
+				m_journal_read = NULL;
+#ifdef WINNT
+				if( af::pathFileExists( m_journal_file)) remove( m_journal_file.c_str());
+#endif
+				ok = ( rename( filetemp.c_str(), m_journal_file.c_str()) == 0 );
+			}
+
+			if( ok )
+				AF_LOG << "Statistics database queries spilled to journal on exit: " << queued.size();
+			else
+				AF_ERR << "Unable to rewrite statistics database journal: " << filetemp;
+		}
+
+		for( std::list<Queries*>::iterator it = queued.begin(); it != queued.end(); it++)
+			delete *it;
+		if( m_replay_queries )
+			delete m_replay_queries;
+
+		// Collected rows are the newest:
+		if( m_batch_rows )
+		{
+			Queries * queries = new Queries();
+			if( m_tasks_values.size())
+				queries->push_back( m_dbtask.dbInsertPrefix() + m_tasks_values + ";");
+			if( m_jobs_values.size())
+				queries->push_back( m_dbjob.dbInsertPrefix() + m_jobs_values + ";");
+			spill( queries);
+			delete queries;
+		}
+
+		if( m_journal_write ) fclose( m_journal_write);
+		if( m_journal_read  ) fclose( m_journal_read);
+	}
+
 	if( m_conn )
 	{
 		PQfinish( m_conn);
@@ -49,11 +226,21 @@ DBQueue::~DBQueue()
 void DBQueue::connectionEstablished()
 {
 	AFINFA("DBQueue::connectionEstablished: %s", name.c_str())
+
+	m_connected = true;
+
+	DlScopeLocker lock( &m_spill_mutex);
+	if( m_journal_written > m_journal_replayed )
+		AF_LOG << "Statistics database journal to replay: " << m_journal_records << " records ("
+			<< (( m_journal_written - m_journal_replayed ) >> 10 ) << " KB)";
 }
 
 void DBQueue::processItem( af::AfQueueItem* item)
 {
 //printf("DBQueue::processItem: %s:\n", name.c_str());
+	Queries * queries = (Queries*)item;
+	int64_t bytes = queries->bytes();
+
 	if( false == m_working )
 	{
 		delete item;
@@ -61,6 +248,7 @@ void DBQueue::processItem( af::AfQueueItem* item)
 	}
 	if( PQstatus( m_conn) != CONNECTION_OK)
 	{
+		m_connected = false;
 		if( m_conn != NULL )
 		{
 			PQfinish( m_conn);
@@ -70,7 +258,8 @@ void DBQueue::processItem( af::AfQueueItem* item)
 		{
 			if( false == AFRunning )
 			{
-				delete item;
+				// Item will be spilled to journal on exit:
+				push( item, true);
 				return;
 			}
 			m_conn = PQconnectdb( af::Environment::get_DB_ConnInfo().c_str());
@@ -86,28 +275,40 @@ void DBQueue::processItem( af::AfQueueItem* item)
 				m_conn = NULL;
 			}
 			sendAlarm();
-			af::sleep_sec( AFDATABASE::RECONNECTAFTER);
+			// Sleep by seconds to not delay server exit:
+			for( int s = 0; AFRunning && ( s < AFDATABASE::RECONNECTAFTER); s++)
+				af::sleep_sec( 1);
 		}
 	}
 
-	// Writing an item and check if error:
-	if( false == writeItem( item))
+	// All queued queries before replay item are written, journal can be replayed:
+	if( queries->isReplay())
 	{
-		// Check if database has just closed:
-		if( PQstatus( m_conn) != CONNECTION_OK)
+		if( replayJournal())
 		{
-			if( m_conn != NULL )
-			{
-				PQfinish( m_conn);
-				m_conn = NULL;
-			}
-			// Push item back to queue front to try it to write again next time:
-			push( item, true );
-			AFINFA("%s: Item pushed back to queue front.", name.c_str())
+			delete item;
 			return;
 		}
 	}
-	delete item;
+	// Writing an item and check if error:
+	else if( writeItem( item) || ( PQstatus( m_conn) == CONNECTION_OK))
+	{
+		DlScopeLocker lock( &m_spill_mutex);
+		m_queue_bytes -= bytes;
+		delete item;
+		return;
+	}
+
+	// Database has just closed:
+	m_connected = false;
+	if( m_conn != NULL )
+	{
+		PQfinish( m_conn);
+		m_conn = NULL;
+	}
+	// Push item back to queue front to try it to write again next time:
+	push( item, true );
+	AFINFA("%s: Item pushed back to queue front.", name.c_str())
 }
 
 bool DBQueue::writeItem( af::AfQueueItem* item)
@@ -118,7 +319,204 @@ bool DBQueue::writeItem( af::AfQueueItem* item)
 	int size = queries->size();
 	if( size < 1) return true;
 
-	return afsql::execute( m_conn, queries);
+	if( afsql::execute( m_conn, queries))
+		return true;
+
+	// One bad row fails all batch, other rows are inserted one by one:
+	if(( false == queries->hasRows()) || ( PQstatus( m_conn) != CONNECTION_OK ))
+		return false;
+
+	std::list<std::string> rows;
+	queries->getRows( rows);
+	{
+		DlScopeLocker lock( &m_batch_mutex);
+		m_stat_retried++;
+	}
+
+	return afsql::execute( m_conn, &rows);
+}
+
+bool DBQueue::replayJournal()
+{
+	while( AFRunning )
+	{
+		Queries * queries = m_replay_queries;
+		m_replay_queries = NULL;
+
+		if( NULL == queries )
+		{
+			DlScopeLocker lock( &m_spill_mutex);
+			if( m_journal_replayed >= m_journal_written )
+			{
+				if( m_journal_records )
+					AF_LOG << "Statistics database journal replayed: " << m_journal_records << " records ("
+						<< ( m_journal_written >> 10 ) << " KB)";
+
+				if( m_journal_write ) fclose( m_journal_write);
+				if( m_journal_read  ) fclose( m_journal_read);
+				m_journal_write = NULL;
+				m_journal_read = NULL;
+				remove( m_journal_file.c_str());
+
+				m_journal_written = 0;
+				m_journal_replayed = 0;
+				m_journal_records = 0;
+				m_replay_queued = false;
+				return true;
+			}
+		}
+
+		if( NULL == queries )
+			queries = readJournal();
+
+		if( NULL == queries )
+		{
+			// Journal can't be read, it is dropped to not block new queries forever:
+			DlScopeLocker lock( &m_spill_mutex);
+			AF_ERR << "Unable to read statistics database journal: " << m_journal_file
+				<< ", dropping " << (( m_journal_written - m_journal_replayed ) >> 10 ) << " KB.";
+			m_stat_dropped += m_journal_written - m_journal_replayed;
+			m_journal_replayed = m_journal_written;
+			continue;
+		}
+
+		if(( false == writeItem( queries)) && ( PQstatus( m_conn) != CONNECTION_OK))
+		{
+			m_replay_queries = queries;
+			return false;
+		}
+
+		delete queries;
+	}
+
+	return true;
+}
+
+Queries * DBQueue::readJournal()
+{
+	if( NULL == m_journal_read )
+		m_journal_read = fopen( m_journal_file.c_str(), "rb");
+	if( NULL == m_journal_read )
+		return NULL;
+
+	// Journal is appended by an other stream, records are flushed before they are counted:
+	clearerr( m_journal_read);
+
+	Queries * queries = new Queries();
+	int64_t size = 0;
+	if( false == journalRead( m_journal_read, queries, size))
+	{
+		delete queries;
+		return NULL;
+	}
+
+	DlScopeLocker lock( &m_spill_mutex);
+	m_journal_replayed += size;
+	m_stat_replayed += size;
+
+	return queries;
+}
+
+void DBQueue::openJournal()
+{
+	FILE * file = fopen( m_journal_file.c_str(), "r+b");
+	if( NULL == file )
+		return;
+
+	Queries queries;
+	int64_t size = 0;
+	int64_t valid = 0;
+	int64_t records = 0;
+	while( journalRead( file, &queries, size))
+	{
+		valid += size;
+		records++;
+		queries.clear();
+	}
+
+	bool broken = ( false == feof( file));
+	if( false == broken )
+	{
+		// Check that the last record is not partly written:
+		clearerr( file);
+		broken = ( fseek( file, 0, SEEK_END) != 0 ) || ( ftell( file) != valid );
+	}
+	if( broken )
+	{
+		AF_WARN << "Statistics database journal is truncated to " << records << " records: " << m_journal_file;
+		if( false == truncateFile( file, valid))
+			AF_ERR << "Unable to truncate statistics database journal: " << m_journal_file;
+	}
+
+	fclose( file);
+
+	if( valid == 0 )
+	{
+		remove( m_journal_file.c_str());
+		return;
+	}
+
+	DlScopeLocker lock( &m_spill_mutex);
+	m_journal_written = valid;
+	m_journal_records = records;
+	m_replay_queued = true;
+	push( new Queries( true));
+}
+
+bool DBQueue::spill( const Queries * i_queries)
+{
+	if( NULL == m_journal_write )
+	{
+		m_journal_write = fopen( m_journal_file.c_str(), "ab");
+		if( NULL == m_journal_write )
+		{
+			AF_ERR << "Unable to open statistics database journal: " << m_journal_file;
+			return false;
+		}
+	}
+
+	std::string record;
+	journalRecord( i_queries, record);
+
+	if(( fwrite( record.data(), record.size(), 1, m_journal_write) != 1 ) || ( fflush( m_journal_write) != 0 ))
+	{
+		AF_ERR << "Unable to write statistics database journal: " << m_journal_file;
+		return false;
+	}
+
+	m_journal_written += record.size();
+	m_journal_records++;
+	m_stat_spilled += record.size();
+
+	return true;
+}
+
+void DBQueue::pushQueries( Queries * i_queries)
+{
+	int64_t bytes = i_queries->bytes();
+
+	DlScopeLocker lock( &m_spill_mutex);
+
+	if(( m_journal_written == 0 ) &&
+		( m_queue_bytes + bytes <= 1024 * int64_t( af::Environment::get_DB_QueueKB())))
+	{
+		m_queue_bytes += bytes;
+		push( i_queries);
+		return;
+	}
+
+	if( spill( i_queries))
+	{
+		if( false == m_replay_queued )
+		{
+			push( new Queries( true));
+			m_replay_queued = true;
+		}
+	}
+	else
+		m_stat_dropped += bytes;
+
+	delete i_queries;
 }
 
 void DBQueue::addItem( const afsql::DBItem * item)
@@ -127,7 +525,7 @@ void DBQueue::addItem( const afsql::DBItem * item)
 
 	Queries * queries = new Queries();
 	item->v_dbInsert( queries);
-	push( queries);
+	pushQueries( queries);
 }
 
 void DBQueue::updateItem( const afsql::DBItem * item, int attr)
@@ -136,7 +534,7 @@ void DBQueue::updateItem( const afsql::DBItem * item, int attr)
 
 	Queries * queries = new Queries();
 	item->v_dbUpdate( queries, attr);
-	push( queries);
+	pushQueries( queries);
 }
 
 void DBQueue::delItem( const afsql::DBItem * item)
@@ -145,7 +543,7 @@ void DBQueue::delItem( const afsql::DBItem * item)
 
 	Queries * queries = new Queries();
 	item->v_dbDelete( queries);
-	push( queries);
+	pushQueries( queries);
 }
 
 void DBQueue::addJob( const af::Job * i_job)
@@ -153,10 +551,23 @@ void DBQueue::addJob( const af::Job * i_job)
 //printf("DBQueue::addJob: (working=%d)\n", m_working);
 	if( false == m_working ) return;
 
-	Queries * queries = new Queries();
-	m_dbjob.add( i_job, queries);
-	push( queries);
-//queries->stdOut();
+	DlScopeLocker lock( &m_batch_mutex);
+
+	int pos = m_jobs_values.size();
+	int rows = m_dbjob.add( i_job, m_jobs_values);
+	if( rows == 0 )
+		return;
+
+	// Job blocks rows are retried together, values are separated by ",\n":
+	if( pos ) pos += 2;
+	m_jobs_rows.push_back( std::pair<int,int>( pos, int( m_jobs_values.size()) - pos));
+
+	if( m_batch_rows == 0 )
+		m_batch_time = af::getMonotonicMSec();
+	m_batch_rows += rows;
+
+	if( m_batch_rows >= af::Environment::get_DB_BatchRows())
+		pushBatch();
 }
 
 void DBQueue::addTask(
@@ -168,17 +579,137 @@ void DBQueue::addTask(
 //printf("DBQueue::addTask: (working=%d)\n", m_working);
 	if( false == m_working ) return;
 
+	DlScopeLocker lock( &m_batch_mutex);
+
+	int pos = m_tasks_values.size();
+	if( false == m_dbtask.add( i_exec, i_progress, i_job, i_render, m_tasks_values))
+		return;
+
+	if( pos ) pos += 2;
+	m_tasks_rows.push_back( std::pair<int,int>( pos, int( m_tasks_values.size()) - pos));
+
+	if( m_batch_rows == 0 )
+		m_batch_time = af::getMonotonicMSec();
+	m_batch_rows++;
+
+	if( m_batch_rows >= af::Environment::get_DB_BatchRows())
+		pushBatch();
+}
+
+void DBQueue::flush()
+{
+	if( false == m_working ) return;
+
+	DlScopeLocker lock( &m_batch_mutex);
+
+	if( m_batch_rows == 0 )
+		return;
+
+	if(( af::getMonotonicMSec() - m_batch_time >= 1000 * int64_t( af::Environment::get_DB_BatchSec())))
+		pushBatch();
+}
+
+void DBQueue::pushBatch()
+{
+	// Both inserts are executed by one command, so they are in one transaction:
 	Queries * queries = new Queries();
-	m_dbtask.add( i_exec, i_progress, i_job, i_render, queries);
-	push( queries);
+	std::string query;
+	if( m_tasks_values.size())
+		batchInsert( m_dbtask.dbInsertPrefix(), m_tasks_values, m_tasks_rows, query, queries);
+	if( m_jobs_values.size())
+		batchInsert( m_dbjob.dbInsertPrefix(), m_jobs_values, m_jobs_rows, query, queries);
+
+	queries->push_front( query);
+	pushQueries( queries);
+
+	m_stat_rows += m_batch_rows;
+	m_stat_batches++;
+	m_stat_bytes += query.size();
+
+	m_tasks_values.clear();
+	m_jobs_values.clear();
+	m_tasks_rows.clear();
+	m_jobs_rows.clear();
+	m_batch_rows = 0;
+}
+
+void DBQueue::batchInsert( const std::string & i_prefix, const std::string & i_values,
+	const std::vector<std::pair<int,int> > & i_rows, std::string & o_query, Queries * o_queries)
+{
+	int prefix_pos = o_query.size();
+	int values_pos = prefix_pos + i_prefix.size();
+
+	o_query += i_prefix + i_values + ";";
+
+	for( std::vector<std::pair<int,int> >::const_iterator it = i_rows.begin(); it != i_rows.end(); it++)
+		o_queries->addRow( prefix_pos, i_prefix.size(), values_pos + (*it).first, (*it).second);
+}
+
+void DBQueue::writeStat( std::ostringstream & o_str)
+{
+	if( false == m_working ) return;
+
+	DlScopeLocker lock( &m_batch_mutex);
+
+	o_str << "\nStatistics database: rows " << m_stat_rows << " in " << m_stat_batches << " batches";
+	o_str << " (" << ( m_stat_bytes >> 10 ) << " KB)";
+	o_str << ", collecting " << m_batch_rows << ", queue " << getCount();
+
+	DlScopeLocker spill_lock( &m_spill_mutex);
+
+	o_str << " (" << ( m_queue_bytes >> 10 ) << " KB)";
+	if( m_stat_retried )
+		o_str << ", batches retried by rows " << m_stat_retried;
+	if( false == m_connected )
+		o_str << ", DISCONNECTED";
+	if( m_journal_written || m_stat_spilled || m_stat_replayed )
+	{
+		o_str << "\n   Journal: " << (( m_journal_written - m_journal_replayed ) >> 10 ) << " KB";
+		o_str << ", spilled " << ( m_stat_spilled >> 10 ) << " KB";
+		o_str << ", replayed " << ( m_stat_replayed >> 10 ) << " KB";
+	}
+	if( m_stat_dropped )
+		o_str << "\n   Dropped: " << ( m_stat_dropped >> 10 ) << " KB";
+
+	m_stat_rows = 0;
+	m_stat_batches = 0;
+	m_stat_bytes = 0;
+	m_stat_retried = 0;
+	m_stat_spilled = 0;
+	m_stat_replayed = 0;
+	m_stat_dropped = 0;
+}
+
+void DBQueue::jsonWrite( std::ostringstream & o_str)
+{
+	DlScopeLocker batch_lock( &m_batch_mutex);
+	DlScopeLocker spill_lock( &m_spill_mutex);
+
+	o_str << "{\"database\":{";
+	o_str << "\"working\":" << ( m_working ? "true" : "false");
+	o_str << ",\"connected\":" << ( m_working && m_connected ? "true" : "false");
+	o_str << ",\"collecting_rows\":" << m_batch_rows;
+	o_str << ",\"queue_count\":" << getCount();
+	o_str << ",\"queue_bytes\":" << m_queue_bytes;
+	o_str << ",\"queue_bytes_max\":" << 1024 * int64_t( af::Environment::get_DB_QueueKB());
+	o_str << ",\"journal_records\":" << m_journal_records;
+	o_str << ",\"spilled_bytes\":" << m_journal_written;
+	o_str << ",\"replayed_bytes\":" << m_journal_replayed;
+	o_str << "}}";
 }
 
 void DBQueue::sendAlarm()
 {
-	std::string str("ALARM! Server statistics database connection error. Contact your system administrator.");
-	AFCommon::QueueLog( name + ":\n" + str);
+	std::ostringstream str;
+	str << "ALARM! Server statistics database connection error. Contact your system administrator.";
+	{
+		DlScopeLocker lock( &m_spill_mutex);
+		str << "\nQueue: " << getCount() << " (" << ( m_queue_bytes >> 10 ) << " KB)";
+		str << ", spilled to journal: " << (( m_journal_written - m_journal_replayed ) >> 10 ) << " KB";
+	}
+	AFCommon::QueueLog( name + ":\n" + str.str());
 	AfContainerLock mLock( m_monitors, AfContainerLock::WRITELOCK);
-	m_monitors->announce( str);
+	m_monitors->announce( str.str());
 }
 
 void DBQueue::sendConnected()
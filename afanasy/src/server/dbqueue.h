@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../libafanasy/afqueue.h"
+#include "../libafanasy/common/dlMutex.h"
 
 #include "../libafsql/dbjob.h"
 #include "../libafsql/dbtask.h"
@@ -11,6 +12,18 @@ class MonitorContainer;
 class Queries: public std::list<std::string>, public af::AfQueueItem
 {
 public:
+	/// Replay item is queued after queries spilled to journal, it has no queries itself.
+	inline Queries( bool i_replay = false): m_replay( i_replay) {}
+
+	inline bool isReplay() const { return m_replay; }
+
+	inline int64_t bytes() const
+	{
+		int64_t size = 0;
+		for( const_iterator it = begin(); it != end(); it++) size += (*it).size();
+		return size;
+	}
+
 	inline void stdOut() const
 	{
 		if( size())
@@ -18,9 +31,50 @@ public:
 		else
 			printf("Queries::stdOut: Zero size.\n");
 	}
+
+	/// Batch row values and its table insert prefix positions in the first query.
+	/// Rows are not journaled, a replayed batch can't be retried row by row.
+	inline void addRow( int i_prefix_pos, int i_prefix_len, int i_values_pos, int i_values_len)
+	{
+		Row row = { i_prefix_pos, i_prefix_len, i_values_pos, i_values_len};
+		m_rows.push_back( row);
+	}
+
+	inline bool hasRows() const { return m_rows.size() > 0; }
+
+	/// Single row inserts of a batch.
+	inline void getRows( std::list<std::string> & o_queries) const
+	{
+		const std::string & query = front();
+		for( std::vector<Row>::const_iterator it = m_rows.begin(); it != m_rows.end(); it++)
+			o_queries.push_back( query.substr( (*it).prefix_pos, (*it).prefix_len)
+				+ query.substr( (*it).values_pos, (*it).values_len) + ";");
+	}
+
+private:
+	struct Row
+	{
+		int prefix_pos;
+		int prefix_len;
+		int values_pos;
+		int values_len;
+	};
+
+private:
+	bool m_replay;
+	std::vector<Row> m_rows;
 };
 
-/// Simple FIFO database action queue
+/// Simple FIFO database action queue.
+/** Tasks and jobs statistics rows are not queued one by one,
+*** they are collected in multi-row inserts, that are queued as one item
+*** when batch size is reached or the first row waits too long.
+*** Queue size is limited by af_db_queue_kb, while database is unreachable
+*** next queries are appended to a journal file in store folder.
+*** Journal is replayed after connection is established and older queued queries are written,
+*** queries are appended to journal during replay too, so queries order is kept.
+*** Queued queries are spilled to journal on exit, journal is replayed on next start.
+**/
 class DBQueue : public af::AfQueue
 {
 public:
@@ -40,6 +94,16 @@ public:
 		const af::Job * i_job,
 		const af::Render * i_render);
 
+	/// Queue collected statistics rows, if they are waiting too long.
+	/// Called periodically by run thread, rows left on exit are spilled to journal.
+	void flush();
+
+	/// Write statistics since the previous call.
+	void writeStat( std::ostringstream & o_str);
+
+	/// Write queue and journal state for monitors.
+	void jsonWrite( std::ostringstream & o_str);
+
 protected:
 
 	/// Called from run thead to process item just poped from queue
@@ -57,11 +121,63 @@ private:
 	void sendAlarm();
 	void sendConnected();
 
+	/// Queue collected rows, batch mutex should be locked.
+	void pushBatch();
+
+	/// Append table multi-row insert to batch query, store rows positions.
+	void batchInsert( const std::string & i_prefix, const std::string & i_values,
+		const std::vector<std::pair<int,int> > & i_rows, std::string & o_query, Queries * o_queries);
+
+	/// Queue queries or spill them to journal, if queue is full or journal is not replayed yet.
+	void pushQueries( Queries * i_queries);
+
+	/// Append queries to journal, spill mutex should be locked.
+	bool spill( const Queries * i_queries);
+
+	/// Open journal left from the previous run, truncate a broken record at its end.
+	void openJournal();
+
+	/// Write journal queries to database.
+	/// Returns false if connection is lost, replay should be continued later.
+	bool replayJournal();
+
+	/// Read the next journal record.
+	Queries * readJournal();
+
 private:
 	MonitorContainer * m_monitors;
 	bool m_working;
 
 	afsql::DBJob m_dbjob;
 	afsql::DBTask m_dbtask;
+
+	DlMutex m_batch_mutex;
+	std::string m_jobs_values;
+	std::string m_tasks_values;
+	std::vector<std::pair<int,int> > m_jobs_rows; ///< Rows positions in values, to retry a failed batch.
+	std::vector<std::pair<int,int> > m_tasks_rows;
+	int m_batch_rows;
+	int64_t m_batch_time;
+
+	int64_t m_stat_rows;
+	int64_t m_stat_batches;
+	int64_t m_stat_bytes;
+	int64_t m_stat_retried;
+
+	DlMutex m_spill_mutex;
+	std::string m_journal_file;
+	FILE * m_journal_write;
+	FILE * m_journal_read;
+	int64_t m_journal_written; ///< Journal size, bytes appended since it was empty.
+	int64_t m_journal_replayed;
+	int64_t m_journal_records;
+	bool m_replay_queued;
+	Queries * m_replay_queries; ///< Journal queries that failed to write on connection lost.
+	int64_t m_queue_bytes;
+	bool m_connected;
+
+	int64_t m_stat_spilled;
+	int64_t m_stat_replayed;
+	int64_t m_stat_dropped;
 };
 
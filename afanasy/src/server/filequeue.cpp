@@ -1,16 +1,28 @@
 #include "filequeue.h"
 
+#include <string.h>
+
+#include "../include/afanasy.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
+
 #include "afcommon.h"
 #include "afnodesrv.h"
+#include "storelog.h"
 
 #define AFOUTPUT
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
 
+extern bool AFRunning;
+
 FileData::FileData( const std::ostringstream & i_str, const std::string & i_file_name, const std::string & i_folder_name):
 	m_file_name( i_file_name),
 	m_folder_name( i_folder_name),
-	m_data( NULL)
+	m_append( false),
+	m_data( NULL),
+	m_push_time( 0)
 {
 	m_str = i_str.str();
 	m_length = m_str.size();
@@ -20,7 +32,9 @@ FileData::FileData( const char * i_data, int i_length, const std::string & i_fil
 	m_file_name( i_file_name),
 	m_folder_name( i_folder_name),
 	m_length( i_length),
-	m_data( NULL)
+	m_append( false),
+	m_data( NULL),
+	m_push_time( 0)
 {
 	AFINFA("FileData::FileData: \"%s\" %d bytes R(%d).", m_file_name.c_str(), m_length)
 
@@ -59,7 +73,9 @@ FileData::FileData( const char * i_data, int i_length, const std::string & i_fil
 
 FileData::FileData( const AfNodeSrv * i_node):
 	m_length( 0),
-	m_data( NULL)
+	m_append( false),
+	m_data( NULL),
+	m_push_time( 0)
 {
 	m_folder_name = i_node->getStoreDir();
 }
@@ -68,38 +84,282 @@ FileData::~FileData()
 {
 	if( m_data != NULL ) delete [] m_data;
 }
-FileQueue::FileQueue( const std::string & QueueName):
-	af::AfQueue( QueueName, af::AfQueue::e_start_thread)
+void FileData::takeData( FileData & i_other)
+{
+	if( m_data != NULL ) delete [] m_data;
+
+	m_data = i_other.m_data;
+	m_length = i_other.m_length;
+	m_str.swap( i_other.m_str);
+
+	i_other.m_data = NULL;
+	i_other.m_length = 0;
+}
+
+namespace
+{
+/// Files of a node store folder (and the folder itself) have the same key,
+/// store folder files have the store folder key, other files their folder key.
+const std::string writerKey( const std::string & i_path)
+{
+	const std::string & store = af::Environment::getStoreFolder();
+	if(( i_path.size() > store.size()) && ( i_path.compare( 0, store.size(), store) == 0 ))
+	{
+		// <store>/<nodes type>/<thousands>/<id.name>/...
+		size_t pos = store.size();
+		for( int i = 0; i < 3; i++)
+		{
+			pos = i_path.find( AFGENERAL::PATH_SEPARATOR, pos + 1);
+			if( pos == std::string::npos )
+				return i_path;
+		}
+		return i_path.substr( 0, pos);
+	}
+
+	size_t pos = i_path.rfind( AFGENERAL::PATH_SEPARATOR);
+	if( pos == std::string::npos )
+		return i_path;
+	return i_path.substr( 0, pos);
+}
+
+uint32_t hash( const std::string & i_str)
+{
+	uint32_t hash = 2166136261u;
+	for( int i = 0; i < i_str.size(); i++)
+	{
+		hash ^= uint8_t( i_str[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+}
+
+FileQueue::FileQueue( const std::string & i_name, int i_threads)
 {
+	if( i_threads < 1 )
+		i_threads = 1;
+
+	for( int i = 0; i < i_threads; i++)
+		m_writers.push_back( new Writer( i_name + " " + af::itos( i)));
 }
 
 FileQueue::~FileQueue()
 {
+	for( int i = 0; i < m_writers.size(); i++)
+		delete m_writers[i];
+}
+
+FileQueue::Writer * FileQueue::getWriter( const std::string & i_path) const
+{
+	if( m_writers.size() == 1 )
+		return m_writers[0];
+
+	return m_writers[hash( writerKey( i_path)) % m_writers.size()];
+}
+
+bool FileQueue::pushFile( FileData * i_filedata)
+{
+	// Writers threads finish on exit, the last popped item is deleted not processed,
+	// so it can't take a data of a new write:
+	if( false == AFRunning )
+	{
+		delete i_filedata;
+		return false;
+	}
+
+	i_filedata->setPushTime( af::getMonotonicMSec());
+
+	if( i_filedata->forDelete())
+		return getWriter( i_filedata->getFolderName())->pushFile( i_filedata);
+
+	return getWriter( i_filedata->getFileName())->pushFile( i_filedata);
+}
+
+void FileQueue::writeStat( std::ostringstream & o_str)
+{
+	Stat stat;
+	memset( &stat, 0, sizeof(stat));
+
+	int count = 0;
+	for( int i = 0; i < m_writers.size(); i++)
+	{
+		m_writers[i]->takeStat( stat);
+		count += m_writers[i]->getCount();
+	}
+
+	o_str << "\nFiles writing: pushed " << stat.pushed;
+	o_str << ", coalesced " << stat.coalesced;
+	o_str << ", written " << stat.written << " (" << ( stat.bytes >> 10 ) << " KB)";
+	if( stat.written )
+		o_str << ", latency avg " << ( stat.latency_sum / stat.written ) << " ms";
+	o_str << ", max " << stat.latency_max << " ms";
+	o_str << ", queue " << count << " (max " << stat.count_max << ")";
+	o_str << ", folders made " << stat.folders_made;
+	o_str << ", threads " << m_writers.size();
+}
+
+FileQueue::Writer::Writer( const std::string & i_name):
+	af::AfQueue( i_name, af::AfQueue::e_start_thread)
+{
+	memset( &m_stat, 0, sizeof(m_stat));
+}
+
+FileQueue::Writer::~Writer()
+{
+}
+
+bool FileQueue::Writer::pushFile( FileData * i_filedata)
+{
+	DlScopeLocker lock( &m_mutex);
+
+	m_stat.pushed++;
+
+	if( i_filedata->forDelete())
+	{
+		// Previous writes of the folder files should be written before removal,
+		// and later writes should not replace them:
+		const std::string & folder = i_filedata->getFolderName();
+		std::map<std::string, FileData*>::iterator it = m_writes.lower_bound( folder);
+		while(( it != m_writes.end()) && ( it->first.compare( 0, folder.size(), folder) == 0 ))
+			m_writes.erase( it++);
+	}
+	else if( i_filedata->isAppend())
+	{
+		// Append should follow the previous write:
+		m_writes.erase( i_filedata->getFileName());
+	}
+	else
+	{
+		std::map<std::string, FileData*>::iterator it = m_writes.find( i_filedata->getFileName());
+		if( it != m_writes.end())
+		{
+			it->second->takeData( *i_filedata);
+			delete i_filedata;
+			m_stat.coalesced++;
+			return true;
+		}
+		m_writes[i_filedata->getFileName()] = i_filedata;
+	}
+
+	bool pushed = push( i_filedata);
+
+	int count = getCount();
+	if( m_stat.count_max < count )
+		m_stat.count_max = count;
+
+	return pushed;
+}
+
+void FileQueue::Writer::takeStat( Stat & o_stat)
+{
+	DlScopeLocker lock( &m_mutex);
+
+	o_stat.pushed       += m_stat.pushed;
+	o_stat.coalesced    += m_stat.coalesced;
+	o_stat.written      += m_stat.written;
+	o_stat.bytes        += m_stat.bytes;
+	o_stat.latency_sum  += m_stat.latency_sum;
+	o_stat.folders_made += m_stat.folders_made;
+	if( o_stat.latency_max < m_stat.latency_max ) o_stat.latency_max = m_stat.latency_max;
+	if( o_stat.count_max   < m_stat.count_max   ) o_stat.count_max   = m_stat.count_max;
+
+	memset( &m_stat, 0, sizeof(m_stat));
 }
 
-void FileQueue::processItem( af::AfQueueItem* item)
+bool FileQueue::Writer::makeFolder( const std::string & i_folder)
 {
-	FileData * filedata = (FileData*)item;
+	if( m_folders.find( i_folder) != m_folders.end())
+		return true;
+
+	if( false == af::pathIsFolder( i_folder))
+	{
+		if( false == af::pathMakePath( i_folder))
+		{
+			AFCommon::QueueLogError("FileQueue: Unable to create folder:\n" + i_folder);
+			return false;
+		}
+
+		DlScopeLocker lock( &m_mutex);
+		m_stat.folders_made++;
+	}
+
+	// Folders are cached to not check them on each task output write,
+	// cache is just cleared if it becomes big:
+	if( m_folders.size() > 10000 )
+		m_folders.clear();
+	m_folders.insert( i_folder);
+
+	return true;
+}
+
+void FileQueue::Writer::forgetFolder( const std::string & i_folder)
+{
+	std::set<std::string>::iterator it = m_folders.lower_bound( i_folder);
+	while(( it != m_folders.end()) && ( it->compare( 0, i_folder.size(), i_folder) == 0 ))
+		m_folders.erase( it++);
+}
+
+void FileQueue::Writer::processItem( af::AfQueueItem * i_item)
+{
+	FileData * filedata = (FileData*)i_item;
 	AFINFA("FileQueue::processItem: \"%s\"", filedata->getFileName().c_str())
 
+	{
+		// Write data can't be replaced after this point:
+		DlScopeLocker lock( &m_mutex);
+		std::map<std::string, FileData*>::iterator it = m_writes.find( filedata->getFileName());
+		if(( it != m_writes.end()) && ( it->second == filedata ))
+			m_writes.erase( it);
+
+		int64_t latency = af::getMonotonicMSec() - filedata->getPushTime();
+		m_stat.written++;
+		m_stat.bytes += filedata->getLength();
+		m_stat.latency_sum += latency;
+		if( m_stat.latency_max < latency )
+			m_stat.latency_max = latency;
+	}
+
 	if( filedata->forDelete())
 	{
-		af::removeDir( filedata->getFolderName());
+		forgetFolder( filedata->getFolderName());
+		AFCommon::removeStoreDir( filedata->getFolderName());
 		delete filedata;
+		syncStoreLog();
 		return;
 	}
 
-	if( filedata->getFolderName().size())
-		if( false == af::pathIsFolder( filedata->getFolderName()))
-			if( false == af::pathMakeDir( filedata->getFolderName()))
-			{
-				AFCommon::QueueLogError("FileQueue: Unable to create folder:\n" + filedata->getFolderName());
-				delete filedata;
-				return;
-			}
+	if( StoreLog::Manages( filedata->getFileName()))
+	{
+		StoreLog::Write( filedata->getData(), filedata->getLength(), filedata->getFileName(), filedata->isAppend());
+		delete filedata;
+		syncStoreLog();
+		return;
+	}
 
-	AFCommon::writeFile( filedata->getData(), filedata->getLength(), filedata->getFileName());
+	bool written = false;
+	for( int attempt = 0; attempt < 2; attempt++)
+	{
+		if( filedata->getFolderName().size())
+			if( false == makeFolder( filedata->getFolderName()))
+				break;
+
+		if( filedata->isAppend())
+			written = AFCommon::appendFile( filedata->getData(), filedata->getLength(), filedata->getFileName());
+		else
+			written = AFCommon::writeFile( filedata->getData(), filedata->getLength(), filedata->getFileName());
+
+		// Cached folder can be removed by node store folder recreation, try once more:
+		if( written || filedata->getFolderName().empty() || ( m_folders.erase( filedata->getFolderName()) == 0 ))
+			break;
+	}
 
 	delete filedata;
+	syncStoreLog();
 }
 
+void FileQueue::Writer::syncStoreLog()
+{
+	// Log records are synced in batches, when there are no more files to write:
+	if( StoreLog::Enabled() && ( getCount() == 0 ))
+		StoreLog::Sync();
+}
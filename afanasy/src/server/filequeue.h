@@ -1,6 +1,13 @@
 #pragma once
 
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdint.h>
+#include <vector>
+
 #include "../libafanasy/afqueue.h"
+#include "../libafanasy/common/dlMutex.h"
 
 class AfNodeSrv;
 
@@ -24,26 +31,93 @@ public:
 
 	inline bool forDelete() const { return ( m_folder_name.size() && m_file_name.empty() );}
 
+	/// Append data to the file end, instead of file rewrite.
+	inline void setAppend() { m_append = true; }
+	inline bool isAppend() const { return m_append; }
+
+	/// Take data of a later write of the same file, that is not needed to be written itself.
+	void takeData( FileData & i_other);
+
+	inline void setPushTime( int64_t i_time) { m_push_time = i_time; }
+	inline int64_t getPushTime() const { return m_push_time; }
+
 private:
 	std::string m_file_name;
 	std::string m_folder_name;
 	int m_length;
+	bool m_append;
 	char * m_data;
 	std::string m_str;
+	int64_t m_push_time;
 };
 
-/// Simple FIFO filedata queue
-class FileQueue : public af::AfQueue
+/// Files writing threads.
+/** Files are written by a pool of FIFO queues threads.
+*** Thread is chosen by a file node store folder, so files of a node
+*** and the node folder removal are processed in the same order as pushed.
+*** A full file write replaces data of a previous write of the same file,
+*** that is still waiting in queue, so the file is written once.
+**/
+class FileQueue
 {
 public:
-	FileQueue( const std::string & QueueName);
-	virtual ~FileQueue();
+	FileQueue( const std::string & i_name, int i_threads);
+	~FileQueue();
 
-/// Push filedata to queue back.
-	inline bool pushFile( FileData* filedata) { return push( filedata);}
-	inline bool pushNode( const AfNodeSrv * i_node) { return push( new FileData( i_node));}
+	/// Push filedata to queue back.
+	bool pushFile( FileData * i_filedata);
+	inline bool pushNode( const AfNodeSrv * i_node) { return pushFile( new FileData( i_node));}
 
-protected:
-	void processItem( af::AfQueueItem* item);
-};
+	/// Write statistics since the previous call.
+	void writeStat( std::ostringstream & o_str);
+
+private:
+	struct Stat
+	{
+		int64_t pushed;
+		int64_t coalesced;
+		int64_t written;
+		int64_t bytes;
+		int64_t latency_sum;
+		int64_t latency_max;
+		int64_t count_max;
+		int64_t folders_made;
+	};
+
+	class Writer : public af::AfQueue
+	{
+	public:
+		Writer( const std::string & i_name);
+		virtual ~Writer();
+
+		bool pushFile( FileData * i_filedata);
+
+		/// Add statistics to \c o_stat and reset it.
+		void takeStat( Stat & o_stat);
 
+	protected:
+		void processItem( af::AfQueueItem * i_item);
+
+	private:
+		bool makeFolder( const std::string & i_folder);
+		void forgetFolder( const std::string & i_folder);
+
+		void syncStoreLog();
+
+	private:
+		DlMutex m_mutex;
+
+		/// Full writes waiting in queue, a new write of the same file replaces data.
+		std::map<std::string, FileData*> m_writes;
+
+		/// Folders known to exist, accessed by writer thread only.
+		std::set<std::string> m_folders;
+
+		Stat m_stat;
+	};
+
+	Writer * getWriter( const std::string & i_path) const;
+
+private:
+	std::vector<Writer*> m_writers;
+};
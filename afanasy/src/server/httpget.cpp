@@ -45,7 +45,7 @@ static const char * http_get_blacklist_files[http_get_blacklist_files_len] = {
 	".json"		// do not allow access to any json file
 };
 
-af::Msg *HttpGet::process(const af::Msg *i_msg)
+af::Msg *HttpGet::process(const af::Msg *i_msg, bool i_keep_alive)
 {
 	af::Msg *o_msg = new af::Msg();
 
@@ -63,7 +63,7 @@ af::Msg *HttpGet::process(const af::Msg *i_msg)
 
 	if (file_data)
 	{
-		std::string httpHeader = af::getHttpHeader(file_size, mimeType, "200 OK");
+		std::string httpHeader = af::getHttpHeader(file_size, mimeType, "200 OK", i_keep_alive);
 
 		// combine http header with file content into msg_data
 		int msg_data_len = httpHeader.length() + file_size;
@@ -79,7 +79,7 @@ af::Msg *HttpGet::process(const af::Msg *i_msg)
 	else
 	{
 		std::string outputText404 = HttpGet::get404Content(file_name);
-		std::string output404 = af::getHttpHeader(outputText404.length(), mimeType, "404 Not Found");
+		std::string output404 = af::getHttpHeader(outputText404.length(), mimeType, "404 Not Found", i_keep_alive);
 		output404 += outputText404;
 		o_msg->setData(output404.size(), output404.c_str(), af::Msg::THTTPGET);
 	}
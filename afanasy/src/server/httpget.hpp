@@ -24,7 +24,7 @@
 class HttpGet
 {
 public:
-	static af::Msg *process(const af::Msg *i_msg);
+	static af::Msg *process(const af::Msg *i_msg, bool i_keep_alive = false);
 
 private:
 	static std::string getFileNameFromInMsg(const af::Msg *i_msg);
@@ -0,0 +1,236 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Linux io_uring submission and completion queues.
+	It is a thin wrapper over io_uring system calls (no liburing needed).
+	Operations are added to a shared submission ring and submitted by one call,
+	completions are read from a shared completion ring with no system calls at all.
+	Rings are not locked: only one thread should use an instance.
+*/
+#include "iouring.h"
+
+#if defined(LINUX) && !defined(NO_IO_URING)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+IOURing::IOURing():
+	m_fd( -1),
+	m_sq_ptr( MAP_FAILED),
+	m_sq_size( 0),
+	m_sq_entries( 0),
+	m_sqe_tail( 0),
+	m_sqes( (struct io_uring_sqe *)MAP_FAILED),
+	m_sqes_size( 0),
+	m_cq_ptr( MAP_FAILED),
+	m_cq_size( 0),
+	m_stat_enters( 0),
+	m_stat_submitted( 0),
+	m_stat_completed( 0)
+{
+	memset( &m_timeout, 0, sizeof( m_timeout));
+}
+
+IOURing::~IOURing()
+{
+	if( m_sqes != MAP_FAILED )
+		munmap( m_sqes, m_sqes_size);
+	if(( m_cq_ptr != MAP_FAILED ) && ( m_cq_ptr != m_sq_ptr ))
+		munmap( m_cq_ptr, m_cq_size);
+	if( m_sq_ptr != MAP_FAILED )
+		munmap( m_sq_ptr, m_sq_size);
+	if( m_fd != -1 )
+		close( m_fd);
+}
+
+bool IOURing::init( unsigned i_entries)
+{
+	struct io_uring_params params;
+	memset( &params, 0, sizeof( params));
+
+	m_fd = syscall( __NR_io_uring_setup, i_entries, &params);
+	if( m_fd == -1 )
+	{
+		AF_WARN << "io_uring_setup: " << strerror( errno);
+		return false;
+	}
+
+	// Completions should not be lost, if completion ring overflows:
+	if( false == ( params.features & IORING_FEAT_NODROP ))
+	{
+		AF_WARN << "io_uring: Kernel is too old, no IORING_FEAT_NODROP feature.";
+		return false;
+	}
+
+	m_sq_size = params.sq_off.array + params.sq_entries * sizeof( unsigned);
+	m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe);
+
+	// Both rings can be mapped by a single call:
+	if( params.features & IORING_FEAT_SINGLE_MMAP )
+	{
+		if( m_cq_size > m_sq_size )
+			m_sq_size = m_cq_size;
+		m_cq_size = m_sq_size;
+	}
+
+	m_sq_ptr = mmap( NULL, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+	if( m_sq_ptr == MAP_FAILED )
+	{
+		AF_ERR << "io_uring: mmap submission ring: " << strerror( errno);
+		return false;
+	}
+
+	if( params.features & IORING_FEAT_SINGLE_MMAP )
+		m_cq_ptr = m_sq_ptr;
+	else
+	{
+		m_cq_ptr = mmap( NULL, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+		if( m_cq_ptr == MAP_FAILED )
+		{
+			AF_ERR << "io_uring: mmap completion ring: " << strerror( errno);
+			return false;
+		}
+	}
+
+	m_sqes_size = params.sq_entries * sizeof( struct io_uring_sqe);
+	m_sqes = (struct io_uring_sqe *)mmap( NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+	if( m_sqes == MAP_FAILED )
+	{
+		AF_ERR << "io_uring: mmap submission entries: " << strerror( errno);
+		return false;
+	}
+
+	char * sq = (char*)m_sq_ptr;
+	m_sq_head  = (unsigned*)( sq + params.sq_off.head);
+	m_sq_tail  = (unsigned*)( sq + params.sq_off.tail);
+	m_sq_mask  = (unsigned*)( sq + params.sq_off.ring_mask);
+	m_sq_array = (unsigned*)( sq + params.sq_off.array);
+	m_sq_entries = params.sq_entries;
+	m_sqe_tail = *m_sq_tail;
+
+	char * cq = (char*)m_cq_ptr;
+	m_cq_head = (unsigned*)( cq + params.cq_off.head);
+	m_cq_tail = (unsigned*)( cq + params.cq_off.tail);
+	m_cq_mask = (unsigned*)( cq + params.cq_off.ring_mask);
+	m_cqes    = (struct io_uring_cqe *)( cq + params.cq_off.cqes);
+
+	AF_LOG << "io_uring: " << params.sq_entries << " submission and " << params.cq_entries << " completion entries.";
+
+	return true;
+}
+
+struct io_uring_sqe * IOURing::getSqe()
+{
+	if( m_sqe_tail - __atomic_load_n( m_sq_head, __ATOMIC_ACQUIRE) >= m_sq_entries )
+	{
+		// Ring is full, kernel should take filled entries:
+		if(( false == submit(0)) || ( m_sqe_tail - __atomic_load_n( m_sq_head, __ATOMIC_ACQUIRE) >= m_sq_entries ))
+			return NULL;
+	}
+
+	unsigned index = m_sqe_tail & *m_sq_mask;
+	struct io_uring_sqe * sqe = m_sqes + index;
+	memset( sqe, 0, sizeof( struct io_uring_sqe));
+	m_sq_array[index] = index;
+	m_sqe_tail++;
+
+	return sqe;
+}
+
+void IOURing::prepTimeout( struct io_uring_sqe * o_sqe, int i_msec, uint64_t i_user_data)
+{
+	m_timeout.tv_sec  = i_msec / 1000;
+	m_timeout.tv_nsec = ( i_msec % 1000 ) * 1000000;
+
+	o_sqe->opcode = IORING_OP_TIMEOUT;
+	o_sqe->fd = -1;
+	o_sqe->addr = (uint64_t)(uintptr_t)&m_timeout;
+	o_sqe->len = 1;
+	o_sqe->user_data = i_user_data;
+}
+
+bool IOURing::submit( unsigned i_wait_nr)
+{
+	// Filled entries, that are not consumed by kernel yet:
+	unsigned to_submit = m_sqe_tail - __atomic_load_n( m_sq_head, __ATOMIC_ACQUIRE);
+	if(( to_submit == 0 ) && ( i_wait_nr == 0 ))
+		return true;
+
+	// Filled entries should be visible to kernel before the new tail:
+	__atomic_store_n( m_sq_tail, m_sqe_tail, __ATOMIC_RELEASE);
+
+	for(;;)
+	{
+		int flags = i_wait_nr ? IORING_ENTER_GETEVENTS : 0;
+		int ret = syscall( __NR_io_uring_enter, m_fd, to_submit, i_wait_nr, flags, NULL, 0);
+		__atomic_fetch_add( &m_stat_enters, 1, __ATOMIC_RELAXED);
+
+		if( ret >= 0 )
+		{
+			__atomic_fetch_add( &m_stat_submitted, ret, __ATOMIC_RELAXED);
+			return true;
+		}
+
+		switch( errno )
+		{
+		case EINTR:
+			continue;
+		case EAGAIN:
+		case EBUSY:
+			// Completion ring is full, completions should be processed first.
+			return true;
+		default:
+			AF_ERR << "io_uring_enter: " << strerror( errno);
+			return false;
+		}
+	}
+}
+
+struct io_uring_cqe * IOURing::peekCqe()
+{
+	unsigned head = *m_cq_head;
+	if( head == __atomic_load_n( m_cq_tail, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	return m_cqes + ( head & *m_cq_mask );
+}
+
+void IOURing::cqeSeen()
+{
+	__atomic_store_n( m_cq_head, *m_cq_head + 1, __ATOMIC_RELEASE);
+	__atomic_fetch_add( &m_stat_completed, 1, __ATOMIC_RELAXED);
+}
+
+void IOURing::writeStat( std::ostringstream & o_str)
+{
+	// Statistics are written by other thread, counters are taken atomically:
+	int64_t enters    = __atomic_exchange_n( &m_stat_enters,    0, __ATOMIC_RELAXED);
+	int64_t submitted = __atomic_exchange_n( &m_stat_submitted, 0, __ATOMIC_RELAXED);
+	int64_t completed = __atomic_exchange_n( &m_stat_completed, 0, __ATOMIC_RELAXED);
+
+	o_str << "\nio_uring: system calls " << enters;
+	o_str << ", submitted " << submitted;
+	o_str << ", completed " << completed;
+	if( enters )
+		o_str << ", operations per call " << ( double( submitted) / enters );
+}
+
+#endif
@@ -0,0 +1,87 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Linux io_uring submission and completion queues.
+	It is a thin wrapper over io_uring system calls (no liburing needed).
+	Operations are added to a shared submission ring and submitted by one call,
+	completions are read from a shared completion ring with no system calls at all.
+	Rings are not locked: only one thread should use an instance.
+*/
+#pragma once
+
+#if defined(LINUX) && !defined(NO_IO_URING)
+
+#include <linux/io_uring.h>
+#include <sstream>
+#include <stddef.h>
+#include <stdint.h>
+
+class IOURing
+{
+public:
+	IOURing();
+	~IOURing();
+
+	/// Setup rings, returns false if kernel does not support io_uring.
+	bool init( unsigned i_entries);
+
+	/// Get an empty submission entry to fill.
+	/// Already filled entries are submitted, if the ring is full.
+	struct io_uring_sqe * getSqe();
+
+	/// Prepare a relative timeout operation.
+	/// Only one timeout can be in flight, as its time is stored here.
+	void prepTimeout( struct io_uring_sqe * o_sqe, int i_msec, uint64_t i_user_data);
+
+	/// Submit filled entries and wait for at least \c i_wait_nr completions.
+	/// Returns false on a ring failure.
+	bool submit( unsigned i_wait_nr);
+
+	/// Get the next completion or NULL, it should be marked as seen after processing.
+	struct io_uring_cqe * peekCqe();
+	void cqeSeen();
+
+	/// Write statistics since the previous call, it can be called by other thread.
+	void writeStat( std::ostringstream & o_str);
+
+private:
+	int m_fd;
+
+	// Submission ring:
+	void * m_sq_ptr;
+	size_t m_sq_size;
+	unsigned * m_sq_head;
+	unsigned * m_sq_tail;
+	unsigned * m_sq_mask;
+	unsigned * m_sq_array;
+	unsigned m_sq_entries;
+	unsigned m_sqe_tail; ///< Filled entries tail, it is given to kernel on submit.
+	struct io_uring_sqe * m_sqes;
+	size_t m_sqes_size;
+
+	// Completion ring:
+	void * m_cq_ptr;
+	size_t m_cq_size;
+	unsigned * m_cq_head;
+	unsigned * m_cq_tail;
+	unsigned * m_cq_mask;
+	struct io_uring_cqe * m_cqes;
+
+	struct __kernel_timespec m_timeout;
+
+	int64_t m_stat_enters;
+	int64_t m_stat_submitted;
+	int64_t m_stat_completed;
+};
+
+#endif
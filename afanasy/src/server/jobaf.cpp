@@ -20,6 +20,7 @@
 #include "../libafanasy/blockdata.h"
 #include "../libafanasy/environment.h"
 #include "../libafanasy/jobprogress.h"
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgqueue.h"
 
 #include "action.h"
@@ -31,6 +32,8 @@
 #include "monitorcontainer.h"
 #include "renderaf.h"
 #include "rendercontainer.h"
+#include "solver.h"
+#include "storelog.h"
 #include "sysjob.h"
 #include "task.h"
 #include "useraf.h"
@@ -97,7 +100,7 @@ void JobAf::readStore()
 	initStoreDirs();
 
 	int size;
-	char * data = af::fileRead( getStoreFile(), &size);
+	char * data = AFCommon::readStoreFile( getStoreFile(), &size);
 	if( NULL == data ) return;
 
 	rapidjson::Document document;
@@ -120,6 +123,129 @@ void JobAf::readStore()
 	for( int b = 0; b < m_blocks_num; b++)
 		if( false == m_blocks[b]->readStoredTasks())
 			return;
+
+	readTasksProgress();
+}
+
+const std::string JobAf::getTasksProgressFile() const
+{
+	return getStoreDir() + AFGENERAL::PATH_SEPARATOR + "tasks_progress.journal";
+}
+
+void JobAf::readTasksProgress()
+{
+	std::string filename = getTasksProgressFile();
+	if( false == AFCommon::storeFileExists( filename))
+		return;
+
+	int size;
+	char * data = AFCommon::readStoreFile( filename, &size);
+	if( NULL == data )
+		return;
+
+	// Journal consists of JSON records, one per line:
+	// {"b":block,"t":task,"p":{progress}}
+	char * line = data;
+	char * end = data + size;
+	while( line < end )
+	{
+		char * eol = line;
+		while(( eol < end ) && ( *eol != '\n' ))
+			eol++;
+
+		// Not finished record, server was stopped while writing:
+		if( eol == end )
+			break;
+
+		*eol = '\0';
+
+		rapidjson::Document document;
+		if(( false == document.ParseInsitu<0>( line).HasParseError()) && document.IsObject() && document.HasMember("p"))
+		{
+			int b = -1, t = -1;
+			af::jr_int("b", b, document);
+			af::jr_int("t", t, document);
+			const JSON & progress = document["p"];
+
+			if( progress.IsObject() && checkBlockTaskNumbers( b, t, "readTasksProgress"))
+			{
+				// Progress JSON does not contain empty values,
+				// so the previous record values should be reset.
+				af::TaskProgressView tp = m_progress->tp[b][t];
+				tp->starts_count = 0;
+				tp->errors_count = 0;
+				tp->time_start = 0;
+				tp->time_done = 0;
+				tp->hostname.clear();
+				tp->resources.clear();
+				tp->jsonRead( progress);
+			}
+
+			m_tasks_progress_records++;
+		}
+		else
+			AF_WARN << "Job \"" << m_name << "\": Invalid tasks progress record skipped.";
+
+		line = eol + 1;
+	}
+
+	delete [] data;
+}
+
+void JobAf::storeTaskProgress( Task * i_task)
+{
+	m_tasks_progress_store.push_back( i_task);
+}
+
+void JobAf::v_postSolve( time_t i_curtime, MonitorContainer * i_monitoring)
+{
+	writeTasksProgress();
+}
+
+void JobAf::writeTasksProgress()
+{
+	if( m_tasks_progress_store.empty())
+		return;
+
+	// Deleting job store will be removed:
+	if( m_deletion || isZombie())
+	{
+		for( int i = 0; i < m_tasks_progress_store.size(); i++)
+			m_tasks_progress_store[i]->m_progress_store = false;
+		m_tasks_progress_store.clear();
+		return;
+	}
+
+	int tasks_num = 0;
+	for( int b = 0; b < m_blocks_num; b++)
+		tasks_num += m_blocks[b]->m_data->getTasksNum();
+
+	std::ostringstream str;
+
+	if( m_tasks_progress_records + int( m_tasks_progress_store.size()) > 2 * tasks_num + AFJOB::TASKS_PROGRESS_JOURNAL_MIN )
+	{
+		// Journal is too big, rewrite it with the only one record per task:
+		for( int b = 0; b < m_blocks_num; b++)
+			for( int t = 0; t < m_blocks[b]->m_data->getTasksNum(); t++)
+				m_blocks[b]->m_tasks[t]->writeProgressRecord( str);
+
+		m_tasks_progress_records = tasks_num;
+
+		AFCommon::QueueFileWrite( new FileData( str, getTasksProgressFile(), getStoreDir()));
+	}
+	else
+	{
+		for( int i = 0; i < m_tasks_progress_store.size(); i++)
+			m_tasks_progress_store[i]->writeProgressRecord( str);
+
+		m_tasks_progress_records += m_tasks_progress_store.size();
+
+		FileData * filedata = new FileData( str, getTasksProgressFile(), getStoreDir());
+		filedata->setAppend();
+		AFCommon::QueueFileWrite( filedata);
+	}
+
+	m_tasks_progress_store.clear();
 }
 
 void JobAf::initializeValues()
@@ -129,6 +255,9 @@ void JobAf::initializeValues()
 	m_blocks           = NULL;
 	m_progress         = NULL;
 	m_deletion         = false;
+	m_solve_epoch      = 0;
+
+	m_tasks_progress_records = 0;
 	
 	m_thumb_changed    = false;
 	m_report_changed   = false;
@@ -272,11 +401,13 @@ bool JobAf::initialize()
 		std::ostringstream ostr;
 		v_jsonWrite( ostr, 0);
 		std::string str = ostr.str();
-		AFCommon::writeFile( str.c_str(), str.size(), getStoreFile());
+		AFCommon::writeStoreFile( str, getStoreFile());
 	}
 
-	// Create tasks store folder (if does not exists any)
-	if(( af::pathIsFolder( m_store_dir_tasks) == false ) && ( af::pathMakePath( m_store_dir_tasks) == false ))
+	// Create tasks store folder (if does not exists any),
+	// in store log mode it is created on the first task output or files write.
+	if(( false == StoreLog::Enabled()) &&
+		( af::pathIsFolder( m_store_dir_tasks) == false ) && ( af::pathMakePath( m_store_dir_tasks) == false ))
 	{
 		AFCommon::QueueLogError( std::string("Unable to create tasks store folder:\n") + m_store_dir_tasks);
 		return false;
@@ -451,6 +582,9 @@ void JobAf::deleteNode( RenderContainer * renders, MonitorContainer * monitoring
 
 void JobAf::v_action( Action & i_action)
 {
+	// Action can change any block or task:
+	setRefreshAll();
+
 	// If action has blocks ids array - action to for blocks
 	if( i_action.data->HasMember("block_ids") || i_action.data->HasMember("block_mask"))
 	{
@@ -726,9 +860,9 @@ af::TaskExec * JobAf::genTask( RenderAf *render, int block, int task, std::list<
 	if( m_state & AFJOB::STATE_OFFLINE_MASK )
 		return NULL;
 
-	if( m_blocks[block]->m_tasks[task]->m_solved )
+	if( m_blocks[block]->m_tasks[task]->m_solve_epoch == m_solve_epoch )
 		return NULL;
-	m_blocks[block]->m_tasks[task]->m_solved = true;
+	m_blocks[block]->m_tasks[task]->m_solve_epoch = m_solve_epoch;
 
 	//
 	// Recursive dependence check, only if needed
@@ -1026,10 +1160,13 @@ void JobAf::tryTaskNext(bool i_append, int i_block_num, int i_task_num)
 
 RenderAf * JobAf::v_solve( std::list<RenderAf*> & i_renders_list, MonitorContainer * i_monitoring, BranchSrv * i_branch)
 {
-	for( std::list<RenderAf*>::iterator rIt = i_renders_list.begin(); rIt != i_renders_list.end(); rIt++)
+	// Try renders from the most ready one:
+	af::RendersRanking ranking;
+	Solver::RankRenders( this, i_renders_list, ranking);
+	for( RenderAf * render = (RenderAf*)ranking.next(); render != NULL; render = (RenderAf*)ranking.next())
 	{
-		if( solveOnRender( *rIt, i_monitoring))
-			return *rIt;
+		if( solveOnRender( render, i_monitoring))
+			return render;
 	}
 
 	return NULL;
@@ -1037,19 +1174,12 @@ RenderAf * JobAf::v_solve( std::list<RenderAf*> & i_renders_list, MonitorContain
 
 bool JobAf::solveOnRender( RenderAf * i_render, MonitorContainer * i_monitoring)
 {
-	// Prepare for the new solving (reset previous solvind stored data):
-	for( int b = 0; b < m_blocks_num; b++)
-	{
-		int numtasks = m_blocks_data[b]->getTasksNum();
-		for( int t = 0; t < numtasks; t++)
-		{
-			// Needed for recursion function, to not to try to solve the same task again
-			m_blocks[b]->m_tasks[t]->m_solved = false;
-			
-			// Needed to store tasks that was tried, for nonsequential case:
-			m_progress->tp[b][t]->setNotSolved();
-		}
-	}
+	// Prepare for the new solving:
+	// Tasks that was tried in previous solving are marked with a previous epoch,
+	// so they are not solved in the new one without resetting each task.
+	// Task epoch is needed for recursion function, to not to try to solve the same task again,
+	// progress epoch is needed to store tasks that was tried, for nonsequential case.
+	m_solve_epoch++;
 
 	// First we solving tasks if users asked to try them next
 	if (hasTasksToTryNext() && checkTryTasksNext())
@@ -1078,7 +1208,7 @@ bool JobAf::solveOnRender( RenderAf * i_render, MonitorContainer * i_monitoring)
 	{
 		if( false == ( m_blocks_data[b]->getState() & AFJOB::STATE_READY_MASK )) continue;
 		
-		int task_num = m_blocks_data[b]->getReadyTaskNumber( m_progress->tp[b], m_flags, i_render);
+		int task_num = m_blocks_data[b]->getReadyTaskNumber( m_progress->tp[b], m_flags, i_render, m_solve_epoch);
 		
 		if( task_num == AFJOB::TASK_NUM_NO_TASK )
 		{
@@ -1452,6 +1582,12 @@ void JobAf::emitEvents(const std::vector<std::string> & i_events) const
 		m_user_name, m_name, i_events[0]);
 }
 
+void JobAf::setRefreshAll()
+{
+	for( int b = 0; b < m_blocks_num; b++)
+		m_blocks[b]->setRefreshAll();
+}
+
 void JobAf::restartAllTasks( const std::string & i_message, RenderContainer * i_renders, MonitorContainer * i_monitoring, uint32_t i_state)
 {
 	for( int b = 0; b < m_blocks_num; b++)
@@ -1461,6 +1597,7 @@ void JobAf::restartAllTasks( const std::string & i_message, RenderContainer * i_
 		{
 			m_blocks[b]->m_tasks[t]->restart( i_message, i_renders, i_monitoring, i_state);
 		}
+		m_blocks[b]->setRefreshAll();
 	}
 
 	v_refresh( time(NULL), i_renders, i_monitoring);
@@ -1471,22 +1608,19 @@ void JobAf::writeProgress( af::Msg &msg)
 	msg.set( af::Msg::TJobProgress, m_progress);
 }
 
-af::Msg * JobAf::writeProgress( bool json)
+af::Msg * JobAf::writeProgress( bool json, bool i_compact)
 {
-	af::Msg * msg = new af::Msg(); 
 	if( json )
 	{
-		std::ostringstream stream;
-		m_progress->jsonWrite( stream);
-		std::string string = stream.str();
-		msg->setData( string.size(), string.c_str(), af::Msg::TJSON);
-	}
-	else
-	{
-		msg->set( af::Msg::TJobProgress, m_progress);
+		af::MsgStream stream;
+		if( i_compact )
+			m_progress->jsonWriteCompact( stream);
+		else
+			m_progress->jsonWrite( stream);
+		return af::jsonMsg( stream);
 	}
 
-	return msg;
+	return new af::Msg( af::Msg::TJobProgress, m_progress);
 }
 
 af::Msg * JobAf::writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std::string> i_modes, bool i_binary) const
@@ -1506,7 +1640,7 @@ af::Msg * JobAf::writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std:
 		return new af::Msg(af::BlockData::DataModeFromString(i_modes[0]), &mcblocks);
 	}
 
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{\"blocks\":[\n";
 	for( int b = 0; b < i_block_ids.size(); b++)
 	{
@@ -1525,7 +1659,7 @@ af::Msg * JobAf::writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std:
 
 af::Msg * JobAf::writeTask( int i_b, int i_t, const std::string & i_mode, bool i_binary) const
 {
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{";
 
 	if( false == checkBlockTaskNumbers( i_b, i_t, "writeTask"))
@@ -38,7 +38,7 @@ public:
 
 	af::Msg * writeThumbnail( bool i_binary);
 	
-	af::Msg * writeProgress( bool json);   ///< Write job progress in message.
+	af::Msg * writeProgress( bool json, bool i_compact = false);   ///< Write job progress in message.
 	
 	af::Msg * writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std::string> i_modes, bool i_binary) const;
 	
@@ -80,6 +80,12 @@ public:
 	/// Refresh job. Calculate attributes from tasks progress.
 	virtual void v_refresh( time_t currentTime, AfContainer * pointer, MonitorContainer * monitoring);
 
+	/// Write tasks progress changed during the cycle.
+	void v_postSolve( time_t i_curtime, MonitorContainer * i_monitoring);
+
+	/// Queue task progress to store in tasks progress journal.
+	void storeTaskProgress( Task * i_task);
+
 	virtual void v_action( Action & i_action);
 
 	void setUser(UserAf * i_user);
@@ -120,6 +126,9 @@ public:
 
 	inline Block * getBlock(int i_num) {if ((i_num < 0) || (i_num >= m_blocks_num)) return NULL; return m_blocks[i_num];}
 
+	/// Refresh all blocks tasks on the next refresh (for example user errors solving parameters changed).
+	void setRefreshAll();
+
 public:
 	/// Set Jobs Container.
 	inline static void setJobContainer( JobContainer *Jobs){ ms_jobs = Jobs;}
@@ -130,6 +139,14 @@ protected:
 	void construct(int alreadyConstructed = 0);
 
 	void readStore();
+
+	/// Read tasks progress journal, the last task record is the actual one.
+	void readTasksProgress();
+
+	/// Append changed tasks progress to journal, or rewrite it compacted.
+	void writeTasksProgress();
+
+	const std::string getTasksProgressFile() const;
 	
 	virtual Block * v_newBlock( int numBlock); ///< Virtual function to create system blocks in a system job
 	
@@ -145,6 +162,11 @@ private:
 
 	std::string m_store_dir_tasks; ///< Tasks store directory.
 
+	int64_t m_solve_epoch; ///< Solving attempt number, incremented on each try to solve on a render.
+
+	std::vector<Task*> m_tasks_progress_store; ///< Tasks with changed progress to store.
+	int m_tasks_progress_records; ///< Number of records in tasks progress journal.
+
 	bool m_thumb_changed; ///< Store that thumbnail was changed, to emit event for monitors
 	bool m_report_changed; ///< Store that thumbnail was changed, to emit event for monitors
 
@@ -20,6 +20,7 @@
 #include <memory.h>
 
 #include "../libafanasy/environment.h"
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgclasses/mcafnodes.h"
 
 #include "afcommon.h"
@@ -27,6 +28,7 @@
 #include "branchescontainer.h"
 #include "monitorcontainer.h"
 #include "rendercontainer.h"
+#include "runcyclewaker.h"
 #include "useraf.h"
 #include "usercontainer.h"
 
@@ -39,6 +41,8 @@ JobContainer::JobContainer():
     AfContainer( "Jobs", AFJOB::MAXQUANTITY)
 {
 	JobAf::setJobContainer( this);
+
+	setSnapshotType( af::Msg::TJobsList, "jobs");
 }
 
 JobContainer::~JobContainer()
@@ -102,7 +106,7 @@ af::Msg * JobContainer::registerJob(JSON & i_object, BranchesContainer * i_branc
 	else
 		job = NULL;
 
-	std::ostringstream oss;
+	af::MsgStream oss;
 	oss << "{";
 	oss << "\n\"id\":" << id;
 	oss << ",\n\"serial\":" << serial;
@@ -258,6 +262,9 @@ bool JobContainer::registerJob(JobAf * i_job, std::string & o_err, BranchesConta
 		i_job->unLock();
 	}
 
+	// New job can be solved just now:
+	RunCycleWaker::Wake();
+
 	return true;
 }
 
@@ -0,0 +1,164 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Jobs store loader.
+	On server start jobs files are read and parsed by a pool of threads,
+	as it takes most of server start time on a big store.
+	Main thread takes loaded jobs in folders order to register them,
+	so registration order does not depend on threads.
+*/
+#include "jobsloader.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/common/dlThread.h"
+
+#include "jobaf.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+JobsLoader::JobsLoader( const std::vector<std::string> & i_folders, const std::string & i_skip_folder, int i_threads):
+	m_folders( i_folders),
+	m_skip_folder( i_skip_folder),
+	m_next( 0),
+	m_stat_load_ms( 0),
+	m_stat_wait_ms( 0),
+	m_stat_finish( 0)
+{
+	m_jobs.resize( m_folders.size(), NULL);
+	m_loaded.resize( m_folders.size(), 0);
+
+	m_stat_start = af::getMonotonicMSec();
+
+	if( i_threads > int( m_folders.size()))
+		i_threads = m_folders.size();
+
+	// One thread makes no sense, caller thread loads jobs itself:
+	if( i_threads < 2 )
+		return;
+
+	AF_LOG << "Raising " << i_threads << " threads to load jobs...";
+	for( int i = 0; i < i_threads; i++)
+	{
+		DlThread * t = new DlThread();
+		if( t->Start( ThreadFunc, this) != 0 )
+		{
+			AF_ERR << "Failed to start jobs loading thread.";
+			delete t;
+			break;
+		}
+		m_threads.push_back( t);
+	}
+}
+
+JobsLoader::~JobsLoader()
+{
+	// Caller could stop taking jobs, threads should finish loading them:
+	for( int i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i]->Join();
+		delete m_threads[i];
+	}
+
+	// Not taken jobs:
+	for( int i = 0; i < m_jobs.size(); i++)
+		if( m_jobs[i] )
+			delete m_jobs[i];
+}
+
+void JobsLoader::ThreadFunc( void * i_args)
+{
+	((JobsLoader*)i_args)->load();
+}
+
+void JobsLoader::load()
+{
+	for(;;)
+	{
+		int index;
+		{
+			DlScopeLocker lock( &m_mutex);
+			if( m_next >= int( m_folders.size()))
+				return;
+			index = m_next++;
+		}
+
+		loadJob( index);
+	}
+}
+
+void JobsLoader::loadJob( int i_index)
+{
+	int64_t time = af::getMonotonicMSec();
+
+	JobAf * job = NULL;
+	if( m_folders[i_index] != m_skip_folder )
+		job = new JobAf( m_folders[i_index]);
+
+	int64_t now = af::getMonotonicMSec();
+
+	DlScopeLocker lock( &m_mutex);
+
+	m_jobs[i_index] = job;
+	m_loaded[i_index] = 1;
+
+	m_stat_load_ms += now - time;
+	if( m_stat_finish < now )
+		m_stat_finish = now;
+
+	m_cond.Broadcast();
+}
+
+JobAf * JobsLoader::get( int i_index)
+{
+	if( m_threads.empty())
+	{
+		loadJob( i_index);
+	}
+	else
+	{
+		int64_t time = af::getMonotonicMSec();
+
+		DlScopeLocker lock( &m_mutex);
+		while( false == m_loaded[i_index])
+			m_cond.Wait( &m_mutex);
+
+		m_stat_wait_ms += af::getMonotonicMSec() - time;
+	}
+
+	DlScopeLocker lock( &m_mutex);
+
+	JobAf * job = m_jobs[i_index];
+	m_jobs[i_index] = NULL;
+
+	return job;
+}
+
+void JobsLoader::writeStat( std::ostringstream & o_str)
+{
+	DlScopeLocker lock( &m_mutex);
+
+	if( m_threads.empty())
+	{
+		o_str << "Jobs loading: " << m_stat_load_ms << " ms";
+	}
+	else
+	{
+		o_str << "Jobs loading: " << ( m_stat_finish - m_stat_start ) << " ms";
+		o_str << " by " << m_threads.size() << " threads";
+		o_str << " (threads time sum " << m_stat_load_ms << " ms)";
+		o_str << ", registration waited loading " << m_stat_wait_ms << " ms";
+	}
+}
@@ -0,0 +1,65 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Jobs store loader.
+	On server start jobs files are read and parsed by a pool of threads,
+	as it takes most of server start time on a big store.
+	Main thread takes loaded jobs in folders order to register them,
+	so registration order does not depend on threads.
+*/
+#pragma once
+
+#include "../libafanasy/common/dlConditionVariable.h"
+#include "../libafanasy/common/dlMutex.h"
+#include "../libafanasy/name_af.h"
+
+class DlThread;
+class JobAf;
+
+class JobsLoader
+{
+public:
+	/// Folder with \c i_skip_folder is not loaded, system job should be constructed by caller.
+	JobsLoader( const std::vector<std::string> & i_folders, const std::string & i_skip_folder, int i_threads);
+	~JobsLoader();
+
+	/// Get a job of the folder with index, it waits for the job to be loaded.
+	/// Jobs should be taken in folders order, caller takes the job ownership.
+	JobAf * get( int i_index);
+
+	/// Write loading timing.
+	void writeStat( std::ostringstream & o_str);
+
+private:
+	static void ThreadFunc( void * i_args);
+	void load();
+	void loadJob( int i_index);
+
+private:
+	const std::vector<std::string> & m_folders;
+	std::string m_skip_folder;
+
+	std::vector<JobAf*> m_jobs;
+	std::vector<char>   m_loaded;
+	int m_next;
+
+	DlMutex m_mutex;
+	DlConditionVariable m_cond;
+
+	std::vector<DlThread*> m_threads;
+
+	int64_t m_stat_start;
+	int64_t m_stat_load_ms;  ///< Threads loading time sum.
+	int64_t m_stat_wait_ms;  ///< Time the caller waited for jobs.
+	int64_t m_stat_finish;   ///< The last job loading finish time.
+};
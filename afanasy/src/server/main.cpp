@@ -30,9 +30,12 @@
 #include "afcommon.h"
 #include "branchescontainer.h"
 #include "jobcontainer.h"
+#include "jobsloader.h"
 #include "monitorcontainer.h"
 #include "poolscontainer.h"
+#include "renderconnections.h"
 #include "socketsprocessing.h"
+#include "storelog.h"
 #include "sysjob.h"
 #include "rendercontainer.h"
 #include "threadargs.h"
@@ -93,6 +96,9 @@ int main(int argc, char *argv[])
 	if (af::pathMakeDir (ENV.getStoreFolderUsers(),   af::VerboseOn) == false) return 1;
 	if (af::pathMakeDir (ENV.getStoreFolderPools(),   af::VerboseOn) == false) return 1;
 
+	// Open nodes store log, it imports folders store on the first start:
+	if (ENV.isServerStoreLog() && (false == StoreLog::Open(ENV.getStoreFolder()))) return 1;
+
 // Server for windows can be me more simple and not use signals at all.
 // Windows is not a server platform, so it designed for individual tests or very small companies with easy load.
 #ifndef _WIN32
@@ -176,6 +182,8 @@ int main(int argc, char *argv[])
 	//
 	// Get Pools from store:
 	//
+	int64_t store_time = af::getMonotonicMSec();
+	int64_t phase_time = store_time;
 	{
 	AF_LOG << "Getting pools from store...";
 
@@ -189,7 +197,7 @@ int main(int argc, char *argv[])
 		PoolSrv * pool = new PoolSrv(folders[i]);
 		if (pool->isStoredOk() != true )
 		{
-			af::removeDir(pool->getStoreDir());
+			AFCommon::removeStoreDir(pool->getStoreDir());
 			delete pool;
 			continue;
 		}
@@ -197,12 +205,13 @@ int main(int argc, char *argv[])
 			delete pool;
 	}
 	// We should check that root pool was created.
-	AF_LOG << pools.getCount() << " pools registered from store.";
+	AF_LOG << pools.getCount() << " pools registered from store in " << ( af::getMonotonicMSec() - phase_time ) << " ms.";
 	pools.createRootPool();
 	}
 	//
 	// Get Renders from store:
 	//
+	phase_time = af::getMonotonicMSec();
 	{
 	AF_LOG << "Getting renders from store...";
 
@@ -214,18 +223,19 @@ int main(int argc, char *argv[])
 		RenderAf * render = new RenderAf( folders[i]);
 		if( render->isStoredOk() != true )
 		{
-			af::removeDir( render->getStoreDir());
+			AFCommon::removeStoreDir( render->getStoreDir());
 			delete render;
 			continue;
 		}
 		renders.addRender(render, &pools, NULL, NULL);
 	}
-	AF_LOG << renders.getCount() << " renders registered.";
+	AF_LOG << renders.getCount() << " renders registered in " << ( af::getMonotonicMSec() - phase_time ) << " ms.";
 	}
 
 	//
 	// Get Users from store:
 	//
+	phase_time = af::getMonotonicMSec();
 	{
 	AF_LOG << "Getting users from store...";
 
@@ -237,18 +247,19 @@ int main(int argc, char *argv[])
 		UserAf * user = new UserAf( folders[i]);
 		if( user->isStoredOk() != true )
 		{
-			af::removeDir( user->getStoreDir());
+			AFCommon::removeStoreDir( user->getStoreDir());
 			delete user;
 			continue;
 		}
 		if( users.addUser( user) == 0 )
 			delete user;
 	}
-	AF_LOG << users.getCount() << " users registered from store.";
+	AF_LOG << users.getCount() << " users registered from store in " << ( af::getMonotonicMSec() - phase_time ) << " ms.";
 	}
 	//
 	// Get Branches from store:
 	//
+	phase_time = af::getMonotonicMSec();
 	{
 	AF_LOG << "Getting branches from store...";
 
@@ -262,19 +273,20 @@ int main(int argc, char *argv[])
 		BranchSrv * branch = new BranchSrv(folders[i]);
 		if (branch->isStoredOk() != true )
 		{
-			af::removeDir(branch->getStoreDir());
+			AFCommon::removeStoreDir(branch->getStoreDir());
 			delete branch;
 			continue;
 		}
 		if (false == branches.addBranchFromStore(branch))
 			delete branch;
 	}
-	AF_LOG << branches.getCount() << " branches registered from store.";
+	AF_LOG << branches.getCount() << " branches registered from store in " << ( af::getMonotonicMSec() - phase_time ) << " ms.";
 	}
 	//
 	// Get Jobs from store:
 	//
 	bool hasSystemJob = false;
+	phase_time = af::getMonotonicMSec();
 	{
 	AF_LOG << "Getting jobs from store...";
 
@@ -282,14 +294,22 @@ int main(int argc, char *argv[])
 	std::string sysjob_folder = AFCommon::getStoreDir( ENV.getStoreFolderJobs(), AFJOB::SYSJOB_ID, AFJOB::SYSJOB_NAME);
 
 	AF_LOG << folders.size() << " jobs found.";
+
+	// Jobs are read and parsed by threads, but registered here in folders order:
+	JobsLoader loader( folders, sysjob_folder, ENV.getServerStoreLoadThreads());
+	int64_t register_ms = 0;
+
 	for( int i = 0; i < folders.size(); i++)
 	{
 		JobAf * job = NULL;
 
+		// System job is constructed here, not by loading threads:
 		if( folders[i] == sysjob_folder)
 			job = new SysJob( folders[i]);
 		else
-			job = new JobAf( folders[i]);
+			job = loader.get( i);
+
+		int64_t register_time = af::getMonotonicMSec();
 
 		if( job->isValidConstructed())
 		{
@@ -317,12 +337,20 @@ int main(int argc, char *argv[])
 		}
 		else
 		{
-			af::removeDir( job->getStoreDir());
+			AFCommon::removeStoreDir( job->getStoreDir());
 			delete job;
 		}
+
+		register_ms += af::getMonotonicMSec() - register_time;
 	}
-	AF_LOG << jobs.getCount() << " jobs registered from store.";
+
+	std::ostringstream stat;
+	loader.writeStat( stat);
+	stat << ", registration " << register_ms << " ms.";
+	AF_LOG << stat.str();
+	AF_LOG << jobs.getCount() << " jobs registered from store in " << ( af::getMonotonicMSec() - phase_time ) << " ms.";
 	}
+	AF_LOG << "Store loaded in " << ( af::getMonotonicMSec() - store_time ) << " ms.";
 
 	// Disable new commands and editing:
 	if( af::Environment::hasArgument("-demo"))
@@ -343,6 +371,9 @@ int main(int argc, char *argv[])
 			AF_ERR << err;
 	}
 
+	// Render kept connections should be ready before sockets processing hands them over.
+	RenderConnections * renderConnections = new RenderConnections( &threadArgs);
+
 	SocketsProcessing * socketsProcessing = new SocketsProcessing( &threadArgs);
 
 	/*
@@ -375,6 +406,9 @@ int main(int argc, char *argv[])
 	// every new cycle it checks running external valiable
 	RunCycleThread.Join();
 
+	// Render connections polling thread passes messages to sockets processing.
+	delete renderConnections;
+
 	delete socketsProcessing;
 
 	AF_LOG << "Exiting process...";
@@ -19,6 +19,7 @@
 
 #include "../libafanasy/environment.h"
 #include "../libafanasy/monitorevents.h"
+#include "../libafanasy/msgbufferpool.h"
 
 #include "action.h"
 #include "afcommon.h"
@@ -68,6 +69,7 @@ void MonitorAf::v_refresh( time_t currentTime, AfContainer * pointer, MonitorCon
 		if( monitoring) monitoring->addEvent( af::Monitor::EVT_monitors_del, m_id);
 		{
 			AFCommon::QueueLog("Monitor zombie: " + v_generateInfoString( false));
+			m_monitors->unindexMonitor( this);
 			setZombie();
 		}
 	}
@@ -76,6 +78,7 @@ void MonitorAf::v_refresh( time_t currentTime, AfContainer * pointer, MonitorCon
 void MonitorAf::deregister()
 {
 	AFCommon::QueueLog("Monitor deregister: " + v_generateInfoString( false));
+	m_monitors->unindexMonitor( this);
 	setZombie();
 	m_monitors->addEvent( af::Monitor::EVT_monitors_del, getId());
 }
@@ -123,7 +126,11 @@ void MonitorAf::v_action( Action & i_action)
 				af::jr_int32("uid", new_uid, operation);
 				i_action.answerLog("Permissions set.");
 				if( new_uid >= 0 )
+				{
+					m_monitors->subscribeUid( this, m_uid, false);
 					m_uid = new_uid;
+					m_monitors->subscribeUid( this, m_uid, true);
+				}
 			}
 			else if( opclass == "jobs")
 			{
@@ -228,6 +235,7 @@ void MonitorAf::setEvents( const std::vector<int32_t> & i_ids, bool value)
 		if(( eventNum >= 0) && ( eventNum < EVT_COUNT))
 		{
 			m_events[eventNum] = value;
+			m_monitors->subscribeEvent( this, eventNum, value);
 		}
 		else
 		{
@@ -265,6 +273,7 @@ void MonitorAf::addJobIds( const std::vector<int32_t> & i_ids)
 		if( hasJobId( i_ids[i]) == false)
 		{
 			m_jobsIds.push_back( i_ids[i]);
+			m_monitors->subscribeJob( this, i_ids[i], true);
 		}
 	}
 }
@@ -272,7 +281,11 @@ void MonitorAf::addJobIds( const std::vector<int32_t> & i_ids)
 void MonitorAf::delJobIds( const std::vector<int32_t> & i_ids)
 {
 //printf("MonitorAf::delJobIds:[%d]",getId());for(int i=0;i<i_ids.size();i++)printf(" %d",i_ids[i]);printf("\n");
-	for( int i = 0; i < i_ids.size(); i++) m_jobsIds.remove( i_ids[i]);
+	for( int i = 0; i < i_ids.size(); i++)
+	{
+		m_jobsIds.remove( i_ids[i]);
+		m_monitors->subscribeJob( this, i_ids[i], false);
+	}
 }
 
 void MonitorAf::addEvents( int i_type, const std::list<int32_t> & i_ids)
@@ -293,7 +306,7 @@ void MonitorAf::addEvents( int i_type, const std::list<int32_t> & i_ids)
 //printf("MonitorAf::addEvents: i_ids.size()=%lu\n", i_ids.size());
 }
 
-void MonitorAf::addTaskProgress( int i_j, int i_b, int i_t, const af::TaskProgress * i_tp)
+void MonitorAf::addTaskProgress( int i_j, int i_b, int i_t, const af::TaskProgressView & i_tp)
 {
 //std::ostringstream str;af::jw_state( i_tp->state, str);printf("MonitorAf::addTaskProgress():j=%d b=%d t=%d s='%s'\n", i_j, i_b, i_t, str.str().c_str());
 
@@ -462,9 +475,7 @@ af::Msg * MonitorAf::getEventsJSON()
 {
 	updateTime();
 
-	af::Msg * msg = new af::Msg();
-
-	std::ostringstream stream;
+	af::MsgStream stream;
 	stream << "{\"events\":";
 
 	DlScopeLocker mutex( &m_mutex);
@@ -476,13 +487,20 @@ af::Msg * MonitorAf::getEventsJSON()
 
 //if( hasevents ) printf("MonitorAf::getEvents():\n%s\n", stream.str().c_str());
 
-	msg->setData( stream.str().size(), stream.str().c_str(), af::Msg::TJSON);
+	af::Msg * msg = af::jsonMsg( stream);
 
 	m_e.clear();
 
 	return msg;
 }
 
+bool MonitorAf::hasEvents()
+{
+	DlScopeLocker mutex( &m_mutex);
+
+	return false == m_e.isEmpty();
+}
+
 void MonitorAf::prepareEvents()
 {
 	//
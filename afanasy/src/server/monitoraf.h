@@ -37,7 +37,10 @@ public:
 	af::Msg * getEventsBin();
 	af::Msg * getEventsJSON();
 
-	void addTaskProgress( int i_j, int i_b, int i_t, const af::TaskProgress * i_tp);
+	/// Whether monitor has events to get, called to answer waiting events requests.
+	bool hasEvents();
+
+	void addTaskProgress( int i_j, int i_b, int i_t, const af::TaskProgressView & i_tp);
 
 	void addBlock( int i_j, int i_b, int i_mode);
 
@@ -8,6 +8,7 @@
 #include "../libafanasy/msgclasses/mctaskpos.h"
 #include "../libafanasy/msgclasses/mctasksprogress.h"
 #include "../libafanasy/msg.h"
+#include "../libafanasy/msgbufferpool.h"
 
 #include "afcommon.h"
 #include "renderaf.h"
@@ -23,11 +24,13 @@ MonitorContainer::MonitorContainer():
 	AfContainer( "Monitors", AFMONITOR::MAXCOUNT),
 	m_events( NULL),
 	m_jobEvents( NULL),
-	m_jobEventsUids( NULL)
+	m_jobEventsUids( NULL),
+	m_event_monitors( NULL)
 {
 	MonitorAf::setMonitorContainer( this);
 
 	m_events = new std::list<int32_t>[ af::Monitor::EVT_COUNT];
+	m_event_monitors = new std::set<MonitorAf*>[ af::Monitor::EVT_COUNT];
 	m_jobEvents	  = new std::list<int32_t>[ af::Monitor::EVT_JOBS_COUNT];
 	m_jobEventsUids = new std::list<int32_t>[ af::Monitor::EVT_JOBS_COUNT];
 AFINFA("MonitorContainer::MonitorContainer: Events Count = %d, Job Events = %d\n", af::Monitor::EVT_COUNT, af::Monitor::EVT_JOBS_COUNT);
@@ -39,6 +42,7 @@ AFINFO("MonitorContainer::~MonitorContainer:\n");
 	if( m_events        != NULL ) delete [] m_events;
 	if( m_jobEvents     != NULL ) delete [] m_jobEvents;
 	if( m_jobEventsUids != NULL ) delete [] m_jobEventsUids;
+	if( m_event_monitors != NULL ) delete [] m_event_monitors;
 }
 
 af::Msg * MonitorContainer::addMonitor( MonitorAf * i_monitor, bool i_binary)
@@ -47,6 +51,7 @@ af::Msg * MonitorContainer::addMonitor( MonitorAf * i_monitor, bool i_binary)
 	{
 		i_monitor->setRegisterTime();
 		AFCommon::QueueLog("Monitor registered: " + i_monitor->v_generateInfoString( false));
+		indexMonitor( i_monitor);
 		addEvent( af::Monitor::EVT_monitors_add, i_monitor->getId());
 	}
 	else
@@ -57,7 +62,7 @@ af::Msg * MonitorContainer::addMonitor( MonitorAf * i_monitor, bool i_binary)
 	if( i_binary )
 		return new af::Msg( af::Msg::TMonitor, i_monitor);
 
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{\"monitor\":";
 	i_monitor->v_jsonWrite( str, 0);
 	str << "}";
@@ -75,6 +80,76 @@ void MonitorContainer::addEvent( int i_type, int i_nodeId)
 	af::addUniqueToList( m_events[i_type], i_nodeId);
 }
 
+void MonitorContainer::subscribeEvent( MonitorAf * i_monitor, int i_type, bool i_subscribe)
+{
+	if(( i_type < 0 ) || ( i_type >= af::Monitor::EVT_COUNT))
+		return;
+
+	if( i_subscribe )
+		m_event_monitors[i_type].insert( i_monitor);
+	else
+		m_event_monitors[i_type].erase( i_monitor);
+}
+
+void MonitorContainer::subscribeJob( MonitorAf * i_monitor, int32_t i_jid, bool i_subscribe)
+{
+	if( i_subscribe )
+	{
+		m_job_monitors[i_jid].insert( i_monitor);
+		return;
+	}
+
+	std::map<int32_t, std::set<MonitorAf*> >::iterator it = m_job_monitors.find( i_jid);
+	if( it == m_job_monitors.end())
+		return;
+
+	it->second.erase( i_monitor);
+	if( it->second.empty())
+		m_job_monitors.erase( it);
+}
+
+void MonitorContainer::subscribeUid( MonitorAf * i_monitor, int32_t i_uid, bool i_subscribe)
+{
+	if( i_subscribe )
+	{
+		m_uid_monitors[i_uid].insert( i_monitor);
+		return;
+	}
+
+	std::map<int32_t, std::set<MonitorAf*> >::iterator it = m_uid_monitors.find( i_uid);
+	if( it == m_uid_monitors.end())
+		return;
+
+	it->second.erase( i_monitor);
+	if( it->second.empty())
+		m_uid_monitors.erase( it);
+}
+
+void MonitorContainer::indexMonitor( MonitorAf * i_monitor)
+{
+	for( int e = 0; e < af::Monitor::EVT_COUNT; e++)
+		if( i_monitor->hasEvent( e))
+			subscribeEvent( i_monitor, e, true);
+
+	const std::list<int32_t> * jids = i_monitor->getJobsIds();
+	for( std::list<int32_t>::const_iterator it = jids->begin(); it != jids->end(); it++)
+		subscribeJob( i_monitor, *it, true);
+
+	subscribeUid( i_monitor, i_monitor->getUid(), true);
+}
+
+void MonitorContainer::unindexMonitor( MonitorAf * i_monitor)
+{
+	for( int e = 0; e < af::Monitor::EVT_COUNT; e++)
+		subscribeEvent( i_monitor, e, false);
+
+	const std::list<int32_t> * jids = i_monitor->getJobsIds();
+	for( std::list<int32_t>::const_iterator it = jids->begin(); it != jids->end(); it++)
+		subscribeJob( i_monitor, *it, false);
+
+	subscribeUid( i_monitor, i_monitor->getUid(), false);
+}
+
 void MonitorContainer::addJobEvent( int i_type, int i_jid, int i_uid)
 {
 	if(( i_type < 0 ) || ( i_type >= af::Monitor::EVT_JOBS_COUNT ))
@@ -133,10 +208,9 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	{
 		if( m_events[e].size() < 1) continue;
 
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
-			if( monitor->hasEvent( e))
-				monitor->addEvents( e, m_events[e]);
+		std::set<MonitorAf*>::iterator mIt = m_event_monitors[e].begin();
+		for( ; mIt != m_event_monitors[e].end(); mIt++)
+			(*mIt)->addEvents( e, m_events[e]);
 	}
 
 
@@ -154,29 +228,26 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 			continue;
 		}
 
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
-		{
-			std::list<int32_t> ids;
-			bool found = false;
+		// Group jobs ids by user id:
+		std::map<int32_t, std::list<int32_t> > uids_jids;
+		std::list<int32_t>::const_iterator jIt = m_jobEvents[e].begin();
+		std::list<int32_t>::const_iterator uIt = m_jobEventsUids[e].begin();
+		for( ; jIt != m_jobEvents[e].end(); jIt++, uIt++)
+			uids_jids[*uIt].push_back( *jIt);
 
-			std::list<int32_t>::const_iterator jIt = m_jobEvents[e].begin();
-			std::list<int32_t>::const_iterator jIt_end = m_jobEvents[e].end();
-			std::list<int32_t>::const_iterator uIt = m_jobEventsUids[e].begin();
-
-			while( jIt != jIt_end)
+		std::set<MonitorAf*>::iterator mIt = m_event_monitors[e].begin();
+		for( ; mIt != m_event_monitors[e].end(); mIt++)
+		{
+			// Monitor with zero user id receives all jobs events:
+			if( (*mIt)->getUid() == 0 )
 			{
-				if( monitor->hasJobEvent( e, *uIt))
-				{
-					if( !found) found = true;
-						ids.push_back( *jIt);
-				}
-				jIt++;
-				uIt++;
+				(*mIt)->addEvents( e, m_jobEvents[e]);
+				continue;
 			}
-			if( ! found ) continue;
 
-			monitor->addEvents( e, ids);
+			std::map<int32_t, std::list<int32_t> >::const_iterator it = uids_jids.find( (*mIt)->getUid());
+			if( it != uids_jids.end())
+				(*mIt)->addEvents( e, it->second);
 		}
 	}
 
@@ -185,39 +256,42 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	// Tasks progress events:
 	//
 	std::list<af::MCTasksProgress*>::const_iterator tIt = m_tasks.begin();
-	while( tIt != m_tasks.end())
+	for( ; tIt != m_tasks.end(); tIt++)
 	{
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
+		std::map<int32_t, std::set<MonitorAf*> >::const_iterator it = m_job_monitors.find( (*tIt)->getJobId());
+		if( it == m_job_monitors.end())
+			continue;
+
+		std::set<MonitorAf*>::const_iterator mIt = it->second.begin();
+		for( ; mIt != it->second.end(); mIt++)
 		{
-			if( monitor->hasJobId( (*tIt)->getJobId()))
+			const std::list<af::TaskProgressView> * progresses  = (*tIt)->getTasksRun();
+			std::list<int32_t>::const_iterator blocksIt = (*tIt)->getBlocks()->begin();
+			std::list<int32_t>::const_iterator tasksIt = (*tIt)->getTasks()->begin();
+			std::list<af::TaskProgressView>::const_iterator progressIt = progresses->begin();
+			while( progressIt != progresses->end())
 			{
-				const std::list<af::TaskProgress*> * progresses  = (*tIt)->getTasksRun();
-				std::list<int32_t>::const_iterator blocksIt = (*tIt)->getBlocks()->begin();
-				std::list<int32_t>::const_iterator tasksIt = (*tIt)->getTasks()->begin();
-				std::list<af::TaskProgress*>::const_iterator progressIt = progresses->begin();
-				while( progressIt != progresses->end())
-				{
-					monitor->addTaskProgress( (*tIt)->getJobId(), *blocksIt, *tasksIt, *progressIt);
-					blocksIt++; tasksIt++; progressIt++;
-				}
+				(*mIt)->addTaskProgress( (*tIt)->getJobId(), *blocksIt, *tasksIt, *progressIt);
+				blocksIt++; tasksIt++; progressIt++;
 			}
 		}
-		tIt++;
 	}
 
 	//
 	// Blocks changed:
 	//
 	{
-	MonitorContainerIt monitorsIt( this);
-	for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
+	std::list<af::BlockData*>::iterator bIt = m_blocks.begin();
+	std::list<int32_t>::iterator tIt = m_blocks_types.begin();
+	for( ; bIt != m_blocks.end(); bIt++, tIt++)
 	{
-		std::list<af::BlockData*>::iterator bIt = m_blocks.begin();
-		std::list<int32_t>::iterator tIt = m_blocks_types.begin();
-		for( ; bIt != m_blocks.end(); bIt++, tIt++)
-			if( monitor->hasJobId( (*bIt)->getJobId()))
-				monitor->addBlock( (*bIt)->getJobId(), (*bIt)->getBlockNum(), *tIt);
+		std::map<int32_t, std::set<MonitorAf*> >::const_iterator it = m_job_monitors.find( (*bIt)->getJobId());
+		if( it == m_job_monitors.end())
+			continue;
+
+		std::set<MonitorAf*>::const_iterator mIt = it->second.begin();
+		for( ; mIt != it->second.end(); mIt++)
+			(*mIt)->addBlock( (*bIt)->getJobId(), (*bIt)->getBlockNum(), *tIt);
 	}
 	}
 
@@ -226,15 +300,17 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	//
 	{
 	std::list<UserAf*>::iterator uIt = m_usersJobOrderChanged.begin();
-	while( uIt != m_usersJobOrderChanged.end())
+	for( ; uIt != m_usersJobOrderChanged.end(); uIt++)
 	{
+		std::map<int32_t, std::set<MonitorAf*> >::const_iterator it = m_uid_monitors.find( (*uIt)->getId());
+		if( it == m_uid_monitors.end())
+			continue;
+
 		std::vector<int32_t> jids = (*uIt)->generateJobsIds();
 
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
-			if( monitor->sameUid((*uIt)->getId()))
-				monitor->setUserJobsOrder( jids);
-		uIt++;
+		std::set<MonitorAf*>::const_iterator mIt = it->second.begin();
+		for( ; mIt != it->second.end(); mIt++)
+			(*mIt)->setUserJobsOrder( jids);
 	}
 	}
 
@@ -284,6 +360,20 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	clearEvents();
 }
 
+bool MonitorContainer::jobsChanged() const
+{
+	for( int e = 0; e < af::Monitor::EVT_JOBS_COUNT; e++)
+		if( m_jobEvents[e].size()) return true;
+
+	return m_blocks.size() || m_usersJobOrderChanged.size();
+}
+
+bool MonitorContainer::rendersChanged() const
+{
+	return m_events[af::Monitor::EVT_renders_add].size() || m_events[af::Monitor::EVT_renders_change].size()
+		|| m_events[af::Monitor::EVT_renders_del].size();
+}
+
 void MonitorContainer::clearEvents()
 {
 	for( int e = 0; e < af::Monitor::EVT_COUNT; e++) m_events[e].clear();
@@ -313,7 +403,7 @@ void MonitorContainer::clearEvents()
 	m_announcement.clear();
 }
 
-void MonitorContainer::addTask( int i_jobid, int i_block, int i_task, af::TaskProgress * i_tp)
+void MonitorContainer::addTask( int i_jobid, int i_block, int i_task, const af::TaskProgressView & i_tp)
 {
 	af::MCTasksProgress * t = NULL;
 
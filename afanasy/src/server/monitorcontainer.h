@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <set>
+
 #include "afcontainer.h"
 #include "afcontainerit.h"
 
@@ -30,7 +33,7 @@ public:
 
    void addJobEvent( int i_type, int i_jid, int i_uid);
 
-   void addTask( int i_jobid, int i_block, int i_task, af::TaskProgress * i_tp);
+   void addTask( int i_jobid, int i_block, int i_task, const af::TaskProgressView & i_tp);
 
    void addBlock( int i_type, af::BlockData * i_block);
 
@@ -42,6 +45,22 @@ public:
 
    void dispatch( RenderContainer * i_renders);
 
+	/// Whether jobs, their blocks or users jobs order were changed since the last dispatch.
+	bool jobsChanged() const;
+
+	/// Whether renders were added, changed or deleted since the last dispatch.
+	bool rendersChanged() const;
+
+	/// Subscriptions indexes, dispatch delivers events only to subscribed monitors.
+	/// Monitor should call them on its subscriptions change.
+	void subscribeEvent( MonitorAf * i_monitor, int i_type, bool i_subscribe);
+	void subscribeJob( MonitorAf * i_monitor, int32_t i_jid, bool i_subscribe);
+	void subscribeUid( MonitorAf * i_monitor, int32_t i_uid, bool i_subscribe);
+
+	/// Add monitor to indexes on registration and remove it when it becomes zombie.
+	void indexMonitor( MonitorAf * i_monitor);
+	void unindexMonitor( MonitorAf * i_monitor);
+
 private:
 
 	std::list<int32_t> * m_events;
@@ -60,6 +79,13 @@ private:
 
 	std::string m_announcement;
 
+	/// Monitors subscribed on each event type.
+	std::set<MonitorAf*> * m_event_monitors;
+	/// Monitors by user id, to dispatch job events and user jobs order.
+	std::map<int32_t, std::set<MonitorAf*> > m_uid_monitors;
+	/// Monitors watching job tasks and blocks by job id.
+	std::map<int32_t, std::set<MonitorAf*> > m_job_monitors;
+
    void clearEvents();
 };
 
@@ -45,7 +45,7 @@ PoolSrv::PoolSrv(const std::string & i_store_dir):
 	AfNodeFarm(this, this, AfNodeFarm::TPool, NULL, i_store_dir)
 {
 	int size;
-	char * data = af::fileRead(getStoreFile(), &size);
+	char * data = AFCommon::readStoreFile(getStoreFile(), &size);
 	if (data == NULL) return;
 
 	rapidjson::Document document;
@@ -113,6 +113,20 @@ PoolSrv::~PoolSrv()
 {
 }
 
+void PoolSrv::v_postAction(Action & i_action)
+{
+	updateRendersReady();
+}
+
+void PoolSrv::updateRendersReady()
+{
+	for (auto & it : m_pools_list)
+		it->updateRendersReady();
+
+	for (auto & it : m_renders_list)
+		it->updateReady();
+}
+
 void PoolSrv::v_action(Action & i_action)
 {
 	const JSON & operation = (*i_action.data)["operation"];
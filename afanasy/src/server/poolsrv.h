@@ -46,6 +46,12 @@ public:
 
 	virtual void v_action(Action & i_action);
 
+	/// Pool parameters affect its renders ready state.
+	virtual void v_postAction(Action & i_action);
+
+	/// Update ready state of renders of the pool and its child pools.
+	void updateRendersReady();
+
 	void logAction(const Action & i_action, const std::string & i_node_name);
 
 	virtual int v_calcWeight() const;
@@ -0,0 +1,130 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Rate limiter.
+	Allows some events per second for each key (for example client address or message type).
+	Each key has a bucket of tokens, that is refilled by rate and can hold a burst.
+	Denied events can get a retry time: retries are spread in future by rate,
+	so a storm of clients comes back one by one, not all at once.
+*/
+#include "ratelimiter.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/name_af.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+RateLimiter::RateLimiter( const std::string & i_name, int i_rate, int i_burst):
+	m_name( i_name),
+	m_rate( i_rate),
+	m_burst( i_burst),
+	m_cleanup_time( 0),
+	m_retry_time( 0),
+	m_stat_allowed( 0),
+	m_stat_denied( 0),
+	m_stat_retry_max( 0)
+{
+	if( m_burst < 1 )
+		m_burst = 1;
+}
+
+RateLimiter::~RateLimiter()
+{
+}
+
+bool RateLimiter::allow( const std::string & i_key, int * o_retry_sec)
+{
+	if( m_rate <= 0 )
+		return true;
+
+	int64_t now = af::getMonotonicMSec();
+
+	DlScopeLocker lock( &m_mutex);
+
+	cleanup( now);
+
+	std::map<std::string, Bucket>::iterator it = m_buckets.find( i_key);
+	if( it == m_buckets.end())
+	{
+		Bucket bucket;
+		bucket.tokens = m_burst;
+		bucket.time = now;
+		it = m_buckets.insert( std::make_pair( i_key, bucket)).first;
+	}
+
+	Bucket & bucket = it->second;
+	bucket.tokens += double( now - bucket.time) * m_rate / 1000.0;
+	if( bucket.tokens > m_burst )
+		bucket.tokens = m_burst;
+	bucket.time = now;
+
+	if( bucket.tokens >= 1.0 )
+	{
+		bucket.tokens -= 1.0;
+		m_stat_allowed++;
+		return true;
+	}
+
+	m_stat_denied++;
+
+	if( o_retry_sec )
+	{
+		// Give each denied event the next free slot in future:
+		if( m_retry_time < now )
+			m_retry_time = now;
+		m_retry_time += 1000 / m_rate + 1;
+
+		*o_retry_sec = int(( m_retry_time - now ) / 1000 ) + 1;
+		if( m_stat_retry_max < *o_retry_sec )
+			m_stat_retry_max = *o_retry_sec;
+	}
+
+	return false;
+}
+
+void RateLimiter::cleanup( int64_t i_now)
+{
+	// Full buckets store nothing, they are deleted not to grow with clients number:
+	if( i_now - m_cleanup_time < 60000 )
+		return;
+	m_cleanup_time = i_now;
+
+	std::map<std::string, Bucket>::iterator it = m_buckets.begin();
+	while( it != m_buckets.end())
+	{
+		if( it->second.tokens + double( i_now - it->second.time) * m_rate / 1000.0 >= m_burst )
+			m_buckets.erase( it++);
+		else
+			it++;
+	}
+}
+
+void RateLimiter::writeStat( std::ostringstream & o_str)
+{
+	if( m_rate <= 0 )
+		return;
+
+	DlScopeLocker lock( &m_mutex);
+
+	o_str << "\n" << m_name << " rate limit " << m_rate << "/s: allowed " << m_stat_allowed << ", denied " << m_stat_denied;
+	if( m_stat_retry_max )
+		o_str << ", retry max " << m_stat_retry_max << "s";
+	o_str << ", keys " << m_buckets.size();
+
+	m_stat_allowed = 0;
+	m_stat_denied = 0;
+	m_stat_retry_max = 0;
+}
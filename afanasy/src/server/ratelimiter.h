@@ -0,0 +1,69 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Rate limiter.
+	Allows some events per second for each key (for example client address or message type).
+	Each key has a bucket of tokens, that is refilled by rate and can hold a burst.
+	Denied events can get a retry time: retries are spread in future by rate,
+	so a storm of clients comes back one by one, not all at once.
+*/
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <stdint.h>
+
+#include "../libafanasy/common/dlMutex.h"
+
+class RateLimiter
+{
+public:
+	/// Zero \c i_rate allows everything.
+	RateLimiter( const std::string & i_name, int i_rate, int i_burst);
+	~RateLimiter();
+
+	inline bool isEnabled() const { return m_rate > 0; }
+
+	/// Whether an event of the key is allowed now.
+	/// If it is denied and \c o_retry_sec is not NULL, seconds to retry after are set.
+	bool allow( const std::string & i_key, int * o_retry_sec = NULL);
+
+	/// Write statistics since the previous call.
+	void writeStat( std::ostringstream & o_str);
+
+private:
+	struct Bucket
+	{
+		double  tokens;
+		int64_t time;
+	};
+
+	void cleanup( int64_t i_now);
+
+private:
+	std::string m_name;
+
+	int m_rate;
+	int m_burst;
+
+	DlMutex m_mutex;
+	std::map<std::string, Bucket> m_buckets;
+	int64_t m_cleanup_time;
+
+	/// Last time given to a denied event to retry.
+	int64_t m_retry_time;
+
+	int64_t m_stat_allowed;
+	int64_t m_stat_denied;
+	int     m_stat_retry_max;
+};
@@ -15,8 +15,10 @@
 */
 #include "renderaf.h"
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/environment.h"
 #include "../libafanasy/msg.h"
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgqueue.h"
 #include "../libafanasy/regexp.h"
 
@@ -25,6 +27,7 @@
 #include "jobcontainer.h"
 #include "monitorcontainer.h"
 #include "poolscontainer.h"
+#include "renderconnections.h"
 #include "rendercontainer.h"
 #include "sysjob.h"
 
@@ -49,7 +52,7 @@ RenderAf::RenderAf( const std::string & i_store_dir):
 	initDefaultValues();
 
 	int size;
-	char * data = af::fileRead( getStoreFile(), &size);
+	char * data = AFCommon::readStoreFile( getStoreFile(), &size);
 	if( data == NULL ) return;
 
 	rapidjson::Document document;
@@ -85,10 +88,33 @@ void RenderAf::initDefaultValues()
 
 	m_overload_time  = 0;
 	m_overload_seconds = 0;
+
+	m_ready_index = -1;
+	m_solve_key = SolveKey();
 }
 
 RenderAf::~RenderAf()
 {
+	if (ms_renders)
+		ms_renders->removeReady(this);
+}
+
+void RenderAf::updateReady()
+{
+	if (ms_renders)
+		ms_renders->updateReady(this);
+}
+
+void RenderAf::updateSolveKey()
+{
+	m_solve_key.online                  = isOnline();
+	m_solve_key.pool_priority           = calcPoolPriority();
+	m_solve_key.tasks_num               = getTasksNumber();
+	m_solve_key.capacity_free           = findCapacityFree();
+	m_solve_key.priority                = getPriority();
+	m_solve_key.tasks_start_finish_time = getTasksStartFinishTime();
+	m_solve_key.capacity                = findCapacity();
+	m_solve_key.max_tasks               = findMaxTasks();
 }
 
 void RenderAf::setRegistered(PoolsContainer * i_pools)
@@ -157,6 +183,8 @@ void RenderAf::setPool(PoolSrv * i_pool)
 {
 	m_pool = i_pool->getName();
 	m_parent = i_pool;
+
+	updateReady();
 }
 
 void RenderAf::offline( JobContainer * jobs, uint32_t updateTaskState, MonitorContainer * monitoring, bool toZombie )
@@ -175,6 +203,8 @@ void RenderAf::offline( JobContainer * jobs, uint32_t updateTaskState, MonitorCo
 	// There is need to send pending tasks to offline render.
 	m_re.clearTaskExecs();
 
+	updateReady();
+
 	appendLog( m_hres.v_generateInfoString());
 
 	if( toZombie )
@@ -187,6 +217,7 @@ void RenderAf::offline( JobContainer * jobs, uint32_t updateTaskState, MonitorCo
 			if (monitoring) monitoring->addEvent( af::Monitor::EVT_pools_change, m_parent->getId());
 		}
 		setZombie();
+		updateReady();
 		if (monitoring) monitoring->addEvent( af::Monitor::EVT_renders_del, m_id);
 	}
 	else
@@ -221,6 +252,20 @@ af::Msg * RenderAf::writeRenderEventsMsg()
 	return msg;
 }
 
+void RenderAf::v_jsonWrite( std::ostringstream & o_str, int i_type) const
+{
+	DlScopeLocker lock( &m_update_mutex);
+
+	af::Render::v_jsonWrite( o_str, i_type);
+}
+
+void RenderAf::v_readwrite( af::Msg * msg)
+{
+	DlScopeLocker lock( &m_update_mutex);
+
+	af::Render::v_readwrite( msg);
+}
+
 af::Msg * RenderAf::writeConnectedMsg(const std::string & i_log)
 {
 	m_re.m_log = i_log;
@@ -232,10 +277,12 @@ af::Msg * RenderAf::writeConnectedMsg(const std::string & i_log)
 
 af::Msg * RenderAf::update( const af::RenderUpdate & i_up)
 {
+	DlScopeLocker lock( &m_update_mutex);
+
 	updateTime();
 
 	if( i_up.hasResources())
-		m_hres.copy( *i_up.getResources());
+		m_hres.copyDelta( *i_up.getResources());
 
 	if( i_up.m_taskups.size())
 		for( int i = 0; i < i_up.m_taskups.size(); i++)
@@ -294,6 +341,8 @@ void RenderAf::online( RenderAf * render, JobContainer * i_jobs, MonitorContaine
 	std::string str = "Online '" + m_engine + "'.";
 	appendLog( str);
 
+	updateReady();
+
 	if( monitoring )
 		monitoring->addEvent( af::Monitor::EVT_renders_change, m_id);
 
@@ -373,6 +422,11 @@ void RenderAf::startTask( af::TaskExec *taskexec)
 	taskexec->v_stdOut( false);
 }
 
+void RenderAf::v_postAction( Action & i_action)
+{
+	updateReady();
+}
+
 void RenderAf::v_action( Action & i_action)
 {
 	const JSON & params = (*i_action.data)["params"];
@@ -649,6 +703,7 @@ void RenderAf::wolSleep( MonitorContainer * monitoring)
 	}
 
 	setWOLFalling( true);
+	updateReady();
 	appendLog("Sending WOL sleep request.");
 	m_wol_operation_time = time( NULL);
 	store();
@@ -766,6 +821,7 @@ void RenderAf::addErrorTask(const af::TaskExec * i_exec)
 	if (m_error_tasks.size() >= SickErrorsCount)
 	{
 		setSick();
+		updateReady();
 		emitEvents(std::vector<std::string>(1, "RENDER_SICK"));
 		std::string msg = std::string("Got sick after ") + af::itos(SickErrorsCount) + " errors:";
 		for (const auto & it : m_error_tasks)
@@ -867,6 +923,9 @@ void RenderAf::addTask(af::TaskExec * i_taskexec, MonitorContainer * i_monitorin
 
 	// Acuire task on pool
 	m_parent->taskAcuire(i_taskexec, new_tickets, i_monitoring);
+
+	// Render can be not ready any more (capacity or maximum tasks reached):
+	updateReady();
 }
 
 void RenderAf::removeTask(const af::TaskExec * i_taskexec, MonitorContainer * i_monitoring)
@@ -923,6 +982,8 @@ void RenderAf::removeTask(const af::TaskExec * i_taskexec, MonitorContainer * i_
 
 	// Release task on pool
 	m_parent->taskRelease(i_taskexec, exp_tickets, i_monitoring);
+
+	updateReady();
 }
 
 void RenderAf::v_refresh( time_t i_current_time,  AfContainer * pointer, MonitorContainer * monitoring)
@@ -1019,11 +1080,17 @@ void RenderAf::v_refresh( time_t i_current_time,  AfContainer * pointer, Monitor
 	if (dummy_ticket_found)
 		monitoring->addEvent(af::Monitor::EVT_renders_change, m_id);
 
+	// Idle and busy times are changed without an event, but they are in renders list:
+	const int64_t idle_time = m_idle_time;
+	const int64_t busy_time = m_busy_time;
+
 	// Later auto nimby operations not needed if render is not online:
 	if( isOffline())
 	{
 		m_busy_time = i_current_time;
 		m_idle_time = i_current_time;
+		if(( m_idle_time != idle_time ) || ( m_busy_time != busy_time ))
+			ms_renders->setSnapshotDirty();
 		return;
 	}
 
@@ -1165,6 +1232,9 @@ void RenderAf::v_refresh( time_t i_current_time,  AfContainer * pointer, Monitor
 			}
 		}
 	}
+
+	if(( m_idle_time != idle_time ) || ( m_busy_time != busy_time ))
+		ms_renders->setSnapshotDirty();
 }
 
 void RenderAf::v_postSolve(time_t i_current_time, MonitorContainer * i_monitoring)
@@ -1186,6 +1256,17 @@ void RenderAf::v_postSolve(time_t i_current_time, MonitorContainer * i_monitorin
 		if (i_monitoring)
 			i_monitoring->addEvent(af::Monitor::EVT_renders_change, m_id);
 	}
+
+	// Push events (started tasks, stops, listens) if render keeps connection,
+	// not to wait for its next update.
+	if (isOnline() && (false == m_re.isEmpty()))
+	{
+		m_re.m_id = m_id;
+		if (RenderConnections::Push(m_id, &m_re))
+			m_re.clear();
+		else
+			m_re.m_id = 0;
+	}
 }
 
 void RenderAf::appendTasksLog( const std::string & message)
@@ -1330,6 +1411,8 @@ void RenderAf::emitEvents(const std::vector<std::string> & i_events) const
 
 af::Msg * RenderAf::writeFullInfo( bool i_binary) const
 {
+	DlScopeLocker lock( &m_update_mutex);
+
 	if (i_binary)
 	{
 		af::Msg * o_msg = new af::Msg();
@@ -1351,7 +1434,7 @@ af::Msg * RenderAf::writeFullInfo( bool i_binary) const
 		return o_msg;
 	}
 
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{\"object\":{";
 
 	str << "\"name\":\"" << m_name << "\"";
@@ -2,9 +2,11 @@
 
 #include "../include/afjob.h"
 
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/msgclasses/mctaskup.h"
 #include "../libafanasy/render.h"
 #include "../libafanasy/renderevents.h"
+#include "../libafanasy/rendersranking.h"
 #include "../libafanasy/renderupdate.h"
 #include "../libafanasy/taskexec.h"
 
@@ -80,6 +82,12 @@ public:
 
 	bool hasTickets(const std::map<std::string, int32_t> & i_tickets) const;
 
+/// Render parameters to choose the most ready render to solve a task on.
+/// They are stored to not to calculate them on each solving comparison.
+	typedef af::RendersRanking::Key SolveKey;
+
+	inline const SolveKey & getSolveKey() const { return m_solve_key; }
+
 /// Add task \c taskexec to render, \c start or only capture it
 /// Takes over the taskexec ownership
 	void setTask( af::TaskExec *taskexec, MonitorContainer * monitoring, bool start = true);
@@ -115,6 +123,12 @@ public:
 
 	virtual void v_action( Action & i_action);
 
+	/// Render parameters can be changed by action, ready state should be updated.
+	virtual void v_postAction( Action & i_action);
+
+	/// Update render presence in container ready renders.
+	void updateReady();
+
 	inline const std::list<std::string> & getTasksLog() { return m_tasks_log; }  ///< Get tasks log list.
 
 	virtual int v_calcWeight() const; ///< Calculate and return memory size.
@@ -122,9 +136,14 @@ public:
 	// Write this message back to the new launched render
 	af::Msg * writeConnectedMsg(const std::string & i_log);
 
-	// Update render and send instructions back:
+	// Update render and send instructions back.
+	// Called with container read lock only, update state is guarded by render update mutex.
 	af::Msg * update( const af::RenderUpdate & i_up);
 
+	/// Render writing locks update mutex, as render can be updated while container is read locked.
+	virtual void v_jsonWrite( std::ostringstream & o_str, int i_type) const;
+	virtual void v_readwrite( af::Msg * msg);
+
 	// Need for server to write some farm parameters (gui double-click):
 	af::Msg * writeFullInfo( bool binary) const;
 
@@ -176,6 +195,9 @@ private:
 
 	void wolSleep( MonitorContainer * monitoring);
 
+	/// Store current render parameters for solving.
+	void updateSolveKey();
+
 	void appendTasksLog( const std::string & message);  ///< Append tasks log with a \c message .
 
 	/**
@@ -192,6 +214,9 @@ private:
 
 	af::RenderEvents m_re;
 
+	/// Guards update time, host resources and events, changed by updates under container read lock.
+	mutable DlMutex m_update_mutex;
+
 	struct ErrorTaskData
 	{
 		int64_t when;
@@ -207,7 +232,14 @@ private:
 	int64_t m_overload_time;
 	int m_overload_seconds;
 
+	/// Position in container ready renders, negative if render is not there.
+	int m_ready_index;
+
+	/// Updated with ready renders, on each render change.
+	SolveKey m_solve_key;
+
 private:
 	static RenderContainer * ms_renders;
 
+	friend class RenderContainer;
 };
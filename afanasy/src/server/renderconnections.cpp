@@ -0,0 +1,489 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Render kept connections.
+	Render can ask server to keep its connection (TRenderConnect message).
+	Sockets processing hands such socket over here after the answer is written.
+	One thread polls all kept connections, it does only sockets IO:
+	it reads render updates and passes them to sockets processing threads,
+	writes back their answers and render events pushed by run thread after solving.
+	Processing can wait for containers locks, so it is not done by polling thread.
+	Connections are deleted by polling thread only, other threads just mark them closing.
+*/
+#include "renderconnections.h"
+
+#ifndef WINNT
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/common/dlThread.h"
+#include "../libafanasy/environment.h"
+#include "../libafanasy/msg.h"
+#include "../libafanasy/renderevents.h"
+
+#include "afcommon.h"
+#include "socketsprocessing.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+extern bool AFRunning;
+
+RenderConnections * RenderConnections::ms_this = NULL;
+
+RenderConnections::RenderConnections( ThreadArgs * i_args):
+	m_args( i_args),
+	m_thread( NULL),
+	m_serial( 0),
+	m_stat_time( 0),
+	m_stat_updates( 0),
+	m_stat_pushes( 0),
+	m_stat_added( 0),
+	m_stat_closed( 0)
+{
+	#ifndef WINNT
+	// Pipe is needed to wake polling thread, when there is something to write:
+	if( pipe( m_wake_pipe) != 0 )
+	{
+		AF_ERR << "Render connections pipe: " << strerror( errno);
+		return;
+	}
+	for( int i = 0; i < 2; i++)
+		fcntl( m_wake_pipe[i], F_SETFL, fcntl( m_wake_pipe[i], F_GETFL) | O_NONBLOCK);
+
+	ms_this = this;
+
+	m_thread = new DlThread();
+	m_thread->Start( ThreadFunc, NULL);
+	#endif
+}
+
+RenderConnections::~RenderConnections()
+{
+	if( NULL == m_thread )
+		return;
+
+	#ifndef WINNT
+	wake();
+	m_thread->Join();
+	delete m_thread;
+
+	ms_this = NULL;
+
+	AF_LOG << "Closing " << m_connections.size() << " render kept connections...";
+	DlScopeLocker lock( &m_mutex);
+	while( m_connections.size())
+	{
+		closeConnection( m_connections.front());
+		m_connections.pop_front();
+	}
+
+	close( m_wake_pipe[0]);
+	close( m_wake_pipe[1]);
+	#endif
+}
+
+bool RenderConnections::Enabled() { return ms_this != NULL; }
+
+void RenderConnections::Add( int i_sfd, const sockaddr_storage * i_sas, int i_render_id)
+{
+	#ifndef WINNT
+	if( NULL == ms_this )
+	{
+		close( i_sfd);
+		return;
+	}
+
+	fcntl( i_sfd, F_SETFL, fcntl( i_sfd, F_GETFL) | O_NONBLOCK);
+
+	Connection * con = new Connection;
+	con->sfd = i_sfd;
+	con->sas = *i_sas;
+	con->render_id = i_render_id;
+	con->serial = 0;
+	con->closing = false;
+	con->msg_read = NULL;
+	con->bytes_read = 0;
+	con->processing = false;
+	con->msg_write = NULL;
+	con->bytes_written = 0;
+
+	{
+		DlScopeLocker lock( &ms_this->m_mutex);
+
+		// Render can reconnect while its previous connection is still here:
+		std::map<int, Connection*>::iterator it = ms_this->m_renders.find( i_render_id);
+		if( it != ms_this->m_renders.end())
+			it->second->closing = true;
+
+		// Serial is needed to not to write an answer to a reconnected render new connection:
+		con->serial = ++ms_this->m_serial;
+
+		ms_this->m_renders[i_render_id] = con;
+		ms_this->m_connections.push_back( con);
+		ms_this->m_stat_added++;
+	}
+
+	ms_this->wake();
+	#endif
+}
+
+bool RenderConnections::Push( int i_render_id, af::RenderEvents * i_re)
+{
+	if( NULL == ms_this )
+		return false;
+
+	{
+		DlScopeLocker lock( &ms_this->m_mutex);
+
+		std::map<int, Connection*>::iterator it = ms_this->m_renders.find( i_render_id);
+		if(( it == ms_this->m_renders.end()) || it->second->closing )
+			return false;
+
+		it->second->queue.push_back( new af::Msg( af::Msg::TRenderEvents, i_re));
+		ms_this->m_stat_pushes++;
+	}
+
+	ms_this->wake();
+
+	return true;
+}
+
+void RenderConnections::Answer( int i_render_id, int64_t i_con_serial, af::Msg * i_answer)
+{
+	if( NULL == ms_this )
+	{
+		if( i_answer ) delete i_answer;
+		return;
+	}
+
+	af::Msg * next = NULL;
+	sockaddr_storage sas;
+	{
+		DlScopeLocker lock( &ms_this->m_mutex);
+
+		std::map<int, Connection*>::iterator it = ms_this->m_renders.find( i_render_id);
+		if(( it == ms_this->m_renders.end()) || ( it->second->serial != i_con_serial ) || it->second->closing )
+		{
+			// Connection was closed while message was processing:
+			if( i_answer ) delete i_answer;
+			return;
+		}
+
+		Connection * con = it->second;
+
+		if( i_answer )
+			con->queue.push_back( i_answer);
+
+		if( con->input.size())
+		{
+			next = con->input.front();
+			con->input.pop_front();
+			sas = con->sas;
+		}
+		else
+			con->processing = false;
+	}
+
+	if( next )
+		ms_this->m_args->socketsProcessing->pushKept( next, &sas, i_render_id, i_con_serial);
+
+	ms_this->wake();
+}
+
+void RenderConnections::wake()
+{
+	#ifndef WINNT
+	static const char byte = 1;
+	if( write( m_wake_pipe[1], &byte, 1) < 0 )
+	{
+		// Pipe is full, polling thread is already woken.
+	}
+	#endif
+}
+
+void RenderConnections::ThreadFunc( void * i_args)
+{
+	AF_LOG << "Render kept connections thread started.";
+	while( AFRunning )
+		ms_this->doPoll();
+}
+
+void RenderConnections::doPoll()
+{
+	#ifndef WINNT
+	std::vector<Connection*> cons;
+	std::vector<struct pollfd> fds;
+
+	struct pollfd pfd;
+	pfd.fd = m_wake_pipe[0];
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	fds.push_back( pfd);
+
+	{
+		DlScopeLocker lock( &m_mutex);
+
+		std::list<Connection*>::iterator it = m_connections.begin();
+		while( it != m_connections.end())
+		{
+			if((*it)->closing )
+			{
+				closeConnection( *it);
+				it = m_connections.erase( it);
+				continue;
+			}
+
+			pfd.fd = (*it)->sfd;
+			pfd.events = POLLIN;
+			if((*it)->msg_write || (*it)->queue.size())
+				pfd.events |= POLLOUT;
+			fds.push_back( pfd);
+			cons.push_back( *it);
+
+			it++;
+		}
+	}
+
+	int nfds = poll( &fds[0], fds.size(), 1000);
+	if( nfds < 0 )
+	{
+		if( errno != EINTR )
+			AF_ERR << "Render connections poll: " << strerror( errno);
+		return;
+	}
+
+	if( fds[0].revents & POLLIN )
+	{
+		char buf[64];
+		while( read( m_wake_pipe[0], buf, sizeof( buf)) > 0 );
+	}
+
+	for( int i = 0; i < cons.size(); i++)
+	{
+		if( false == AFRunning )
+			return;
+
+		if( 0 == fds[i+1].revents )
+			continue;
+
+		bool ok = true;
+
+		if( fds[i+1].revents & ( POLLIN | POLLHUP | POLLERR ))
+			ok = readConnection( cons[i]);
+
+		// Write answers and pushed events, processing threads wake polling to write just processed answers:
+		if( ok )
+			ok = writeConnection( cons[i]);
+
+		if( false == ok )
+		{
+			DlScopeLocker lock( &m_mutex);
+			cons[i]->closing = true;
+		}
+	}
+
+	profile();
+	#endif
+}
+
+bool RenderConnections::readConnection( Connection * i_con)
+{
+	#ifndef WINNT
+	for(;;)
+	{
+		if( NULL == i_con->msg_read )
+		{
+			i_con->msg_read = new af::Msg( &i_con->sas);
+			i_con->bytes_read = 0;
+		}
+		af::Msg * msg = i_con->msg_read;
+
+		// Read exactly header size first, not to read a part of the next message:
+		int toread = af::Msg::SizeHeader - i_con->bytes_read;
+		if(( toread <= 0 ) && ( msg->type() >= af::Msg::TDATA ))
+			toread = af::Msg::SizeHeader + msg->dataLen() - i_con->bytes_read;
+
+		if( toread > 0 )
+		{
+			int r = read( i_con->sfd, msg->buffer() + i_con->bytes_read, toread);
+			if( r == 0 )
+			{
+				// Render closed connection.
+				return false;
+			}
+			if( r < 0 )
+			{
+				if(( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == EINTR ))
+					return true;
+
+				AF_WARN << "Render kept connection reading error: " << af::sockAddrToStr( &i_con->sas) << ": " << strerror( errno);
+				return false;
+			}
+
+			bool header_reading = i_con->bytes_read < af::Msg::SizeHeader;
+
+			i_con->bytes_read += r;
+
+			if( header_reading )
+			{
+				if( i_con->bytes_read < af::Msg::SizeHeader )
+					continue;
+
+				if( af::processHeader( msg, af::Msg::SizeHeader) != af::Msg::SizeHeader )
+				{
+					AF_WARN << "Render kept connection invalid header: " << af::sockAddrToStr( &i_con->sas);
+					return false;
+				}
+			}
+
+			// Continue reading message data:
+			continue;
+		}
+
+		// Message is fully read:
+		i_con->msg_read = NULL;
+
+		if( msg->type() != af::Msg::TRenderUpdate )
+		{
+			AF_WARN << "Render kept connection unexpected message: " << af::sockAddrToStr( &i_con->sas) << ": " << msg;
+			delete msg;
+			return false;
+		}
+
+		m_stat_updates++;
+
+		// Pass message to processing threads, if the previous message of this connection is not in processing:
+		{
+			DlScopeLocker lock( &m_mutex);
+			if( i_con->processing )
+			{
+				i_con->input.push_back( msg);
+				continue;
+			}
+			i_con->processing = true;
+		}
+
+		m_args->socketsProcessing->pushKept( msg, &i_con->sas, i_con->render_id, i_con->serial);
+	}
+	#endif
+
+	return false;
+}
+
+bool RenderConnections::writeConnection( Connection * i_con)
+{
+	#ifndef WINNT
+	for(;;)
+	{
+		if( NULL == i_con->msg_write )
+		{
+			DlScopeLocker lock( &m_mutex);
+
+			if( i_con->queue.empty())
+				return true;
+
+			i_con->msg_write = i_con->queue.front();
+			i_con->queue.pop_front();
+			i_con->bytes_written = 0;
+		}
+
+		af::Msg * msg = i_con->msg_write;
+
+		int w = write( i_con->sfd, msg->buffer() + i_con->bytes_written, msg->writeSize() - i_con->bytes_written);
+		if( w < 0 )
+		{
+			if(( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == EINTR ))
+				return true;
+
+			AF_WARN << "Render kept connection writing error: " << af::sockAddrToStr( &i_con->sas) << ": " << strerror( errno);
+			return false;
+		}
+
+		i_con->bytes_written += w;
+
+		if( i_con->bytes_written >= msg->writeSize())
+		{
+			delete msg;
+			i_con->msg_write = NULL;
+		}
+	}
+	#endif
+
+	return false;
+}
+
+void RenderConnections::closeConnection( Connection * i_con)
+{
+	// Called with locked mutex.
+
+	std::map<int, Connection*>::iterator it = m_renders.find( i_con->render_id);
+	if(( it != m_renders.end()) && ( it->second == i_con ))
+		m_renders.erase( it);
+
+	#ifndef WINNT
+	close( i_con->sfd);
+	#endif
+
+	if( i_con->msg_read  ) delete i_con->msg_read;
+	if( i_con->msg_write ) delete i_con->msg_write;
+	for( std::list<af::Msg*>::iterator mIt = i_con->queue.begin(); mIt != i_con->queue.end(); mIt++)
+		delete *mIt;
+	for( std::list<af::Msg*>::iterator mIt = i_con->input.begin(); mIt != i_con->input.end(); mIt++)
+		delete *mIt;
+
+	delete i_con;
+
+	m_stat_closed++;
+}
+
+void RenderConnections::profile()
+{
+	int64_t now = af::getMonotonicMSec();
+	if( m_stat_time == 0 )
+		m_stat_time = now;
+
+	int64_t msec = now - m_stat_time;
+	if( msec < 1000 * int64_t( af::Environment::getServerProfilingSec()))
+		return;
+
+	m_stat_time = now;
+
+	std::ostringstream log;
+	{
+		DlScopeLocker lock( &m_mutex);
+
+		// Renders do not use kept connections:
+		if( m_renders.empty() && ( m_stat_added == 0 ) && ( m_stat_closed == 0 ))
+			return;
+
+		log << "Render kept connections: " << m_renders.size();
+		log << ", in last " << ( msec / 1000 ) << " seconds";
+		log << " updates: " << m_stat_updates << ", pushes: " << m_stat_pushes;
+		log << ", added: " << m_stat_added << ", closed: " << m_stat_closed;
+
+		m_stat_updates = 0;
+		m_stat_pushes  = 0;
+		m_stat_added   = 0;
+		m_stat_closed  = 0;
+	}
+
+	AFCommon::QueueLog( log.str());
+}
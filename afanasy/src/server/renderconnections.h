@@ -0,0 +1,106 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Render kept connections.
+	Render can ask server to keep its connection (TRenderConnect message).
+	Sockets processing hands such socket over here after the answer is written.
+	One thread polls all kept connections, it does only sockets IO:
+	it reads render updates and passes them to sockets processing threads,
+	writes back their answers and render events pushed by run thread after solving.
+*/
+#pragma once
+
+#include "../libafanasy/common/dlMutex.h"
+#include "../libafanasy/name_af.h"
+
+#include "threadargs.h"
+
+class DlThread;
+
+namespace af
+{
+class RenderEvents;
+}
+
+class RenderConnections
+{
+public:
+	RenderConnections( ThreadArgs * i_args);
+	~RenderConnections();
+
+	/// Whether server can keep render connections.
+	static bool Enabled();
+
+	/// Called by sockets processing, when TRenderConnect answer was written.
+	/// Takes socket descriptor ownership.
+	static void Add( int i_sfd, const sockaddr_storage * i_sas, int i_render_id);
+
+	/// Called by run thread to send render events as soon as they appear.
+	/// Returns false if render has no kept connection, events should wait for its update.
+	static bool Push( int i_render_id, af::RenderEvents * i_re);
+
+	/// Called by sockets processing thread, when kept connection message is processed.
+	/// Takes answer ownership, next read message of the connection is passed to processing.
+	static void Answer( int i_render_id, int64_t i_con_serial, af::Msg * i_answer);
+
+private:
+	struct Connection
+	{
+		int sfd;
+		sockaddr_storage sas;
+		int render_id;
+		int64_t serial;
+		bool closing;
+
+		af::Msg * msg_read;
+		int bytes_read;
+
+		/// Render streams updates, they are processed one by one to keep their order.
+		std::list<af::Msg*> input;
+		bool processing;
+
+		std::list<af::Msg*> queue;
+		af::Msg * msg_write;
+		int bytes_written;
+	};
+
+	static void ThreadFunc( void * i_args);
+	void doPoll();
+
+	bool readConnection( Connection * i_con);
+	bool writeConnection( Connection * i_con);
+	void closeConnection( Connection * i_con);
+
+	void wake();
+
+	void profile();
+
+private:
+	static RenderConnections * ms_this;
+
+	ThreadArgs * m_args;
+
+	DlMutex m_mutex;
+	std::list<Connection*> m_connections;
+	std::map<int, Connection*> m_renders;
+	int64_t m_serial;
+
+	int m_wake_pipe[2];
+	DlThread * m_thread;
+
+	int64_t m_stat_time;
+	int64_t m_stat_updates;
+	int64_t m_stat_pushes;
+	int64_t m_stat_added;
+	int64_t m_stat_closed;
+};
@@ -2,6 +2,7 @@
 
 #include "../include/afanasy.h"
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/msg.h"
 
 #include "afcommon.h"
@@ -13,14 +14,25 @@
 #include "../libafanasy/logger.h"
 
 RenderContainer::RenderContainer():
-	AfContainer( "Renders", AFRENDER::MAXCOUNT)
+	AfContainer( "Renders", AFRENDER::MAXCOUNT),
+	m_update_stat_count( 0),
+	m_update_stat_bytes( 0),
+	m_update_stat_hres_count( 0),
+	m_update_stat_hres_bytes( 0),
+	m_update_stat_wait_us( 0),
+	m_update_stat_wait_max_us( 0)
 {
 	RenderAf::setRenderContainer( this);
+
+	setSnapshotType( af::Msg::TRendersList, "renders");
 }
 
 RenderContainer::~RenderContainer()
 {
 AFINFO("RenderContainer::~RenderContainer:")
+	// Renders will be deleted in base class dtor,
+	// ready renders will not exist at that moment.
+	RenderAf::setRenderContainer( NULL);
 }
 
 af::Msg * RenderContainer::addRender(RenderAf * newRender, PoolsContainer * i_pools, JobContainer * i_jobs, MonitorContainer * monitoring)
@@ -98,6 +110,84 @@ af::Msg * RenderContainer::addRender(RenderAf * newRender, PoolsContainer * i_po
    return NULL;
 }
 
+void RenderContainer::updateReady(RenderAf * i_render)
+{
+	i_render->updateSolveKey();
+
+	if (i_render->isReady() && (false == i_render->isZombie()))
+	{
+		if (i_render->m_ready_index >= 0)
+			return;
+
+		i_render->m_ready_index = m_ready_renders.size();
+		m_ready_renders.push_back(i_render);
+	}
+	else
+		removeReady(i_render);
+}
+
+void RenderContainer::removeReady(RenderAf * i_render)
+{
+	int index = i_render->m_ready_index;
+	if (index < 0)
+		return;
+
+	// Move the last render to the removed position:
+	RenderAf * last = m_ready_renders.back();
+	m_ready_renders[index] = last;
+	last->m_ready_index = index;
+	m_ready_renders.pop_back();
+
+	i_render->m_ready_index = -1;
+}
+
+void RenderContainer::updateStat(int i_bytes, const af::RenderUpdate & i_up, int64_t i_wait_us)
+{
+	DlScopeLocker lock(&m_update_stat_mutex);
+
+	m_update_stat_count++;
+	m_update_stat_bytes += i_bytes;
+
+	m_update_stat_wait_us += i_wait_us;
+	if (i_wait_us > m_update_stat_wait_max_us)
+		m_update_stat_wait_max_us = i_wait_us;
+
+	if (i_up.hasResources())
+	{
+		m_update_stat_hres_count++;
+		m_update_stat_hres_bytes += i_up.getResourcesBytes();
+	}
+}
+
+void RenderContainer::writeUpdateStat(std::ostringstream & o_str)
+{
+	int64_t count, bytes, hres_count, hres_bytes, wait_us, wait_max_us;
+	{
+		DlScopeLocker lock(&m_update_stat_mutex);
+		count       = m_update_stat_count;
+		bytes       = m_update_stat_bytes;
+		hres_count  = m_update_stat_hres_count;
+		hres_bytes  = m_update_stat_hres_bytes;
+		wait_us     = m_update_stat_wait_us;
+		wait_max_us = m_update_stat_wait_max_us;
+		m_update_stat_count       = 0;
+		m_update_stat_bytes       = 0;
+		m_update_stat_hres_count  = 0;
+		m_update_stat_hres_bytes  = 0;
+		m_update_stat_wait_us     = 0;
+		m_update_stat_wait_max_us = 0;
+	}
+
+	o_str << "\nRender updates: " << count << ", bytes received " << bytes;
+	if (count)
+		o_str << " (avg " << (bytes / count) << ")";
+	o_str << ", with resources " << hres_count << ", resources bytes " << hres_bytes;
+	if (hres_count)
+		o_str << " (avg " << (hres_bytes / hres_count) << ")";
+	if (count)
+		o_str << ", locks wait avg " << (wait_us / count) << " max " << wait_max_us << " us";
+}
+
 //##############################################################################
 
 RenderContainerIt::RenderContainerIt( RenderContainer* container, bool skipZombies):
@@ -17,6 +17,35 @@ public:
 
 	/// Add new Render to container, new id returned on success, else return 0.
 	af::Msg * addRender(RenderAf * newRender, PoolsContainer * i_pools, JobContainer * i_jobs, MonitorContainer * monitoring);
+
+	/// Renders that are ready to run tasks, solver takes candidates from here.
+	/// Render updates its presence itself when its ready state or solving parameters change.
+	inline const std::vector<RenderAf*> & getReadyRenders() const { return m_ready_renders; }
+
+	/// Store render solving parameters,
+	/// add render to ready renders or remove it, depending on render state.
+	void updateReady(RenderAf * i_render);
+
+	/// Remove render from ready renders (on render deletion).
+	void removeReady(RenderAf * i_render);
+
+	/// Collect render update messages statistics, can be called from any thread.
+	/// \c i_wait_us is a time update waited for container lock.
+	void updateStat(int i_bytes, const af::RenderUpdate & i_up, int64_t i_wait_us);
+
+	/// Write and reset render updates statistics.
+	void writeUpdateStat(std::ostringstream & o_str);
+
+private:
+	std::vector<RenderAf*> m_ready_renders;
+
+	DlMutex m_update_stat_mutex;
+	int64_t m_update_stat_count;
+	int64_t m_update_stat_bytes;
+	int64_t m_update_stat_hres_count;
+	int64_t m_update_stat_hres_bytes;
+	int64_t m_update_stat_wait_us;
+	int64_t m_update_stat_wait_max_us;
 };
 
 /// Renders iterator.
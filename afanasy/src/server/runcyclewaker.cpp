@@ -0,0 +1,149 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Run cycle waker.
+	Run thread can sleep a fixed second between cycles (default),
+	or it can be woken up by events that need run thread reaction.
+*/
+#include "runcyclewaker.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
+
+#include "afcommon.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+extern bool AFRunning;
+
+DlMutex RunCycleWaker::ms_mutex;
+DlConditionVariable RunCycleWaker::ms_cond;
+
+bool    RunCycleWaker::ms_woken = false;
+int64_t RunCycleWaker::ms_woken_time = 0;
+
+int64_t RunCycleWaker::ms_cycle_time = 0;
+
+int64_t RunCycleWaker::ms_cycles_event = 0;
+int64_t RunCycleWaker::ms_cycles_timer = 0;
+int64_t RunCycleWaker::ms_wakes = 0;
+
+int64_t RunCycleWaker::ms_stat_time = 0;
+int64_t RunCycleWaker::ms_stat_cycles_event = 0;
+int64_t RunCycleWaker::ms_stat_cycles_timer = 0;
+
+void RunCycleWaker::Wake()
+{
+	if (false == af::Environment::getServerRunCycleWakeup())
+		return;
+
+	DlScopeLocker lock(&ms_mutex);
+
+	ms_wakes++;
+
+	// Run thread is already woken,
+	// it will process this event too.
+	if (ms_woken)
+		return;
+
+	ms_woken = true;
+	ms_woken_time = af::getMonotonicMSec();
+
+	ms_cond.Signal();
+}
+
+void RunCycleWaker::Wait()
+{
+	int64_t now = af::getMonotonicMSec();
+	if (ms_cycle_time == 0)
+		ms_cycle_time = now;
+
+	if (false == af::Environment::getServerRunCycleWakeup())
+	{
+		af::sleep_sec(1);
+		ms_cycles_timer++;
+	}
+	else
+	{
+		// Timer cycle is the same as without wakeup: a second after the previous one finished.
+		int64_t timer_time = now + 1000;
+		bool by_event = false;
+
+		{
+			DlScopeLocker lock(&ms_mutex);
+			while ((false == ms_woken) && AFRunning)
+			{
+				now = af::getMonotonicMSec();
+				if (now >= timer_time)
+					break;
+
+				ms_cond.TimedWait(&ms_mutex, int(timer_time - now));
+			}
+			by_event = ms_woken;
+		}
+
+		if (by_event)
+		{
+			// Wait a little to collect more events in one cycle,
+			// and do not start cycles too often.
+			int64_t start_time = ms_woken_time + af::Environment::getServerRunCycleBatchMSec();
+			if (start_time < ms_cycle_time + af::Environment::getServerRunCycleMinMSec())
+				start_time = ms_cycle_time + af::Environment::getServerRunCycleMinMSec();
+
+			now = af::getMonotonicMSec();
+			if (start_time > now)
+				af::sleep_msec(int(start_time - now));
+
+			ms_cycles_event++;
+		}
+		else
+			ms_cycles_timer++;
+
+		// Events received until now will be processed by the next cycle.
+		DlScopeLocker lock(&ms_mutex);
+		ms_woken = false;
+	}
+
+	ms_cycle_time = af::getMonotonicMSec();
+
+	Profile(ms_cycle_time);
+}
+
+void RunCycleWaker::Profile(int64_t i_now)
+{
+	if (ms_stat_time == 0)
+		ms_stat_time = i_now;
+
+	int64_t msec = i_now - ms_stat_time;
+	if (msec < 1000 * int64_t(af::Environment::getServerProfilingSec()))
+		return;
+
+	int64_t cycles_event = ms_cycles_event - ms_stat_cycles_event;
+	int64_t cycles_timer = ms_cycles_timer - ms_stat_cycles_timer;
+
+	std::ostringstream log;
+	log << "Run cycles: " << (cycles_event + cycles_timer) << " in last " << (msec / 1000) << " seconds";
+	log << ", by events: " << cycles_event << ", by timer: " << cycles_timer;
+	{
+		DlScopeLocker lock(&ms_mutex);
+		log << ", total wakes: " << ms_wakes;
+	}
+	AFCommon::QueueLog(log.str());
+
+	ms_stat_time = i_now;
+	ms_stat_cycles_event = ms_cycles_event;
+	ms_stat_cycles_timer = ms_cycles_timer;
+}
@@ -0,0 +1,55 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Run cycle waker.
+	Run thread can sleep a fixed second between cycles (default),
+	or it can be woken up by events that need run thread reaction.
+*/
+#pragma once
+
+#include <stdint.h>
+
+#include "../libafanasy/common/dlConditionVariable.h"
+#include "../libafanasy/common/dlMutex.h"
+
+class RunCycleWaker
+{
+public:
+	/// Called from any thread when something needs run thread reaction:
+	/// a render task update, a run queue message, a new job.
+	static void Wake();
+
+	/// Called from run thread at the end of each cycle.
+	/// Returns when the next cycle should start.
+	static void Wait();
+
+private:
+	static void Profile( int64_t i_now);
+
+private:
+	static DlMutex ms_mutex;
+	static DlConditionVariable ms_cond;
+
+	static bool    ms_woken;
+	static int64_t ms_woken_time;
+
+	static int64_t ms_cycle_time;
+
+	static int64_t ms_cycles_event;
+	static int64_t ms_cycles_timer;
+	static int64_t ms_wakes;
+
+	static int64_t ms_stat_time;
+	static int64_t ms_stat_cycles_event;
+	static int64_t ms_stat_cycles_timer;
+};
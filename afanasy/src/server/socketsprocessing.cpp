@@ -44,11 +44,18 @@
 #include "socketsprocessing.h"
 #include "httpget.hpp"
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/common/dlThread.h"
 #include "../libafanasy/environment.h"
 #include "../libafanasy/msg.h"
+#include "../libafanasy/msgbufferpool.h"
 
+#include "monitorcontainer.h"
+#include "iouring.h"
 #include "profiler.h"
+#include "ratelimiter.h"
+#include "renderconnections.h"
+#include "runcyclewaker.h"
 
 #ifdef WINNT
 #define MSG_DONTWAIT 0
@@ -56,8 +63,14 @@
 #define closesocket close
 #endif
 
+#ifndef NO_ZLIB
+#include <zlib.h>
+#endif
+
 #ifdef LINUX
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #endif
 
@@ -84,12 +97,20 @@ SocketItem::SocketItem( int i_sfd, sockaddr_storage * i_sas):
 	m_header_reading_finished( false),
 	m_reading_finished( false),
 
-	m_write_buffer( NULL),
+	m_requests( 0),
+
+	m_write_started( false),
 	m_write_size(0),
 	m_bytes_written(0),
+	m_uring_pending( false),
 	#endif // LINUX
 
-	m_zombie(false)
+	m_zombie(false),
+	m_keep_alive(false),
+	m_wait_monitor_id(0),
+	m_wait_monitor_time(0),
+	m_kept_render_id(0),
+	m_kept_con_serial(0)
 {
 	m_msg_req = new af::Msg( m_sas);
 
@@ -112,6 +133,38 @@ SocketItem::SocketItem( int i_sfd, sockaddr_storage * i_sas):
 	#endif // LINUX
 }
 
+SocketItem::SocketItem( af::Msg * i_msg, const sockaddr_storage * i_sas, int i_render_id, int64_t i_con_serial):
+	m_state( SSProcessing),
+	m_sfd( -1),
+	m_sas( new sockaddr_storage( *i_sas)),
+	m_msg_req( i_msg),
+	m_msg_ans( NULL),
+
+	#ifdef LINUX
+	m_epoll_added( false),
+	m_bytes_read( 0),
+	m_header_reading_finished( false),
+	m_reading_finished( false),
+
+	m_requests( 0),
+
+	m_write_started( false),
+	m_write_size(0),
+	m_bytes_written(0),
+	m_uring_pending( false),
+	#endif // LINUX
+
+	m_zombie(false),
+	m_keep_alive(false),
+	m_wait_monitor_id(0),
+	m_wait_monitor_time(0),
+	m_kept_render_id( i_render_id),
+	m_kept_con_serial( i_con_serial)
+{
+	// Socket is owned by render connections, message is already read.
+	m_profiler = NULL;
+}
+
 SocketItem::~SocketItem()
 {
 	if( SSClosed != m_state )
@@ -126,11 +179,6 @@ SocketItem::~SocketItem()
 	if( m_msg_req ) delete m_msg_req;
 	if( m_msg_ans ) delete m_msg_ans;
 
-	#ifdef LINUX
-	if( m_write_buffer )
-		delete [] m_write_buffer;
-	#endif // LINUX
-
 	// Delete profiler. 
 	// If it was collected, pointer will be == NULL
 	if( m_profiler )
@@ -187,7 +235,7 @@ bool SocketItem::processMsg( ThreadArgs * i_args)
 
 	if( m_msg_req->type() == af::Msg::THTTPGET )
 	{
-		m_msg_ans = HttpGet::process(m_msg_req);
+		m_msg_ans = HttpGet::process(m_msg_req, m_keep_alive);
 		m_profiler->processingFinished();
 		return true;
 	}
@@ -216,10 +264,71 @@ bool SocketItem::processMsg( ThreadArgs * i_args)
 
 	m_profiler->processingFinished();
 
+	if( m_msg_ans->type() == af::Msg::TMonitorEventsWait )
+	{
+		// Monitor has no events, request will wait for them.
+		// Sockets processing will hold it, to be answered by run thread.
+		m_wait_monitor_id = m_msg_ans->int32();
+		m_wait_monitor_time = time( NULL);
+		delete m_msg_ans;
+		m_msg_ans = NULL;
+	}
+	else
+		compressAnswer();
+
 	// Return TRUE means ready to answer.
 	return true;
 }
 
+void SocketItem::compressAnswer()
+{
+	#ifndef NO_ZLIB
+	if(( m_msg_req->type() != af::Msg::THTTP ) || ( false == m_msg_req->isHTTPAcceptGzip()))
+		return;
+	if( m_msg_ans->type() != af::Msg::TJSON )
+		return;
+
+	int size_min = af::Environment::getServerHTTPGzipSizeMin();
+	if(( size_min <= 0 ) || ( m_msg_ans->dataLen() < size_min ))
+		return;
+
+	z_stream zs;
+	memset( &zs, 0, sizeof( zs));
+
+	// Window bits 15 + 16 means to write gzip header and trailer.
+	// The fastest level is enough for JSON, it has many repeating keys.
+	if( deflateInit2( &zs, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+	{
+		AF_ERR << "deflateInit2: " << ( zs.msg ? zs.msg : "") << ": " << this;
+		return;
+	}
+
+	int buffer_size = af::Msg::SizeHeader + deflateBound( &zs, m_msg_ans->dataLen());
+	char * buffer = af::MsgBufferPool::Acquire( buffer_size);
+
+	zs.next_in   = reinterpret_cast<Bytef*>( m_msg_ans->data());
+	zs.avail_in  = m_msg_ans->dataLen();
+	zs.next_out  = reinterpret_cast<Bytef*>( buffer + af::Msg::SizeHeader);
+	zs.avail_out = buffer_size - af::Msg::SizeHeader;
+
+	int result = deflate( &zs, Z_FINISH);
+	int size = zs.total_out;
+	deflateEnd( &zs);
+
+	if(( result != Z_STREAM_END ) || ( size >= m_msg_ans->dataLen()))
+	{
+		af::MsgBufferPool::Release( buffer, buffer_size);
+		return;
+	}
+
+	af::Msg * msg = new af::Msg( af::Msg::TJSON, buffer, buffer_size, size);
+	msg->setHTTPGzip();
+
+	delete m_msg_ans;
+	m_msg_ans = msg;
+	#endif
+}
+
 void SocketItem::processRun( ThreadArgs * i_args)
 {
 	m_msg_ans = threadRunCycleCase( i_args, m_msg_req);
@@ -229,12 +338,46 @@ void SocketItem::processRun( ThreadArgs * i_args)
 	m_profiler->processingFinished();
 }
 
-void SocketItem::writeMsg()
+void SocketItem::processKept( ThreadArgs * i_args)
+{
+	m_msg_ans = threadProcessMsgCase( i_args, m_msg_req);
+
+	// Answer is written by render connections polling thread:
+	RenderConnections::Answer( m_kept_render_id, m_kept_con_serial, m_msg_ans);
+	m_msg_ans = NULL;
+
+	m_state = SSClosed;
+	m_zombie = true;
+}
+
+bool SocketItem::processWaitingEvents( ThreadArgs * i_args)
+{
+	MonitorContainerIt it( i_args->monitors);
+	MonitorAf * monitor = it.getMonitor( m_wait_monitor_id);
+
+	if( NULL == monitor )
+		m_msg_ans = af::jsonMsg("{\"monitor\":{\"id\":0}}");
+	else if( monitor->hasEvents() ||
+			( time( NULL) - m_wait_monitor_time >= af::Environment::getMonitorEventsWaitSec()))
+		m_msg_ans = monitor->getEventsJSON();
+	else
+	{
+		// Monitor is waiting, it should not become a zombie.
+		monitor->updateTime();
+		return false;
+	}
+
+	m_wait_monitor_id = 0;
+
+	return true;
+}
+
+bool SocketItem::writeMsg()
 {
 	if( m_state == SSWriting )
 	{
 		AF_ERR << "SocketItem::writeMsg: Repeated call on: " << this;
-		return;
+		return false;
 	}
 
 	m_state = SSWriting;
@@ -244,7 +387,7 @@ void SocketItem::writeMsg()
 		// No answer exist means no answer needed.
 		// For example on browser close (monitor deregister) it will not wait any answer
 		waitClose();
-		return;
+		return false;
 	}
 
 	// Set HTTP message type.
@@ -256,10 +399,11 @@ void SocketItem::writeMsg()
 
 	#ifdef LINUX
 	if( SocketsProcessing::UsingEpoll())
-	{
-		writeData();
-		return;
-	}
+		return writeData();
+
+	// io_uring thread will submit the answer writing.
+	if( SocketsProcessing::UsingUring())
+		return false;
 	#endif
 
 	// Write response message back to client socket
@@ -270,10 +414,15 @@ void SocketItem::writeMsg()
 		m_msg_req->stdOutData();
 		m_msg_ans->stdOutData();
 		closeSocket();
-		return;
+		return false;
 	}
 
+	if( handOver())
+		return false;
+
 	waitClose();
+
+	return false;
 }
 
 #ifdef LINUX
@@ -285,6 +434,13 @@ bool SocketItem::processIO( int i_events)
 		return false;
 	}
 
+	if(( i_events & ( EPOLLERR | EPOLLHUP )) && ( m_state == SSProcessing ))
+	{
+		// Socket item is processed by other thread, or waits for monitor events.
+		// It will be closed on answer writing failure.
+		return false;
+	}
+
 	if( i_events & EPOLLERR )
 	{
 		if( m_state != SSWaiting )
@@ -308,8 +464,7 @@ bool SocketItem::processIO( int i_events)
 	case SSReading:
 		return readData();
 	case SSWriting:
-		writeData();
-		break;
+		return writeData();
 	case SSWaiting:
 		break;
 	case SSClosed:
@@ -338,149 +493,373 @@ bool SocketItem::readData()
 		return false;
 	}
 
-	if( false == m_header_reading_finished )
+	bool header_reading = ( false == m_header_reading_finished );
+
+	char * buffer;
+	int size = readTarget( &buffer);
+	size = read( m_sfd, buffer, size);
+	if( readDone( size, errno))
+		return true;
+
+	if( header_reading && m_header_reading_finished && ( SSReading == m_state ))
 	{
-		int size = read( m_sfd, m_msg_req->buffer() + m_bytes_read, af::Msg::SizeBuffer - m_bytes_read);
-		if( size < 1 )
-		{
-			if( errno != EAGAIN )
-			{
-				AF_WARN << "Socket reading error: " << af::sockAddrToStr( m_sas) << ": " << this;
-				closeSocket();
-			}
-			return false;
-		}
+		// Header was read, but message contains data which is not yet read.
+		// Edge triggered EPOLL will not notify about data received with the header.
+		size = readTarget( &buffer);
+		size = read( m_sfd, buffer, size);
+		return readDone( size, errno);
+	}
 
-		m_bytes_read += size;
+	return false;
+}
 
-		if( m_bytes_read < af::Msg::SizeHeader )
-		{
-			// Just continue reading header.
-			return false;
-		}
+int SocketItem::readTarget( char ** o_buffer) const
+{
+	if( false == m_header_reading_finished )
+	{
+		*o_buffer = m_msg_req->buffer() + m_bytes_read;
+		return af::Msg::SizeBuffer - m_bytes_read;
+	}
 
-		m_header_reading_finished = true;
+	*o_buffer = m_msg_req->buffer() + af::Msg::SizeHeader + m_bytes_read;
+	return m_msg_req->dataLen() - m_bytes_read;
+}
 
-		int header_offset = af::processHeader( m_msg_req, m_bytes_read);
-		if( header_offset < 0 )
+bool SocketItem::readDone( int i_size, int i_errno)
+{
+	if( i_size < 1 )
+	{
+		if(( i_size == 0 ) && ( false == m_header_reading_finished ) && ( m_requests > 0 ) && ( m_bytes_read == 0 ))
 		{
-			// Negative offset means an invalid header.
-			// This connection and its messages are not needed any more.
+			// Client closed kept alive connection.
 			closeSocket();
-			return false;
 		}
-
-		if( m_msg_req->type() < af::Msg::TDATA )
+		else if( i_errno != EAGAIN )
 		{
-			// This message contains no data, all info is in its header.
-			m_reading_finished = true;
+			AF_WARN << "Socket reading error: " << af::sockAddrToStr( m_sas) << ": " << this;
+			closeSocket();
 		}
-		else
+		return false;
+	}
+
+	m_bytes_read += i_size;
+
+	if( false == m_header_reading_finished )
+	{
+		if( false == processReadHeader())
+			return false;
+	}
+	else if( m_bytes_read >= m_msg_req->dataLen())
+	{
+		// All needed data was read.
+		m_reading_finished = true;
+	}
+
+	if( m_reading_finished )
+	{
+		// TRUE means that reading is successfully finished.
+		// And this item will be pushed in the processing queue.
+		m_state = SSProcessing;
+		return true;
+	}
+
+	return false;
+}
+
+bool SocketItem::processReadHeader()
+{
+	if( m_bytes_read < af::Msg::SizeHeader )
+	{
+		// Just continue reading header.
+		return false;
+	}
+
+	m_header_reading_finished = true;
+
+	char * buffer = m_msg_req->buffer();
+	int request_bytes = m_bytes_read;
+
+	bool http_get = ( strncmp( buffer, "GET", 3) == 0 );
+	if( http_get || ( strncmp( buffer, "POST", 4) == 0 ))
+	{
+		int header_size = af::httpHeaderSize( buffer, m_bytes_read);
+		if( header_size )
 		{
-			m_bytes_read -= header_offset;
+			m_keep_alive = ( af::Environment::getServerHTTPKeepAliveSec() > 0 ) && af::httpKeepAlive( buffer, header_size);
 
-			if( m_bytes_read >= m_msg_req->dataLen())
+			// GET request has no body, next pipelined request can follow the header:
+			if( http_get && m_keep_alive && ( header_size < m_bytes_read ))
 			{
-				// And header and data was read at the same operation.
-				m_reading_finished = true;
+				m_pipelined.assign( buffer + header_size, m_bytes_read - header_size);
+				request_bytes = header_size;
 			}
 		}
 	}
 
-	if(( m_header_reading_finished ) && ( false == m_reading_finished ) && ( m_msg_req->type() >= af::Msg::TDATA ))
+	int header_offset = af::processHeader( m_msg_req, request_bytes);
+	if( header_offset < 0 )
 	{
-		// Header was read, but message contains data which is not yet read:
-		int toread = m_msg_req->dataLen() - m_bytes_read;
-		int size = read( m_sfd, m_msg_req->buffer() + af::Msg::SizeHeader + m_bytes_read, toread);
-		if( size < 1 )
-		{	if( errno != EAGAIN )
-			{
-				AF_WARN << "Socket reading error: " << af::sockAddrToStr( m_sas) << ": " << this;
-				closeSocket();
-			}
-			return false;
-		}
-		m_bytes_read += size;
+		// Negative offset means an invalid header.
+		// This connection and its messages are not needed any more.
+		closeSocket();
+		return false;
+	}
+
+	if( m_msg_req->type() < af::Msg::TDATA )
+	{
+		// This message contains no data, all info is in its header.
+		m_reading_finished = true;
+	}
+	else
+	{
+		m_bytes_read = request_bytes - header_offset;
 
 		if( m_bytes_read >= m_msg_req->dataLen())
 		{
-			// All needed data was read.
+			// And header and data was read at the same operation.
 			m_reading_finished = true;
+
+			// Next pipelined request can follow the data:
+			if( m_keep_alive && ( m_bytes_read > m_msg_req->dataLen()))
+				m_pipelined.assign( m_msg_req->data() + m_msg_req->dataLen(), m_bytes_read - m_msg_req->dataLen());
 		}
 	}
 
-	if( m_reading_finished )
+	return true;
+}
+
+bool SocketItem::keepAlive()
+{
+	m_requests++;
+
+	// Each request is profiled separately:
+	Profiler::Collect( m_profiler);
+	m_profiler = new Profiler();
+
+	delete m_msg_req;
+	delete m_msg_ans;
+	m_msg_req = new af::Msg( m_sas);
+	m_msg_ans = NULL;
+
+	m_bytes_read = 0;
+	m_header_reading_finished = false;
+	m_reading_finished = false;
+	m_keep_alive = false;
+
+	m_write_started = false;
+	m_write_header.clear();
+	m_write_size = 0;
+	m_bytes_written = 0;
+
+	m_state = SSReading;
+	m_wait_time = time( NULL);
+
+	if( m_pipelined.size())
 	{
-		// TRUE means that reading is successfully finished.
-		// And this item will be pushed in the processing queue.
-		m_state = SSProcessing;
-		return true;
+		// Pipelined bytes were read by one read call, so they fit the message buffer.
+		m_bytes_read = m_pipelined.size();
+		memcpy( m_msg_req->buffer(), m_pipelined.data(), m_bytes_read);
+		m_pipelined.clear();
+
+		if( processReadHeader() && m_reading_finished )
+		{
+			m_state = SSProcessing;
+			return true;
+		}
+
+		if( SSClosed == m_state )
+			return false;
 	}
 
-	return false;
+	// io_uring thread will submit the next request reading.
+	if( SocketsProcessing::UsingUring())
+		return false;
+
+	// Edge triggered EPOLL does not notify about data received during processing,
+	// so we try to read the next request now.
+	return readData();
+}
+
+void SocketItem::checkKeepAlive()
+{
+	if(( m_requests == 0 ) || ( m_bytes_read > 0 ) || ( SSReading != m_state ))
+		return;
+
+	if( time( NULL) - m_wait_time > af::Environment::getServerHTTPKeepAliveSec())
+		closeSocket();
 }
 
-void SocketItem::writeData()
+bool SocketItem::writeData()
 {
 	if( NULL == m_msg_ans )
 	{
 		AF_ERR << "SocketItem::writeData(): The answer is NULL: " << this;
-		return;
+		return false;
 	}
 
-	if( NULL ==  m_write_buffer )
+	int iovcnt = writeTarget();
+	if( iovcnt == 0 )
+		return false;
+
+	int bytes = writev( m_sfd, m_write_iov, iovcnt);
+
+	return writeDone( bytes, errno);
+}
+
+int SocketItem::writeTarget()
+{
+	if( false == m_write_started )
 	{
 		// This is the first writing call.
-		// We should allocate and fill in write buffer.
-		std::string header = af::msgMakeWriteHeader( m_msg_ans);
-		m_write_size = header.size() + m_msg_ans->writeSize() - m_msg_ans->getHeaderOffset();
-		m_write_buffer = new char[m_write_size];
-		if( NULL != header.c_str() )
-		{
-			memcpy( m_write_buffer, header.c_str(), header.size());
-		}
-		memcpy( m_write_buffer + header.size(), m_msg_ans->buffer() + m_msg_ans->getHeaderOffset(), m_msg_ans->writeSize() - m_msg_ans->getHeaderOffset());
+		// Header and message data are written with no copy, by a gather write.
+		m_write_header = af::msgMakeWriteHeader( m_msg_ans, m_keep_alive);
+		m_write_size = m_write_header.size() + m_msg_ans->writeSize() - m_msg_ans->getHeaderOffset();
+		m_write_started = true;
 	}
 
 	if( m_bytes_written >= m_write_size )
 	{
 		AF_WARN << "SocketItem::writeData(): m_bytes_written >= m_write_size ( " << m_bytes_written << " >= " << m_write_size << " ): " << this;
-		return;
+		return 0;
 	}
 
-	int bytes;
-	#ifdef WINNT
-	bytes = send( m_sfd, m_write_buffer + m_bytes_written, m_write_size - m_bytes_written, 0);
-	#else
-	bytes = write(m_sfd, m_write_buffer + m_bytes_written, m_write_size - m_bytes_written);
-	#endif
+	int iovcnt = 0;
+	int header_size = m_write_header.size();
+	if( m_bytes_written < header_size )
+	{
+		m_write_iov[iovcnt].iov_base = const_cast<char*>( m_write_header.data()) + m_bytes_written;
+		m_write_iov[iovcnt].iov_len  = header_size - m_bytes_written;
+		iovcnt++;
+	}
+	int data_written = m_bytes_written > header_size ? m_bytes_written - header_size : 0;
+	m_write_iov[iovcnt].iov_base = m_msg_ans->buffer() + m_msg_ans->getHeaderOffset() + data_written;
+	m_write_iov[iovcnt].iov_len  = m_write_size - header_size - data_written;
+	iovcnt++;
+
+	return iovcnt;
+}
 
-	if( bytes >= 0 )
+bool SocketItem::writeDone( int i_bytes, int i_errno)
+{
+	if( i_bytes >= 0 )
 	{
-		m_bytes_written += bytes;
+		m_bytes_written += i_bytes;
 
 		if( m_bytes_written >= m_write_size )
 		{
+			if( handOver())
+				return false;
+
+			if( m_keep_alive )
+				return keepAlive();
+
 			waitClose();
 		}
 
-		return;
+		return false;
 	}
 
-	switch( errno )
+	switch( i_errno )
 	{
 	case EAGAIN:
-		return;
+		return false;
 	default:
 		AF_ERR << "Socket writing error: " << af::sockAddrToStr( m_sas) << ": " << this;
 	}
 
 	closeSocket();
 
-	return;
+	return false;
+}
+
+#ifndef NO_IO_URING
+bool SocketItem::uringPrepare( struct io_uring_sqe * o_sqe)
+{
+	// Blocking socket operation is completed by kernel, when socket is ready.
+	switch( m_state )
+	{
+	case SSReading:
+	{
+		if( m_reading_finished )
+			return false;
+
+		char * buffer;
+		int size = readTarget( &buffer);
+		o_sqe->opcode = IORING_OP_RECV;
+		o_sqe->addr = (uint64_t)(uintptr_t)buffer;
+		o_sqe->len = size;
+		break;
+	}
+	case SSWriting:
+	{
+		int iovcnt = writeTarget();
+		if( iovcnt == 0 )
+			return false;
+
+		o_sqe->opcode = IORING_OP_WRITEV;
+		o_sqe->addr = (uint64_t)(uintptr_t)m_write_iov;
+		o_sqe->len = iovcnt;
+		break;
+	}
+	default:
+		return false;
+	}
+
+	o_sqe->fd = m_sfd;
+	o_sqe->user_data = (uint64_t)(uintptr_t)this;
+	m_uring_pending = true;
+
+	return true;
 }
+
+bool SocketItem::uringComplete( int i_result)
+{
+	m_uring_pending = false;
+
+	// Negative result is a negated error number:
+	int size = i_result < 0 ? -1 : i_result;
+	int error = i_result < 0 ? -i_result : 0;
+
+	switch( m_state )
+	{
+	case SSReading:
+		return readDone( size, error);
+	case SSWriting:
+		return writeDone( size, error);
+	case SSClosed:
+		// Socket was closed while operation was in flight.
+		break;
+	default:
+		AF_ERR << "io_uring completion on unexpected socket item state: " << this;
+	}
+
+	return false;
+}
+#endif // NO_IO_URING
 #endif // LINUX
 
+bool SocketItem::handOver()
+{
+	// Render asked to keep its connection and server agreed, answering a valid id.
+	// Socket is handed over to render kept connections and is not closed here.
+	if(( m_msg_req->type() != af::Msg::TRenderConnect ) ||
+		( m_msg_ans->type() != af::Msg::TRenderId ) || ( m_msg_ans->int32() <= 0 ))
+		return false;
+
+	#ifdef LINUX
+	if( SocketsProcessing::UsingEpoll())
+		SocketsProcessing::EpollDel( m_sfd);
+	#endif // LINUX
+
+	RenderConnections::Add( m_sfd, m_sas, m_msg_ans->int32());
+
+	m_state = SSClosed;
+
+	collectZombie();
+
+	return true;
+}
+
 void SocketItem::waitClose()
 {
 	// This function needed to wait for client closes socket first.
@@ -573,10 +952,19 @@ void SocketItem::closeSocket()
 	#ifdef LINUX
 	if( false == SocketsProcessing::UsingEpoll())
 		SocketsProcessing::EpollDel( m_sfd);
+
+	// Operation in flight holds the socket, it will not be closed by close() only:
+	if( m_uring_pending )
+		shutdown( m_sfd, SHUT_RDWR);
 	#endif // LINUX
 
 	closesocket( m_sfd);
 
+	collectZombie();
+}
+
+void SocketItem::collectZombie()
+{
 	Profiler * _profiler = m_profiler;
 	// We should set member to NULL to not to delete it in dtor.
 	m_profiler = NULL;
@@ -589,13 +977,35 @@ void SocketItem::closeSocket()
 
 #ifdef LINUX
 bool SocketsProcessing::ms_epoll_enabled = false;
+bool SocketsProcessing::ms_uring_enabled = false;
 #endif
 SocketsProcessing * SocketsProcessing::ms_this = NULL;
 SocketsProcessing::SocketsProcessing( ThreadArgs * i_args):
-	m_threadargs( i_args)
+	m_threadargs( i_args),
+	m_stat_waiting_events( 0),
+	m_stat_waiting_events_answered( 0),
+	m_stat_queue_waits( 0),
+	m_stat_queue_wait_ms( 0),
+	m_stat_clients_rejected( 0)
 {
 	#ifdef LINUX
 	ms_epoll_enabled = af::Environment::getServerLinuxEpoll();
+
+	m_uring = NULL;
+	m_uring_wake_fd = -1;
+	m_uring_thread = NULL;
+	#ifndef NO_IO_URING
+	ms_uring_enabled = af::Environment::getServerLinuxIOURing();
+	#else
+	if( af::Environment::getServerLinuxIOURing())
+	{
+		AF_WARN << "Server is built without io_uring, using EPOLL.";
+		ms_epoll_enabled = true;
+	}
+	#endif
+	// io_uring replaces EPOLL:
+	if( ms_uring_enabled )
+		ms_epoll_enabled = false;
 	#endif
 
 	ms_this = this;
@@ -605,6 +1015,12 @@ SocketsProcessing::SocketsProcessing( ThreadArgs * i_args):
 	m_queue_proc = new SocketQueue("SocketsProcess");
 	m_queue_run  = new SocketQueue("SocketsRun");
 
+	// Burst is one second of rate, so a short peak does not need to wait:
+	m_client_limiter   = new RateLimiter("Clients",  af::Environment::getServerClientRate(),
+		af::Environment::getServerClientRate());
+	m_register_limiter = new RateLimiter("Register", af::Environment::getServerRenderRegisterRate(),
+		af::Environment::getServerRenderRegisterRate());
+
 	// Raising processing connections threads:
 	AF_LOG << "Raising " << af::Environment::getServerSocketsProcessingThreadsNum() << " threads to process incoming connections...";
 	for( int i = 0; i < af::Environment::getServerSocketsProcessingThreadsNum(); i++)
@@ -630,8 +1046,19 @@ SocketsProcessing::SocketsProcessing( ThreadArgs * i_args):
 		}
 	}
 
+	#if defined(LINUX) && !defined(NO_IO_URING)
+	if( UsingUring() && ( false == initUring()))
+	{
+		AF_WARN << "Failed to initialize io_uring, using EPOLL.";
+		ms_uring_enabled = false;
+		ms_epoll_enabled = true;
+	}
+	#endif
+
 	#ifdef LINUX
-	if( UsingEpoll())
+	if( UsingUring())
+		;
+	else if( UsingEpoll())
 		initEpoll();
 	else
 	#endif
@@ -695,8 +1122,24 @@ SocketsProcessing::~SocketsProcessing()
 		m_epoll_thread->Join();
 		delete m_epoll_thread;
 	}
+
+	#ifndef NO_IO_URING
+	if( m_uring_thread )
+	{
+		AF_LOG << "Finishing io_uring...";
+		uringWake();
+		m_uring_thread->Join();
+		delete m_uring_thread;
+	}
+	delete m_uring;
+	if( m_uring_wake_fd != -1 )
+		close( m_uring_wake_fd);
+	#endif
 	#endif
 
+	// Waiting events items are also stored in sockets list:
+	m_waiting_events.clear();
+
 	AF_LOG << "Deleting remaining " << m_sockets.size() << " socket items...";
 	std::list<SocketItem*>::iterator it = m_sockets.begin();
 	for( ;  it != m_sockets.end(); it++)
@@ -711,17 +1154,65 @@ SocketsProcessing::~SocketsProcessing()
 	delete m_queue_proc;
 	delete m_queue_io;
 
+	delete m_client_limiter;
+	delete m_register_limiter;
+
 	AF_LOG << "Deleting sockets processing.";
 }
 
+void SocketsProcessing::waitQueue()
+{
+	int queue_max = af::Environment::getServerSocketsQueueMax();
+	if( queue_max <= 0 )
+		return;
+
+	if( m_queue_proc->getCount() < queue_max )
+		return;
+
+	// Not accepted clients wait in the listen backlog,
+	// and requests that are already read are processed first.
+	int64_t wait_ms = af::getMonotonicMSec();
+	AF_WARN << "Sockets processing queue is full (" << queue_max << "), accepting paused.";
+
+	while( AFRunning && ( m_queue_proc->getCount() >= queue_max ))
+		af::sleep_msec( 10);
+
+	wait_ms = af::getMonotonicMSec() - wait_ms;
+	AF_LOG << "Accepting resumed after " << wait_ms << " ms.";
+
+	DlScopeLocker lock( &m_admission_mutex);
+	m_stat_queue_waits++;
+	m_stat_queue_wait_ms += wait_ms;
+}
+
 void SocketsProcessing::acceptSocket( int i_sfd, sockaddr_storage * i_sas)
 {
+	if( m_client_limiter->isEnabled())
+	{
+		// Client key is its IP address bytes (port is different for each connection):
+		std::string key;
+		if( i_sas->ss_family == AF_INET )
+			key.assign( (const char*)&(((struct sockaddr_in*)i_sas)->sin_addr), sizeof( struct in_addr));
+		else if( i_sas->ss_family == AF_INET6 )
+			key.assign( (const char*)&(((struct sockaddr_in6*)i_sas)->sin6_addr), sizeof( struct in6_addr));
+
+		if( false == m_client_limiter->allow( key))
+		{
+			closesocket( i_sfd);
+			delete i_sas;
+
+			DlScopeLocker lock( &m_admission_mutex);
+			m_stat_clients_rejected++;
+			return;
+		}
+	}
+
 	SocketItem * si = new SocketItem( i_sfd, i_sas);
 
 	#ifdef LINUX
-	if( UsingEpoll())
+	if( UsingEpoll() || UsingUring())
 	{
-		m_queue_io->pushSI( si);
+		pushIO( si);
 		return;
 	}
 	#endif
@@ -752,7 +1243,50 @@ void SocketsProcessing::acceptSocket( int i_sfd, sockaddr_storage * i_sas)
 
 	m_sockets.push_back( si);
 
-	m_queue_io->pushSI( si);
+	pushIO( si);
+}
+
+void SocketsProcessing::pushKept( af::Msg * i_msg, const sockaddr_storage * i_sas, int i_render_id, int64_t i_con_serial)
+{
+	m_queue_proc->pushSI( new SocketItem( i_msg, i_sas, i_render_id, i_con_serial));
+}
+
+void SocketsProcessing::pushIO( SocketItem * i_si)
+{
+	m_queue_io->pushSI( i_si);
+
+	#if defined(LINUX) && !defined(NO_IO_URING)
+	if( UsingUring())
+		uringWake();
+	#endif
+}
+
+bool SocketsProcessing::allowRenderRegister( int * o_retry_sec)
+{
+	return m_register_limiter->allow("TRenderRegister", o_retry_sec);
+}
+
+void SocketsProcessing::writeIOStat( std::ostringstream & o_str)
+{
+	#if defined(LINUX) && !defined(NO_IO_URING)
+	if( UsingUring())
+		m_uring->writeStat( o_str);
+	#endif
+}
+
+void SocketsProcessing::writeAdmissionStat( std::ostringstream & o_str)
+{
+	DlScopeLocker lock( &m_admission_mutex);
+
+	o_str << "\nSockets admission: processing queue " << m_queue_proc->getCount();
+	o_str << ", accept pauses " << m_stat_queue_waits << " (" << m_stat_queue_wait_ms << " ms)";
+	o_str << ", clients rejected " << m_stat_clients_rejected;
+	m_client_limiter->writeStat( o_str);
+	m_register_limiter->writeStat( o_str);
+
+	m_stat_queue_waits = 0;
+	m_stat_queue_wait_ms = 0;
+	m_stat_clients_rejected = 0;
 }
 
 void SocketsProcessing::ThreadFuncIO( void * i_args)
@@ -795,10 +1329,30 @@ void SocketsProcessing::doProc()
 	if( NULL == si )
 		return;
 
+	// Render kept connection message is not a socket, it is deleted just after processing:
+	if( si->isKept())
+	{
+		si->processKept( m_threadargs);
+		delete si;
+		return;
+	}
+
 	if( si->processMsg( m_threadargs))
-		m_queue_io->pushSI( si);
+	{
+		if( si->isWaitingEvents())
+		{
+			DlScopeLocker lock( &m_waiting_events_mutex);
+			m_waiting_events.push_back( si);
+			m_stat_waiting_events++;
+		}
+		else
+			pushIO( si);
+	}
 	else
+	{
 		m_queue_run->pushSI( si);
+		RunCycleWaker::Wake();
+	}
 }
 
 void SocketsProcessing::processRun()
@@ -807,9 +1361,40 @@ void SocketsProcessing::processRun()
 	while( ( si = m_queue_run->popSI( af::AfQueue::e_no_wait)) )
 	{
 		si->processRun( m_threadargs);
-		m_queue_io->pushSI( si);
+		pushIO( si);
 	}	
 }
+
+void SocketsProcessing::processWaitingEvents()
+{
+	DlScopeLocker lock( &m_waiting_events_mutex);
+
+	std::list<SocketItem*>::iterator it = m_waiting_events.begin();
+	while( it != m_waiting_events.end())
+	{
+		if((*it)->processWaitingEvents( m_threadargs))
+		{
+			pushIO( *it);
+			it = m_waiting_events.erase( it);
+			m_stat_waiting_events_answered++;
+			continue;
+		}
+
+		it++;
+	}
+}
+
+void SocketsProcessing::writeWaitingEventsStat( std::ostringstream & o_str)
+{
+	DlScopeLocker lock( &m_waiting_events_mutex);
+
+	o_str << "\nMonitors events requests: waiting " << m_waiting_events.size();
+	o_str << ", parked " << m_stat_waiting_events;
+	o_str << ", answered " << m_stat_waiting_events_answered;
+
+	m_stat_waiting_events = 0;
+	m_stat_waiting_events_answered = 0;
+}
 #ifdef LINUX
 void SocketsProcessing::initEpoll()
 {
@@ -882,7 +1467,8 @@ void SocketsProcessing::doEpoll()
 		{
 			if( false == si->isEpollAdded())
 				epollAddSocket( si);
-			si->writeMsg();
+			if( si->writeMsg())
+				m_queue_proc->pushSI( si);
 			break;
 		}
 		default:
@@ -930,6 +1516,11 @@ void SocketsProcessing::doEpoll()
 		{
 			(*it)->checkClosed();
 		}
+		// Check kept alive HTTP connections:
+		else if((*it)->getState() == SocketItem::SSReading )
+		{
+			(*it)->checkKeepAlive();
+		}
 
 		// Free zombies:
 		if((*it)->isZombie())
@@ -948,5 +1539,181 @@ void SocketsProcessing::EpollDel( int i_sfd)
 {
 	epoll_ctl( ms_this->m_epoll_fd, EPOLL_CTL_DEL, i_sfd, NULL);
 }
+
+#ifndef NO_IO_URING
+// io_uring completions user data, that are not socket items:
+static const uint64_t UringWakeData    = 1;
+static const uint64_t UringTimeoutData = 2;
+
+bool SocketsProcessing::initUring()
+{
+	m_uring = new IOURing();
+	if( false == m_uring->init( 1024))
+		return false;
+
+	// Other threads wake io_uring thread writing to this descriptor:
+	m_uring_wake_fd = eventfd( 0, EFD_CLOEXEC);
+	if( m_uring_wake_fd == -1 )
+	{
+		AF_ERR << "eventfd: " << strerror( errno);
+		return false;
+	}
+
+	// Start one thread to submit operations and process completions:
+	m_uring_thread = new DlThread();
+	m_uring_thread->Start( ThreadFuncUring, NULL );
+
+	return true;
+}
+
+void SocketsProcessing::ThreadFuncUring( void * i_args)
+{
+	AF_WARN << "Using non-blocking IO based on Linux io_uring facility.";
+
+	ms_this->uringWakeRead();
+	struct io_uring_sqe * sqe = ms_this->m_uring->getSqe();
+	ms_this->m_uring->prepTimeout( sqe, 128, UringTimeoutData);
+
+	while( AFRunning )
+		ms_this->doUring();
+}
+
+void SocketsProcessing::uringWakeRead()
+{
+	struct io_uring_sqe * sqe = m_uring->getSqe();
+	if( NULL == sqe )
+	{
+		AF_ERR << "io_uring: No submission entry for wake reading.";
+		return;
+	}
+
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = m_uring_wake_fd;
+	sqe->addr = (uint64_t)(uintptr_t)&m_uring_wake_value;
+	sqe->len = sizeof( m_uring_wake_value);
+	sqe->user_data = UringWakeData;
+}
+
+void SocketsProcessing::uringWake()
+{
+	uint64_t value = 1;
+	if( write( m_uring_wake_fd, &value, sizeof( value)) != sizeof( value))
+		AF_ERR << "io_uring: wake write: " << strerror( errno);
+}
+
+void SocketsProcessing::uringSubmitSocket( SocketItem * i_si)
+{
+	if( i_si->isUringPending())
+		return;
+
+	// Waiting for close sockets are checked by the thread cycle:
+	if(( i_si->getState() != SocketItem::SSReading ) && ( i_si->getState() != SocketItem::SSWriting ))
+		return;
+
+	struct io_uring_sqe * sqe = m_uring->getSqe();
+	if( NULL == sqe )
+	{
+		AF_ERR << "io_uring: No submission entry for: " << i_si;
+		return;
+	}
+
+	// Socket has nothing to read or write, entry is submitted as a no operation:
+	if( false == i_si->uringPrepare( sqe))
+		sqe->opcode = IORING_OP_NOP;
+}
+
+void SocketsProcessing::doUring()
+{
+	// Add incoming sockets, to read after accept, or to write after processing:
+	SocketItem * si;
+	while(( si = m_queue_io->popSI( af::AfQueue::e_no_wait)))
+	{
+		if( false == AFRunning )
+			return;
+
+		switch( si->getState())
+		{
+		case SocketItem::SSReading:
+			m_sockets.push_back( si);
+			break;
+		case SocketItem::SSProcessing:
+			si->writeMsg();
+			break;
+		default:
+			AF_ERR << "Got a new socket item with an invalid state: " << si;
+			continue;
+		}
+
+		uringSubmitSocket( si);
+	}
+
+	// All new operations are submitted by one call, that waits for completions:
+	if( false == m_uring->submit(1))
+	{
+		AFRunning = false;
+		return;
+	}
+
+	struct io_uring_cqe * cqe;
+	while(( cqe = m_uring->peekCqe()))
+	{
+		uint64_t user_data = cqe->user_data;
+		int result = cqe->res;
+		m_uring->cqeSeen();
+
+		if( user_data == UringWakeData )
+		{
+			uringWakeRead();
+			continue;
+		}
+
+		if( user_data == UringTimeoutData )
+		{
+			struct io_uring_sqe * sqe = m_uring->getSqe();
+			if( sqe )
+				m_uring->prepTimeout( sqe, 128, UringTimeoutData);
+			continue;
+		}
+
+		// No operation entries have no user data:
+		if( user_data == 0 )
+			continue;
+
+		si = (SocketItem*)(uintptr_t)user_data;
+
+		if( si->uringComplete( result))
+			m_queue_proc->pushSI( si);
+		else
+			uringSubmitSocket( si);
+	}
+
+	// Process waiting sockets:
+	std::list<SocketItem*>::iterator it = m_sockets.begin();
+	while( it != m_sockets.end())
+	{
+		// Check waiting items:
+		if((*it)->getState() == SocketItem::SSWaiting )
+		{
+			(*it)->checkClosed();
+		}
+		// Check kept alive HTTP connections:
+		else if((*it)->getState() == SocketItem::SSReading )
+		{
+			(*it)->checkKeepAlive();
+		}
+
+		// Free zombies, that have no operations in flight:
+		if((*it)->isZombie() && ( false == (*it)->isUringPending()))
+		{
+			SocketItem * zombie = *it;
+			it = m_sockets.erase( it);
+			delete zombie;
+			continue;
+		}
+
+		it++;
+	}
+}
+#endif // NO_IO_URING
 #endif // LINUX
 
@@ -1,18 +1,29 @@
 #pragma once
 
 #include "../libafanasy/afqueue.h"
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/common/dlRWLock.h"
 #include "../libafanasy/name_af.h"
 
 #include "threadargs.h"
 
+#ifdef LINUX
+#include <sys/uio.h>
+#endif
+
 class DlThread;
+class IOURing;
 class Profiler;
+class RateLimiter;
+
+struct io_uring_sqe;
 
 class SocketItem: public af::AfQueueItem
 {
 public:
 	SocketItem( int i_sfd, sockaddr_storage * i_sas);
+	/// Render kept connection message, it is read and answered by render connections polling thread.
+	SocketItem( af::Msg * i_msg, const sockaddr_storage * i_sas, int i_render_id, int64_t i_con_serial);
 	~SocketItem();
 
 	enum SocketState {
@@ -30,11 +41,19 @@ public:
 	inline int  getState() const { return m_state;}
 	inline int  getSFD()   const { return m_sfd;}
 	inline bool isZombie() const { return m_zombie;}
+	inline bool isKept()   const { return m_kept_render_id != 0;}
 
 	bool readMsg();
 	bool processMsg( ThreadArgs * i_args);
 	void processRun( ThreadArgs * i_args);
-	void writeMsg();
+	/// Process render kept connection message and hand the answer over to render connections.
+	void processKept( ThreadArgs * i_args);
+	/// Monitor events request waits for events, it is answered by run thread after dispatch.
+	inline bool isWaitingEvents() const { return m_wait_monitor_id != 0; }
+	/// Returns true if waiting events request is answered and should be written.
+	bool processWaitingEvents( ThreadArgs * i_args);
+	/// Returns true if the next request of a kept alive connection is already read.
+	bool writeMsg();
 	void checkClosed();
 
 	#ifdef LINUX
@@ -42,11 +61,26 @@ public:
 	bool processIO( int i_events);
 	inline void setEpollAdded() { m_epoll_added = true; }
 	inline bool isEpollAdded() const { return m_epoll_added; }
+
+	/// Close kept alive HTTP connection if it is idle for too long.
+	void checkKeepAlive();
+
+	// For io_uring IO:
+	/// Fill read or write operation for the current state, returns false if nothing to submit.
+	bool uringPrepare( struct io_uring_sqe * o_sqe);
+	/// Process operation result, returns true if request is read and should be processed.
+	bool uringComplete( int i_result);
+	inline bool isUringPending() const { return m_uring_pending; }
 	#endif
 
 private:
+	/// Compress big HTTP answer, if client accepts gzip encoding.
+	void compressAnswer();
+
+	bool handOver();
 	void waitClose();
 	void closeSocket();
+	void collectZombie();
 
 private:
 	int m_state;
@@ -62,18 +96,45 @@ private:
 	time_t m_wait_time;
 	bool m_zombie;
 
+	/// HTTP client asked to keep connection alive for next requests (EPOLL IO only).
+	bool m_keep_alive;
+
+	int    m_wait_monitor_id;
+	time_t m_wait_monitor_time;
+
+	int     m_kept_render_id;
+	int64_t m_kept_con_serial;
+
 	#ifdef LINUX
 	// For non-blocking IO:
 	bool readData();
+	/// Where to read the next request bytes, returns bytes to read.
+	int  readTarget( char ** o_buffer) const;
+	/// Process read result, returns true if request is read.
+	bool readDone( int i_size, int i_errno);
+	bool processReadHeader();
 	int  m_bytes_read;
 	bool m_header_reading_finished;
 	bool m_reading_finished;
 	bool m_epoll_added;
 
-	void   writeData();
-	char * m_write_buffer;
-	int    m_write_size;
-	int    m_bytes_written;
+	/// Prepare kept alive connection to read the next request.
+	bool keepAlive();
+	int         m_requests;   ///< Requests answered on this connection.
+	std::string m_pipelined;  ///< Next request bytes, that were read with the current request.
+
+	bool        writeData();
+	/// Prepare answer bytes to write, returns io vectors count (zero if nothing to write).
+	int         writeTarget();
+	/// Process write result, returns true if the next kept alive request is already read.
+	bool        writeDone( int i_bytes, int i_errno);
+	bool        m_write_started;
+	std::string m_write_header;
+	int         m_write_size;
+	int         m_bytes_written;
+	struct iovec m_write_iov[2];
+
+	bool m_uring_pending; ///< Read or write operation is submitted to io_uring.
 	#endif
 };
 
@@ -92,12 +153,35 @@ public:
 	SocketsProcessing( ThreadArgs * i_args);
 	~SocketsProcessing();
 
+	/// Called by accept thread before accept, to not to accept more clients,
+	/// while too many requests are waiting for processing.
+	void waitQueue();
+
 	void acceptSocket( int i_sfd, sockaddr_storage * i_sas);
 
+	/// Called by render connections polling thread to process a kept connection message.
+	/// Takes message ownership, answer is handed back by RenderConnections::Answer.
+	void pushKept( af::Msg * i_msg, const sockaddr_storage * i_sas, int i_render_id, int64_t i_con_serial);
+
+	/// Whether a render can register now.
+	/// If not, \c o_retry_sec is set to seconds to retry after.
+	bool allowRenderRegister( int * o_retry_sec);
+
+	void writeAdmissionStat( std::ostringstream & o_str);
+
+	void writeIOStat( std::ostringstream & o_str);
+
 	void processRun();
 
+	/// Answer monitors events requests that have events or waited for too long.
+	/// Called by run thread after events dispatch, monitors should be locked.
+	void processWaitingEvents();
+
+	void writeWaitingEventsStat( std::ostringstream & o_str);
+
 	#ifdef LINUX
 	inline static bool UsingEpoll() { return ms_epoll_enabled; }
+	inline static bool UsingUring() { return ms_uring_enabled; }
 	static void EpollDel( int i_sfd);
 	#endif
 
@@ -105,6 +189,9 @@ private:
 	static void ThreadFuncProc( void * i_args);
 	void doProc();
 
+	/// Push socket to read/write, IO thread is woken if needed.
+	void pushIO( SocketItem * i_si);
+
 	static SocketsProcessing * ms_this;
 
 	ThreadArgs * m_threadargs;
@@ -115,6 +202,20 @@ private:
 	SocketQueue * m_queue_proc;
 	SocketQueue * m_queue_run;
 
+	// Monitors events requests, that are waiting for events:
+	std::list<SocketItem*> m_waiting_events;
+	DlMutex m_waiting_events_mutex;
+	int64_t m_stat_waiting_events;
+	int64_t m_stat_waiting_events_answered;
+
+	// Admission control:
+	RateLimiter * m_client_limiter;
+	RateLimiter * m_register_limiter;
+	DlMutex m_admission_mutex;
+	int64_t m_stat_queue_waits;
+	int64_t m_stat_queue_wait_ms;
+	int64_t m_stat_clients_rejected;
+
 	std::vector<DlThread*> m_threads_proc;
 	std::vector<DlThread*> m_threads_io;
 
@@ -135,5 +236,19 @@ private:
 	static bool ms_epoll_enabled;
 	int m_epoll_fd;
 	DlThread * m_epoll_thread;
+
+	// Non-Blocking/io_uring IO:
+	static void ThreadFuncUring( void * i_args);
+	bool initUring();
+	void doUring();
+	void uringSubmitSocket( SocketItem * i_si);
+	void uringWakeRead();
+	void uringWake();
+
+	static bool ms_uring_enabled;
+	IOURing * m_uring;
+	int m_uring_wake_fd;
+	uint64_t m_uring_wake_value;
+	DlThread * m_uring_thread;
 	#endif
 };
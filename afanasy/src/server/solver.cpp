@@ -19,6 +19,7 @@
 #include "../include/afanasy.h"
 #include "../libafanasy/environment.h"
 
+#include "afcommon.h"
 #include "afnodesolve.h"
 #include "branchescontainer.h"
 #include "jobcontainer.h"
@@ -38,10 +39,18 @@ UserContainer     * Solver::ms_usercontainer     = NULL;
 MonitorContainer  * Solver::ms_monitorcontaier   = NULL;
 
 uint64_t Solver::ms_run_cycle = 0;
+time_t Solver::ms_wol_time = 0;
 const int Solver::ms_solve_cycles_limit = 11000;
 int Solver::ms_awaken_renders = 0;
 const int Solver::ms_awaken_renders_max = 1;
 
+int64_t Solver::ms_stat_time = 0;
+int64_t Solver::ms_stat_solves = 0;
+int64_t Solver::ms_stat_solve_time = 0;
+int64_t Solver::ms_stat_solve_time_max = 0;
+int64_t Solver::ms_stat_tasks = 0;
+int64_t Solver::ms_stat_cycles = 0;
+
 Solver::Solver(
 		BranchesContainer * i_branchescontainer,
 		JobContainer      * i_jobcontainer,
@@ -59,44 +68,22 @@ Solver::Solver(
 
 Solver::~Solver(){}
 
-struct MostReadyRender : public std::binary_function <RenderAf*,RenderAf*,bool>
+void Solver::RankRenders(const AfNodeSolve * i_node, const std::list<RenderAf*> & i_renders, af::RendersRanking & o_ranking)
 {
-	const AfNodeSolve * m_node;
-	MostReadyRender(const AfNodeSolve * i_node) {m_node = i_node;}
+	o_ranking.reset(int(i_renders.size()));
 
-	inline bool operator()( const RenderAf * a, const RenderAf * b)
+	for (std::list<RenderAf*>::const_iterator it = i_renders.begin(); it != i_renders.end(); it++)
 	{
-		// Offline renders needed for Wake-On-Lan.
-		// Offline render is less ready.
-		if( a->isOnline() && b->isOffline()) return true;
-		if( a->isOffline() && b->isOnline()) return false;
-
-		int pool_priority_a = m_node->getPoolPriority(a);
-		int pool_priority_b = m_node->getPoolPriority(b);
-		if(pool_priority_a > pool_priority_b) return true;
-		if(pool_priority_a < pool_priority_b) return false;
-
-		if( a->getTasksNumber() < b->getTasksNumber()) return true;
-		if( a->getTasksNumber() > b->getTasksNumber()) return false;
-
-		if( a->findCapacityFree() > b->findCapacityFree()) return true;
-		if( a->findCapacityFree() < b->findCapacityFree()) return false;
-
-		if( a->getPriority() > b->getPriority()) return true;
-		if( a->getPriority() < b->getPriority()) return false;
+		af::RendersRanking::Key key = (*it)->getSolveKey();
 
-		if( a->getTasksStartFinishTime() < b->getTasksStartFinishTime()) return true;
-		if( a->getTasksStartFinishTime() > b->getTasksStartFinishTime()) return false;
+		// Only pool priority depends on a node:
+		key.pool_priority = i_node->getPoolPriority(*it);
 
-		if( a->findCapacity() > b->findCapacity()) return true;
-		if( a->findCapacity() < b->findCapacity()) return false;
-
-		if( a->findMaxTasks() > b->findMaxTasks()) return true;
-		if( a->findMaxTasks() < b->findMaxTasks()) return false;
-
-		return a->getName().compare( b->getName()) < 0;
+		o_ranking.add(key, *it);
 	}
-};
+
+	o_ranking.rank();
+}
 
 // Functor for sorting algorithm
 struct GreaterNeed : public std::binary_function<AfNodeSolve*,AfNodeSolve*,bool>
@@ -132,6 +119,8 @@ void Solver::solve()
 	ms_run_cycle++;
 	AF_DEBUG << "Solving jobs...";
 
+	int64_t solve_start_time = af::getMonotonicMSec();
+
 	// To start solving we need to solve the root branch:
 	std::list<AfNodeSolve*> solve_list;
 	solve_list.push_back(ms_branchescontainer->getRootBranch());
@@ -142,6 +131,32 @@ void Solver::solve()
 	int tasks_solved = 0;
 	ms_awaken_renders = 0;
 
+	// Renders waking interval is checked by time,
+	// as run cycles can be started by events, not only every second.
+	// Renders to wake are collected once, as they are not changing during solving.
+	std::list<RenderAf*> wol_renders;
+	time_t current_time = time(NULL);
+	if (current_time - ms_wol_time >= af::Environment::getWOLWakeInterval())
+	{
+		ms_wol_time = current_time;
+
+		RenderContainerIt rendersIt(ms_rendercontainer);
+		for (RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
+			if ((false == render->isReady()) && render->isWOLWakeAble())
+				wol_renders.push_back(render);
+	}
+
+	// Ready renders are stored in container and updated on render changes,
+	// so there is no need to check all renders on each solve.
+	// Candidates list is constructed once and is updated after each solved task,
+	// as only the render that got a task (or was woken up) can change.
+	const std::vector<RenderAf*> & ready_renders = ms_rendercontainer->getReadyRenders();
+	std::list<RenderAf*> renders_list(ready_renders.begin(), ready_renders.end());
+
+	// Not ready renders, but may be we should wake them up:
+	if (ms_awaken_renders < ms_awaken_renders_max)
+		renders_list.insert(renders_list.end(), wol_renders.begin(), wol_renders.end());
+
 	// Start solve cycle.
 	// If some node was solved it means that it can be solved again.
 	// If some node was not solved it can't be solved again (before something changed),
@@ -163,44 +178,71 @@ void Solver::solve()
 		if (false == ms_branchescontainer->getRootBranch()->canRun())
 			break;
 
-		// Get ready renders:
-		std::list<RenderAf*> renders_list;
-		RenderContainerIt rendersIt(ms_rendercontainer);
-		for (RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
-		{
-			// Check that render is ready to run a task:
-			if (false == render->isReady())
-			{
-				// Render is not ready, but may be we should wake it up?
-				if ((false == render->isWOLWakeAble()) ||
-					(ms_awaken_renders >= ms_awaken_renders_max) ||
-					(ms_run_cycle % af::Environment::getWOLWakeInterval() != 0))
-				{
-					continue; ///< - We should not.
-				}
-			}
-
-			renders_list.push_back(render);
-		}
-
 		// Function exits on each solve success (just 1 task solved),
 		// removes nodes that was not solved from list.
 		RenderAf * render = SolveList(solve_list, renders_list, ms_branchescontainer->getRootBranch());
-		if (render)
+		if (NULL == render)
+			continue;
+
+		// Check Wake-On-LAN:
+		if (render->isWOLWakeAble())
 		{
-			// Check Wake-On-LAN:
-			if (render->isWOLWakeAble())
+			AF_DEBUG << "Solving waking up render '" << render->node()->getName() << "'.";
+			render->wolWake(ms_monitorcontaier, std::string("Automatic waking by a job."));
+			ms_awaken_renders++;
+
+			// Waking renders limit reached, remove all sleeping renders from candidates:
+			if (ms_awaken_renders >= ms_awaken_renders_max)
 			{
-				AF_DEBUG << "Solving waking up render '" << render->node()->getName() << "'.";
-				render->wolWake(ms_monitorcontaier, std::string("Automatic waking by a job."));
-				ms_awaken_renders++;
+				for (std::list<RenderAf*>::iterator it = wol_renders.begin(); it != wol_renders.end(); it++)
+					renders_list.remove(*it);
+				continue;
 			}
-			else
-				tasks_solved++;
 		}
+		else
+			tasks_solved++;
+
+		// Render can be not ready any more after a task was started on it:
+		if ((false == render->isReady()) && (false == render->isWOLWakeAble()))
+			renders_list.remove(render);
 	}
 
 	AF_DEBUG << "Solved " << tasks_solved << " tasks within " << solve_cycle << " cycles.";
+
+	int64_t now = af::getMonotonicMSec();
+	Profile(now, now - solve_start_time, tasks_solved, solve_cycle);
+}
+
+void Solver::Profile(int64_t i_now, int64_t i_solve_time, int i_tasks_solved, int i_solve_cycles)
+{
+	ms_stat_solves++;
+	ms_stat_solve_time += i_solve_time;
+	if (i_solve_time > ms_stat_solve_time_max)
+		ms_stat_solve_time_max = i_solve_time;
+	ms_stat_tasks += i_tasks_solved;
+	ms_stat_cycles += i_solve_cycles;
+
+	if (ms_stat_time == 0)
+		ms_stat_time = i_now;
+
+	int64_t msec = i_now - ms_stat_time;
+	if (msec < 1000 * int64_t(af::Environment::getServerProfilingSec()))
+		return;
+
+	std::ostringstream log;
+	log << "Solving: " << ms_stat_solves << " solves in last " << (msec / 1000) << " seconds";
+	log << ", tasks: " << ms_stat_tasks << ", cycles: " << ms_stat_cycles;
+	log << ", average: " << (ms_stat_solve_time / ms_stat_solves) << " ms, max: " << ms_stat_solve_time_max << " ms";
+	if (ms_stat_solve_time > 0)
+		log << ", solves per second: " << (1000 * ms_stat_solves / ms_stat_solve_time);
+	AFCommon::QueueLog(log.str());
+
+	ms_stat_time = i_now;
+	ms_stat_solves = 0;
+	ms_stat_solve_time = 0;
+	ms_stat_solve_time_max = 0;
+	ms_stat_tasks = 0;
+	ms_stat_cycles = 0;
 }
 
 RenderAf * Solver::SolveList(std::list<AfNodeSolve*> & i_list, std::list<RenderAf*> & i_renders, BranchSrv * i_branch)
@@ -219,9 +261,8 @@ RenderAf * Solver::SolveList(std::list<AfNodeSolve*> & i_list, std::list<RenderA
 			renders.push_back(*rIt);
 		}
 
-		// Sort renders:
-		renders.sort(MostReadyRender(*it));
-
+		// Renders are not sorted here, a node ranks them itself when solving on them,
+		// as a branch or a user node just passes them to its child nodes.
 		RenderAf * render = (*it)->solve(renders, ms_monitorcontaier, i_branch);
 
 		if (render)
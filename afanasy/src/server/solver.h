@@ -18,13 +18,15 @@
 
 #include "../libafanasy/afwork.h"
 #include "../libafanasy/name_af.h"
+#include "../libafanasy/rendersranking.h"
+
+#include "renderaf.h"
 
 class AfNodeSolve;
 class BranchesContainer;
 class BranchSrv;
 class JobContainer;
 class MonitorContainer;
-class RenderAf;
 class RenderContainer;
 class UserContainer;
 
@@ -46,6 +48,12 @@ public:
 	static void SortList(std::list<AfNodeSolve*> & i_list, int i_solving_flags);
 	static RenderAf * SolveList(std::list<AfNodeSolve*> & i_list, std::list<RenderAf*> & i_renders, BranchSrv * i_branch);
 
+	/// Rank renders for a node by their stored solving keys.
+	static void RankRenders(const AfNodeSolve * i_node, const std::list<RenderAf*> & i_renders, af::RendersRanking & o_ranking);
+
+private:
+	static void Profile(int64_t i_now, int64_t i_solve_time, int i_tasks_solved, int i_solve_cycles);
+
 private:
 	static BranchesContainer * ms_branchescontainer;
 	static JobContainer      * ms_jobcontainer;
@@ -54,8 +62,17 @@ private:
 	static MonitorContainer  * ms_monitorcontaier;
 
 	static uint64_t ms_run_cycle;
+	static time_t ms_wol_time;
 	static const int ms_solve_cycles_limit;
 	static int ms_awaken_renders;
 	static const int ms_awaken_renders_max;
+
+	// Solving statistics, logged each profiling period:
+	static int64_t ms_stat_time;
+	static int64_t ms_stat_solves;
+	static int64_t ms_stat_solve_time;
+	static int64_t ms_stat_solve_time_max;
+	static int64_t ms_stat_tasks;
+	static int64_t ms_stat_cycles;
 };
 
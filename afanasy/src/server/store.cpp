@@ -4,6 +4,8 @@
 
 #include "../libafanasy/environment.h"
 
+#include "../libafanasy/common/dlScopeLocker.h"
+
 #include "afcommon.h"
 
 #define AFOUTPUT
@@ -49,10 +51,25 @@ Store::~Store()
 	save();
 }
 
+int64_t Store::getJobSerial()
+{
+	int64_t serial;
+	{
+		DlScopeLocker lock( &m_mutex);
+		serial = ++m_jobs_serial;
+	}
+
+	save();
+
+	return serial;
+}
+
 void Store::save()
 {
 	static const char timeformat[] = "%Y.%m.%d %H:%M.%S";
 
+	DlScopeLocker lock( &m_mutex);
+
 	m_time_modified = time(NULL);
 
 	std::ostringstream oss;
@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include <string>
 
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/name_af.h"
 
 class Store
@@ -18,8 +19,8 @@ public:
 	/// Save to disk:
 	void save();
 
-	inline int64_t getJobSerial()
-		{ int64_t serial = ++m_jobs_serial; save(); return serial; }
+	/// Jobs can be read from store by several threads, so it is locked.
+	int64_t getJobSerial();
 
 private:
 	void read( const JSON & i_object);
@@ -35,4 +36,6 @@ private:
 private:
 
 	std::string m_filename;
+
+	DlMutex m_mutex;
 };
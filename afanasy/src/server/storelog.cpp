@@ -0,0 +1,867 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Store log.
+	Snapshot and log files start with a header: magic and generation.
+	Snapshot generation is increased on each rewrite, log is reset with the same generation.
+	If server stops after a new snapshot rename, but before the log reset,
+	log has the previous generation and is skipped on start, as all its data is in the snapshot.
+	Record: checksum, type, path length, data length, path, data.
+	Checksum is FNV-1a of the record after the checksum field.
+	A broken record at the log end means that server was stopped while writing, log is truncated there.
+*/
+#include "storelog.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef WINNT
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../include/afanasy.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
+
+#include "afcommon.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+StoreLog * StoreLog::ms_this = NULL;
+
+namespace
+{
+const char Magic[8] = {'A','F','S','T','L','O','G','1'};
+const int HeaderSize = 16;
+const int RecordHeaderSize = 16;
+const int PathLengthMax = 4096;
+
+// Log is synced at least every this number of records:
+const int SyncRecordsMax = 1000;
+// Log smaller than this is not compacted to a snapshot by age:
+const int64_t SnapshotLogMin = 1 << 16;
+// Snapshot is written and loaded by buffers of this size:
+const int BufferSize = 1 << 22;
+
+uint32_t checksum( uint32_t i_hash, const char * i_data, int64_t i_size)
+{
+	for( int64_t i = 0; i < i_size; i++)
+	{
+		i_hash ^= uint8_t( i_data[i]);
+		i_hash *= 16777619u;
+	}
+	return i_hash;
+}
+
+uint32_t recordChecksum( const char * i_record, const std::string & i_path, const char * i_data, int i_length)
+{
+	uint32_t hash = 2166136261u;
+	hash = checksum( hash, i_record + 4, RecordHeaderSize - 4);
+	hash = checksum( hash, i_path.data(), i_path.size());
+	hash = checksum( hash, i_data, i_length);
+	return hash;
+}
+
+void recordHeader( char * o_buf, int i_type, const std::string & i_path, const char * i_data, int i_length)
+{
+	uint32_t fields[4] = {0, uint32_t( i_type), uint32_t( i_path.size()), uint32_t( i_length)};
+	memcpy( o_buf, fields, RecordHeaderSize);
+	fields[0] = recordChecksum( o_buf, i_path, i_data, i_length);
+	memcpy( o_buf, fields, 4);
+}
+
+void fileHeader( char * o_buf, int64_t i_generation)
+{
+	memcpy( o_buf, Magic, 8);
+	memcpy( o_buf + 8, &i_generation, 8);
+}
+
+bool writeAt( int i_fd, const char * i_data, int64_t i_size, int64_t i_offset)
+{
+	while( i_size > 0 )
+	{
+#ifdef WINNT
+		if( _lseeki64( i_fd, i_offset, SEEK_SET) < 0 ) return false;
+		int bytes = _write( i_fd, i_data, i_size);
+#else
+		ssize_t bytes = pwrite( i_fd, i_data, i_size, i_offset);
+#endif
+		if( bytes < 0 )
+		{
+			if( errno == EINTR ) continue;
+			return false;
+		}
+		i_data   += bytes;
+		i_size   -= bytes;
+		i_offset += bytes;
+	}
+	return true;
+}
+
+bool readAt( int i_fd, char * o_data, int64_t i_size, int64_t i_offset)
+{
+	while( i_size > 0 )
+	{
+#ifdef WINNT
+		if( _lseeki64( i_fd, i_offset, SEEK_SET) < 0 ) return false;
+		int bytes = _read( i_fd, o_data, i_size);
+#else
+		ssize_t bytes = pread( i_fd, o_data, i_size, i_offset);
+#endif
+		if( bytes < 0 )
+		{
+			if( errno == EINTR ) continue;
+			return false;
+		}
+		if( bytes == 0 )
+			return false;
+		o_data   += bytes;
+		i_size   -= bytes;
+		i_offset += bytes;
+	}
+	return true;
+}
+
+bool syncFile( int i_fd)
+{
+#ifdef WINNT
+	return _commit( i_fd) == 0;
+#else
+	return fsync( i_fd) == 0;
+#endif
+}
+
+bool truncateFile( int i_fd, int64_t i_size)
+{
+#ifdef WINNT
+	return _chsize_s( i_fd, i_size) == 0;
+#else
+	return ftruncate( i_fd, i_size) == 0;
+#endif
+}
+
+int64_t fileSize( int i_fd)
+{
+	struct stat st;
+	if( fstat( i_fd, &st) != 0 )
+		return -1;
+	return st.st_size;
+}
+
+/// Reads a file sequentially by big buffers.
+class Reader
+{
+public:
+	Reader( int i_fd, int64_t i_size): m_fd( i_fd), m_size( i_size), m_start( 0), m_end( 0) {}
+
+	/// Get a pointer to file data, NULL if it is out of file or can't be read.
+	const char * get( int64_t i_offset, int64_t i_length)
+	{
+		if( i_offset + i_length > m_size )
+			return NULL;
+
+		if(( i_offset >= m_start ) && ( i_offset + i_length <= m_end ))
+			return &m_buffer[i_offset - m_start];
+
+		int64_t length = m_size - i_offset;
+		if( length > BufferSize )
+			length = BufferSize;
+		if( length < i_length )
+			length = i_length;
+
+		if( int64_t( m_buffer.size()) < length )
+			m_buffer.resize( length);
+
+		if( false == readAt( m_fd, &m_buffer[0], length, i_offset))
+			return NULL;
+
+		m_start = i_offset;
+		m_end = i_offset + length;
+
+		return &m_buffer[0];
+	}
+
+private:
+	int m_fd;
+	int64_t m_size;
+	std::vector<char> m_buffer;
+	int64_t m_start;
+	int64_t m_end;
+};
+
+/// Whether a file name in a node store folder is kept in the log.
+bool isLogFileName( const std::string & i_name)
+{
+	if(( i_name == "data.json" ) || ( i_name == "tasks_progress.journal" ))
+		return true;
+
+	// Job block tasks: block<number>_tasks.json
+	if(( i_name.find("block") == 0 ) && ( i_name.size() > 16 ) && ( i_name.rfind("_tasks.json") == i_name.size() - 11 ))
+		return true;
+
+	return false;
+}
+}
+
+StoreLog::StoreLog( const std::string & i_folder):
+	m_folder( i_folder),
+	m_snapshot_fd( -1),
+	m_log_fd( -1),
+	m_generation( 0),
+	m_snapshot_size( 0),
+	m_snapshot_time( 0),
+	m_log_size( 0),
+	m_unsynced( 0),
+	m_stat_records( 0),
+	m_stat_bytes( 0),
+	m_stat_syncs( 0),
+	m_stat_snapshots( 0),
+	m_stat_snapshot_ms( 0)
+{
+	m_snapshot_file = m_folder + AFGENERAL::PATH_SEPARATOR + "store.snapshot";
+	m_log_file      = m_folder + AFGENERAL::PATH_SEPARATOR + "store.log";
+}
+
+StoreLog::~StoreLog()
+{
+	if( m_log_fd != -1 )
+		::close( m_log_fd);
+	if( m_snapshot_fd != -1 )
+		::close( m_snapshot_fd);
+}
+
+bool StoreLog::Open( const std::string & i_folder)
+{
+	if( ms_this )
+		return true;
+
+	StoreLog * store = new StoreLog( i_folder);
+	if( false == store->open())
+	{
+		delete store;
+		return false;
+	}
+
+	ms_this = store;
+	return true;
+}
+
+void StoreLog::Close()
+{
+	if( NULL == ms_this )
+		return;
+
+	// Files queue thread can be canceled while writing a record and holding the mutex:
+	if( ms_this->m_mutex.TryLock())
+	{
+		ms_this->sync();
+		ms_this->m_mutex.Unlock();
+	}
+	else
+		syncFile( ms_this->m_log_fd);
+
+	AF_LOG << "Store log closed: " << ms_this->m_entries.size() << " files, log " << ( ms_this->m_log_size >> 10) << " KB.";
+
+	delete ms_this;
+	ms_this = NULL;
+}
+
+bool StoreLog::open()
+{
+	int64_t time = af::getMonotonicMSec();
+
+	bool fresh = true;
+
+	// Load snapshot:
+	if( af::pathFileExists( m_snapshot_file))
+	{
+		fresh = false;
+#ifdef WINNT
+		m_snapshot_fd = ::open( m_snapshot_file.c_str(), O_RDONLY | O_BINARY);
+#else
+		m_snapshot_fd = ::open( m_snapshot_file.c_str(), O_RDONLY);
+#endif
+		if( m_snapshot_fd == -1 )
+		{
+			AF_ERR << "Can't open store snapshot: " << m_snapshot_file << ": " << strerror( errno);
+			return false;
+		}
+
+		int64_t size;
+		if( false == load( m_snapshot_fd, true, m_generation, size))
+			return false;
+
+		m_snapshot_size = size;
+	}
+
+	// Load log:
+#ifdef WINNT
+	m_log_fd = ::open( m_log_file.c_str(), O_RDWR | O_CREAT | O_BINARY, 0644);
+#else
+	m_log_fd = ::open( m_log_file.c_str(), O_RDWR | O_CREAT, 0644);
+#endif
+	if( m_log_fd == -1 )
+	{
+		AF_ERR << "Can't open store log: " << m_log_file << ": " << strerror( errno);
+		return false;
+	}
+
+	int64_t file_size = fileSize( m_log_fd);
+	if( file_size > HeaderSize )
+		fresh = false;
+
+	int64_t generation = -1;
+	int64_t size = 0;
+	if( file_size >= HeaderSize )
+	{
+		char header[HeaderSize];
+		if( readAt( m_log_fd, header, HeaderSize, 0))
+			memcpy( &generation, header + 8, 8);
+	}
+
+	if( generation == m_generation )
+	{
+		if( false == load( m_log_fd, false, generation, size))
+			return false;
+
+		if( size < file_size )
+		{
+			AF_WARN << "Store log is truncated from " << file_size << " to " << size << " bytes, last records were not finished.";
+			if( false == truncateFile( m_log_fd, size))
+			{
+				AF_ERR << "Can't truncate store log: " << strerror( errno);
+				return false;
+			}
+		}
+		m_log_size = size;
+	}
+	else
+	{
+		if( file_size > HeaderSize )
+			AF_WARN << "Store log generation " << generation << " is older than snapshot " << m_generation << ", skipping it.";
+
+		if( false == resetLog())
+			return false;
+	}
+
+	AF_LOG << "Store log loaded in " << ( af::getMonotonicMSec() - time) << " ms: " << m_entries.size() << " files"
+		<< ", snapshot " << ( m_snapshot_size >> 10) << " KB, log " << ( m_log_size >> 10) << " KB.";
+
+	// The first start, import folders store:
+	if( fresh && ( false == import()))
+		return false;
+
+	m_snapshot_time = af::getMonotonicMSec();
+
+	return true;
+}
+
+bool StoreLog::load( int i_fd, bool i_snapshot, int64_t & o_generation, int64_t & o_size)
+{
+	const std::string & filename = i_snapshot ? m_snapshot_file : m_log_file;
+
+	int64_t file_size = fileSize( i_fd);
+	Reader reader( i_fd, file_size);
+
+	const char * header = reader.get( 0, HeaderSize);
+	if(( NULL == header ) || memcmp( header, Magic, 8))
+	{
+		AF_ERR << "Invalid store file header: " << filename;
+		return false;
+	}
+	memcpy( &o_generation, header + 8, 8);
+
+	int64_t offset = HeaderSize;
+	int64_t records = 0;
+	while( offset < file_size )
+	{
+		const char * rec = reader.get( offset, RecordHeaderSize);
+		if( NULL == rec )
+			break;
+
+		uint32_t fields[4];
+		memcpy( fields, rec, RecordHeaderSize);
+		uint32_t type = fields[1];
+		uint32_t path_len = fields[2];
+		uint32_t data_len = fields[3];
+
+		if(( type < RWrite ) || ( type > RRemove ) || ( path_len == 0 ) || ( path_len > PathLengthMax ))
+			break;
+
+		// Header should be copied, as the next get can move reader buffer:
+		char rec_header[RecordHeaderSize];
+		memcpy( rec_header, rec, RecordHeaderSize);
+
+		const char * data = reader.get( offset + RecordHeaderSize, int64_t( path_len) + data_len);
+		if( NULL == data )
+			break;
+
+		std::string path( data, path_len);
+		if( recordChecksum( rec_header, path, data + path_len, data_len) != fields[0] )
+			break;
+
+		Segment segment;
+		segment.snapshot = i_snapshot;
+		segment.offset = offset + RecordHeaderSize + path_len;
+		segment.length = data_len;
+		apply( RecordType( type), path, segment);
+
+		offset += RecordHeaderSize + path_len + data_len;
+		records++;
+	}
+
+	if(( offset < file_size ) && i_snapshot )
+	{
+		AF_ERR << "Store snapshot is broken at " << offset << " of " << file_size << " bytes: " << filename;
+		return false;
+	}
+
+	AF_LOG << "Store " << ( i_snapshot ? "snapshot" : "log") << " generation " << o_generation << ": " << records << " records.";
+
+	o_size = offset;
+	return true;
+}
+
+bool StoreLog::import()
+{
+	std::vector<std::string> folders;
+	folders.push_back( af::Environment::getStoreFolderBranches());
+	folders.push_back( af::Environment::getStoreFolderJobs());
+	folders.push_back( af::Environment::getStoreFolderPools());
+	folders.push_back( af::Environment::getStoreFolderRenders());
+	folders.push_back( af::Environment::getStoreFolderUsers());
+
+	int nodes = 0;
+	int files = 0;
+	for( int f = 0; f < folders.size(); f++)
+	{
+		std::vector<std::string> dirs = AFCommon::getStoredFolders( folders[f]);
+		for( int d = 0; d < dirs.size(); d++)
+		{
+			std::vector<std::string> names = af::getFilesList( dirs[d]);
+			for( int n = 0; n < names.size(); n++)
+			{
+				if( false == isLogFileName( names[n]))
+					continue;
+
+				std::string file = dirs[d] + AFGENERAL::PATH_SEPARATOR + names[n];
+				int size;
+				char * data = af::fileRead( file, &size);
+				if( NULL == data )
+					continue;
+
+				bool written = write( RWrite, relative( file), data, size);
+				delete [] data;
+				if( false == written )
+					return false;
+
+				files++;
+			}
+			nodes++;
+		}
+	}
+
+	if( files == 0 )
+		return true;
+
+	AF_LOG << "Folders store imported to store log: " << nodes << " nodes, " << files << " files.";
+
+	return snapshot();
+}
+
+bool StoreLog::Manages( const std::string & i_file)
+{
+	if( NULL == ms_this )
+		return false;
+
+	const std::string & folder = ms_this->m_folder;
+	if(( i_file.size() <= folder.size()) || ( i_file.compare( 0, folder.size(), folder) != 0 ) ||
+		( i_file[folder.size()] != AFGENERAL::PATH_SEPARATOR ))
+		return false;
+
+	size_t pos = i_file.rfind( AFGENERAL::PATH_SEPARATOR);
+	return isLogFileName( i_file.substr( pos + 1));
+}
+
+const std::string StoreLog::relative( const std::string & i_path) const
+{
+	if(( i_path.size() > m_folder.size()) && ( i_path.compare( 0, m_folder.size(), m_folder) == 0 ))
+		return i_path.substr( m_folder.size() + 1);
+	return i_path;
+}
+
+bool StoreLog::Write( const char * i_data, int i_length, const std::string & i_file, bool i_append)
+{
+	DlScopeLocker lock( &ms_this->m_mutex);
+	return ms_this->write( i_append ? RAppend : RWrite, ms_this->relative( i_file), i_data, i_length);
+}
+
+void StoreLog::Remove( const std::string & i_folder)
+{
+	DlScopeLocker lock( &ms_this->m_mutex);
+
+	std::string path = ms_this->relative( i_folder);
+
+	// Do not log removal of a folder that has no files:
+	std::map<std::string, Entry>::const_iterator it = ms_this->m_entries.lower_bound( path);
+	if(( it == ms_this->m_entries.end()) || ( it->first.compare( 0, path.size(), path) != 0 ))
+		return;
+
+	ms_this->write( RRemove, path, NULL, 0);
+}
+
+bool StoreLog::write( RecordType i_type, const std::string & i_path, const char * i_data, int i_length)
+{
+	if( m_log_fd == -1 )
+		return false;
+
+	std::string record( RecordHeaderSize, '\0');
+	recordHeader( &record[0], i_type, i_path, i_data, i_length);
+	record += i_path;
+	if( i_length )
+		record.append( i_data, i_length);
+
+	if( false == writeAt( m_log_fd, record.data(), record.size(), m_log_size))
+	{
+		AF_ERR << "Store log write failed: " << m_log_file << ": " << strerror( errno);
+		// Not finished record will be truncated on start, next records should be written at the same place.
+		return false;
+	}
+
+	Segment segment;
+	segment.snapshot = false;
+	segment.offset = m_log_size + RecordHeaderSize + i_path.size();
+	segment.length = i_length;
+	apply( i_type, i_path, segment);
+
+	m_log_size += record.size();
+	m_unsynced++;
+
+	m_stat_records++;
+	m_stat_bytes += record.size();
+
+	if( m_unsynced >= SyncRecordsMax )
+		sync();
+
+	return true;
+}
+
+void StoreLog::apply( RecordType i_type, const std::string & i_path, const Segment & i_segment)
+{
+	switch( i_type)
+	{
+	case RWrite:
+	{
+		Entry & entry = m_entries[i_path];
+		entry.segments.clear();
+		entry.segments.push_back( i_segment);
+		entry.size = i_segment.length;
+		break;
+	}
+	case RAppend:
+	{
+		Entry & entry = m_entries[i_path];
+		if( entry.segments.empty())
+			entry.size = 0;
+		if( i_segment.length )
+		{
+			entry.segments.push_back( i_segment);
+			entry.size += i_segment.length;
+		}
+		break;
+	}
+	case RRemove:
+	{
+		// Remove folder files, but not files of other folders with the same name beginning:
+		std::map<std::string, Entry>::iterator it = m_entries.lower_bound( i_path);
+		while(( it != m_entries.end()) && ( it->first.compare( 0, i_path.size(), i_path) == 0 ))
+		{
+			if(( it->first.size() == i_path.size()) || ( it->first[i_path.size()] == AFGENERAL::PATH_SEPARATOR ))
+				m_entries.erase( it++);
+			else
+				it++;
+		}
+		break;
+	}
+	}
+}
+
+char * StoreLog::Read( const std::string & i_file, int * o_size)
+{
+	DlScopeLocker lock( &ms_this->m_mutex);
+
+	std::map<std::string, Entry>::const_iterator it = ms_this->m_entries.find( ms_this->relative( i_file));
+	if( it == ms_this->m_entries.end())
+		return NULL;
+
+	char * data = new char[it->second.size + 1];
+	if( false == ms_this->readEntry( it->second, data))
+	{
+		AF_ERR << "Store log read failed: " << i_file << ": " << strerror( errno);
+		delete [] data;
+		return NULL;
+	}
+
+	data[it->second.size] = '\0';
+	if( o_size )
+		*o_size = it->second.size;
+
+	return data;
+}
+
+bool StoreLog::readEntry( const Entry & i_entry, char * o_buffer)
+{
+	for( int i = 0; i < i_entry.segments.size(); i++)
+	{
+		const Segment & segment = i_entry.segments[i];
+		if( false == readAt( segment.snapshot ? m_snapshot_fd : m_log_fd, o_buffer, segment.length, segment.offset))
+			return false;
+		o_buffer += segment.length;
+	}
+	return true;
+}
+
+bool StoreLog::Exists( const std::string & i_file)
+{
+	DlScopeLocker lock( &ms_this->m_mutex);
+	return ms_this->m_entries.find( ms_this->relative( i_file)) != ms_this->m_entries.end();
+}
+
+const std::vector<std::string> StoreLog::GetFolders( const std::string & i_folder)
+{
+	DlScopeLocker lock( &ms_this->m_mutex);
+
+	std::vector<std::string> o_folders;
+
+	// Nodes are stored as <folder>/<thousands>/<id.name>/data.json
+	std::string prefix = ms_this->relative( i_folder) + AFGENERAL::PATH_SEPARATOR;
+	std::map<std::string, Entry>::const_iterator it = ms_this->m_entries.lower_bound( prefix);
+	for( ; it != ms_this->m_entries.end(); it++)
+	{
+		if( it->first.compare( 0, prefix.size(), prefix) != 0 )
+			break;
+
+		size_t pos = it->first.find( AFGENERAL::PATH_SEPARATOR, prefix.size());
+		if( pos == std::string::npos ) continue;
+		pos = it->first.find( AFGENERAL::PATH_SEPARATOR, pos + 1);
+		if( pos == std::string::npos ) continue;
+
+		if( it->first.compare( pos + 1, std::string::npos, "data.json") != 0 )
+			continue;
+
+		o_folders.push_back( i_folder + AFGENERAL::PATH_SEPARATOR + it->first.substr( prefix.size(), pos - prefix.size()));
+	}
+
+	return o_folders;
+}
+
+void StoreLog::Sync()
+{
+	DlScopeLocker lock( &ms_this->m_mutex);
+
+	ms_this->sync();
+
+	// Compact log to a new snapshot, when it is bigger than snapshot or is too old:
+	if( ms_this->m_log_size < SnapshotLogMin )
+		return;
+
+	if(( ms_this->m_log_size > ms_this->m_snapshot_size ) ||
+		( af::getMonotonicMSec() - ms_this->m_snapshot_time > 1000 * int64_t( af::Environment::getServerStoreLogSnapshotSec())))
+		ms_this->snapshot();
+}
+
+void StoreLog::sync()
+{
+	if( m_unsynced == 0 )
+		return;
+
+	if( false == syncFile( m_log_fd))
+		AF_ERR << "Store log sync failed: " << strerror( errno);
+
+	m_unsynced = 0;
+	m_stat_syncs++;
+}
+
+bool StoreLog::snapshot()
+{
+	int64_t time = af::getMonotonicMSec();
+
+	std::string filetemp = m_snapshot_file + ".tmp";
+#ifdef WINNT
+	int fd = ::open( filetemp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0644);
+#else
+	int fd = ::open( filetemp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+	if( fd == -1 )
+	{
+		AF_ERR << "Can't create store snapshot: " << filetemp << ": " << strerror( errno);
+		return false;
+	}
+
+	int64_t generation = m_generation + 1;
+
+	std::string buffer( HeaderSize, '\0');
+	fileHeader( &buffer[0], generation);
+
+	// New files segments, in entries order:
+	std::vector<Segment> segments;
+	segments.reserve( m_entries.size());
+
+	int64_t offset = 0;
+	std::vector<char> data;
+	bool ok = true;
+	for( std::map<std::string, Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); it++)
+	{
+		data.resize( it->second.size + 1);
+		if( false == readEntry( it->second, &data[0]))
+		{
+			AF_ERR << "Store log read failed: " << it->first << ": " << strerror( errno);
+			ok = false;
+			break;
+		}
+
+		char header[RecordHeaderSize];
+		recordHeader( header, RWrite, it->first, &data[0], it->second.size);
+		buffer.append( header, RecordHeaderSize);
+		buffer += it->first;
+
+		Segment segment;
+		segment.snapshot = true;
+		segment.offset = offset + buffer.size();
+		segment.length = it->second.size;
+		segments.push_back( segment);
+
+		buffer.append( &data[0], it->second.size);
+
+		if( buffer.size() >= BufferSize )
+		{
+			if( false == writeAt( fd, buffer.data(), buffer.size(), offset))
+			{
+				ok = false;
+				break;
+			}
+			offset += buffer.size();
+			buffer.clear();
+		}
+	}
+
+	if( ok && buffer.size())
+	{
+		ok = writeAt( fd, buffer.data(), buffer.size(), offset);
+		offset += buffer.size();
+	}
+
+	if( ok )
+		ok = syncFile( fd);
+
+	if( ok )
+	{
+#ifdef WINNT
+		if( af::pathFileExists( m_snapshot_file)) remove( m_snapshot_file.c_str());
+#endif
+		ok = ( rename( filetemp.c_str(), m_snapshot_file.c_str()) == 0 );
+	}
+
+	if( false == ok )
+	{
+		AF_ERR << "Store snapshot write failed: " << filetemp << ": " << strerror( errno);
+		::close( fd);
+		remove( filetemp.c_str());
+		return false;
+	}
+
+#ifndef WINNT
+	// Sync folder to keep the renamed file:
+	int dir_fd = ::open( m_folder.c_str(), O_RDONLY);
+	if( dir_fd != -1 )
+	{
+		fsync( dir_fd);
+		::close( dir_fd);
+	}
+#endif
+
+	if( m_snapshot_fd != -1 )
+		::close( m_snapshot_fd);
+	m_snapshot_fd = fd;
+	m_generation = generation;
+
+	int i = 0;
+	for( std::map<std::string, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); it++, i++)
+	{
+		it->second.segments.clear();
+		it->second.segments.push_back( segments[i]);
+	}
+
+	int64_t log_size = m_log_size;
+	resetLog();
+
+	m_snapshot_size = offset;
+	m_snapshot_time = af::getMonotonicMSec();
+
+	m_stat_snapshots++;
+	m_stat_snapshot_ms += m_snapshot_time - time;
+
+	AF_LOG << "Store snapshot generation " << m_generation << " written in " << ( m_snapshot_time - time) << " ms: "
+		<< m_entries.size() << " files, " << ( m_snapshot_size >> 10) << " KB, log was " << ( log_size >> 10) << " KB.";
+
+	return true;
+}
+
+bool StoreLog::resetLog()
+{
+	char header[HeaderSize];
+	fileHeader( header, m_generation);
+
+	if(( false == truncateFile( m_log_fd, 0)) ||
+		( false == writeAt( m_log_fd, header, HeaderSize, 0)) ||
+		( false == syncFile( m_log_fd)))
+	{
+		AF_ERR << "Store log reset failed: " << m_log_file << ": " << strerror( errno);
+		return false;
+	}
+
+	m_log_size = HeaderSize;
+	m_unsynced = 0;
+
+	return true;
+}
+
+void StoreLog::WriteStat( std::ostringstream & o_str)
+{
+	if( NULL == ms_this )
+		return;
+
+	DlScopeLocker lock( &ms_this->m_mutex);
+
+	o_str << "\nStore log: records " << ms_this->m_stat_records << " (" << ( ms_this->m_stat_bytes >> 10) << " KB)";
+	o_str << ", syncs " << ms_this->m_stat_syncs;
+	o_str << ", snapshots " << ms_this->m_stat_snapshots;
+	if( ms_this->m_stat_snapshots )
+		o_str << " (" << ( ms_this->m_stat_snapshot_ms / ms_this->m_stat_snapshots) << " ms)";
+	o_str << ", files " << ms_this->m_entries.size();
+	o_str << ", log " << ( ms_this->m_log_size >> 10) << " KB";
+	o_str << ", snapshot " << ( ms_this->m_snapshot_size >> 10) << " KB";
+
+	ms_this->m_stat_records    = 0;
+	ms_this->m_stat_bytes      = 0;
+	ms_this->m_stat_syncs      = 0;
+	ms_this->m_stat_snapshots  = 0;
+	ms_this->m_stat_snapshot_ms = 0;
+}
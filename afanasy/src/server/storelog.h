@@ -0,0 +1,133 @@
+/* ''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''''' *\
+ *        .NN.        _____ _____ _____  _    _                 This file is part of CGRU
+ *        hMMh       / ____/ ____|  __ \| |  | |       - The Free And Open Source CG Tools Pack.
+ *       sMMMMs     | |   | |  __| |__) | |  | |  CGRU is licensed under the terms of LGPLv3, see files
+ * <yMMMMMMMMMMMMMMy> |   | | |_ |  _  /| |  | |    COPYING and COPYING.lesser inside of this folder.
+ *   `+mMMMMMMMMNo` | |___| |__| | | \ \| |__| |          Project-Homepage: http://cgru.info
+ *     :MMMMMMMM:    \_____\_____|_|  \_\\____/        Sourcecode: https://github.com/CGRU/cgru
+ *     dMMMdmMMMd     A   F   A   N   A   S   Y
+ *    -Mmo.  -omM:                                           Copyright © by The CGRU team
+ *    '          '
+\* ....................................................................................................... */
+
+/*
+	Store log.
+	Nodes store files (node data, job blocks tasks and tasks progress journal)
+	can be kept in a single snapshot file and an append-only write-ahead log,
+	instead of a folder with files per node.
+	Each file write, append or node folder removal is a log record.
+	Records are written by files queue thread and are synced in batches.
+	Snapshot keeps only actual files data, it is rewritten when log becomes big or old,
+	so server start reads a bounded data size with a few system calls.
+	Tasks output and files are big and rarely read, they are still stored in folders.
+*/
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <stdint.h>
+#include <vector>
+
+#include "../libafanasy/common/dlMutex.h"
+
+class StoreLog
+{
+public:
+	/// Open (or create) store log in the store folder, import folders store on the first start.
+	static bool Open( const std::string & i_folder);
+
+	/// Sync and close log.
+	static void Close();
+
+	inline static bool Enabled() { return ms_this != NULL; }
+
+	/// Whether a file is kept in the store log, other files are written in folders.
+	static bool Manages( const std::string & i_file);
+
+	/// Write or append a file data.
+	static bool Write( const char * i_data, int i_length, const std::string & i_file, bool i_append = false);
+
+	/// Remove all files of a node store folder.
+	static void Remove( const std::string & i_folder);
+
+	/// Read a file data, returns NULL if there is no such file.
+	/// Returned buffer is null terminated like af::fileRead one.
+	static char * Read( const std::string & i_file, int * o_size);
+
+	static bool Exists( const std::string & i_file);
+
+	/// Get nodes store folders like AFCommon::getStoredFolders does.
+	static const std::vector<std::string> GetFolders( const std::string & i_folder);
+
+	/// Sync written records and make a new snapshot if log is too big or old.
+	/// Files queue calls it when it becomes empty.
+	static void Sync();
+
+	/// Write statistics since the previous call.
+	static void WriteStat( std::ostringstream & o_str);
+
+private:
+	StoreLog( const std::string & i_folder);
+	~StoreLog();
+
+	/// File data part location in the snapshot or in the log.
+	struct Segment
+	{
+		bool    snapshot;
+		int64_t offset;
+		int     length;
+	};
+
+	struct Entry
+	{
+		std::vector<Segment> segments;
+		int size;
+	};
+
+	enum RecordType
+	{
+		RWrite  = 1,
+		RAppend = 2,
+		RRemove = 3
+	};
+
+	bool open();
+	bool load( int i_fd, bool i_snapshot, int64_t & o_generation, int64_t & o_size);
+	bool import();
+
+	bool write( RecordType i_type, const std::string & i_path, const char * i_data, int i_length);
+	void apply( RecordType i_type, const std::string & i_path, const Segment & i_segment);
+	bool readEntry( const Entry & i_entry, char * o_buffer);
+
+	void sync();
+	bool snapshot();
+	bool resetLog();
+
+	const std::string relative( const std::string & i_path) const;
+
+private:
+	static StoreLog * ms_this;
+
+	std::string m_folder;
+	std::string m_snapshot_file;
+	std::string m_log_file;
+
+	DlMutex m_mutex;
+
+	std::map<std::string, Entry> m_entries;
+
+	int m_snapshot_fd;
+	int m_log_fd;
+
+	int64_t m_generation;
+	int64_t m_snapshot_size;
+	int64_t m_snapshot_time;
+	int64_t m_log_size;
+	int m_unsynced;
+
+	int64_t m_stat_records;
+	int64_t m_stat_bytes;
+	int64_t m_stat_syncs;
+	int64_t m_stat_snapshots;
+	int64_t m_stat_snapshot_ms;
+};
@@ -65,12 +65,13 @@ SysCmd::SysCmd(
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 SysTask::SysTask( af::TaskExec * i_taskexec, SysCmd * i_system_command, Block * i_block, int i_task_number):
-	Task( i_block, &m_taskProgress, i_task_number),
+	Task( i_block, af::TaskProgressView( &m_taskProgress, 0), i_task_number),
 	m_syscmd( i_system_command),
+	m_taskProgress( 1),
 	m_birthtime(0)
 {
 AFINFO("SysTask::SysTask:");
-	m_progress = &m_taskProgress;
+	m_progress = af::TaskProgressView( &m_taskProgress, 0);
 }
 
 SysTask::~SysTask()
@@ -428,6 +429,8 @@ bool SysBlock::v_refresh( time_t currentTime, RenderContainer * renders, Monitor
 
 
 	// For block in jobs list monitoring
+	// (system job task progress is changed here, not in task refresh)
+	setRefreshAll();
 	if( Block::v_refresh( currentTime, renders, monitoring))
 	{
 		// If block progress changed there, the function will add block in monitoring itself
@@ -51,7 +51,7 @@ private:
 
 private:
 	SysCmd * m_syscmd;
-	af::TaskProgress m_taskProgress;
+	af::TaskProgressColumns m_taskProgress;
 	long long m_birthtime;
 };
 
@@ -89,7 +89,7 @@ private:
 	int deleteFinishedTasks( bool & taskProgressChanged);
 
 private:
-	af::TaskProgress * m_taskprogress;
+	af::TaskProgressView m_taskprogress;
 
 private:
 	std::list<SysCmd*> m_commands;
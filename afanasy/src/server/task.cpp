@@ -22,12 +22,15 @@
 #include "../include/macrooutput.h"
 #include "../libafanasy/logger.h"
 
-Task::Task( Block * taskBlock, af::TaskProgress * taskProgress, int taskNumber):
+Task::Task( Block * taskBlock, af::TaskProgressView taskProgress, int taskNumber):
    m_block( taskBlock),
    m_number( taskNumber),
    m_progress( taskProgress),
    m_run( NULL),
-	m_listen_count( 0)
+	m_listen_count( 0),
+	m_solve_epoch( 0),
+	m_refresh( false),
+	m_progress_store( false)
 {
 	// If job is not from store, it is just came from network
 	// and so no we do not need to read anything
@@ -52,7 +55,8 @@ Task::Task( Block * taskBlock, af::TaskProgress * taskProgress, int taskNumber):
 		}
 	}
 
-	// Read task progress
+	// Read task progress from an old store,
+	// now tasks progress is stored in a job journal, that is read after tasks construction.
 	if( false == af::pathFileExists( m_store_file_progress)) return;
 
 	int size;
@@ -98,6 +102,9 @@ af::TaskExec * Task::genExec() const
 
 void Task::v_start( af::TaskExec * i_taskexec, RenderAf * i_render, MonitorContainer * i_monitoring)
 {
+   // Running task should be refreshed:
+   m_block->addRefreshTask( m_number);
+
    if( m_block->m_data->isMultiHost())
    {
       if( m_run )
@@ -207,6 +214,7 @@ void Task::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCont
 		{
 			v_appendLog("Reconnect timeout reached. Setting state to READY.");
 			m_progress->state = AFJOB::STATE_READY_MASK;
+			m_block->m_data->setTaskReady( m_number);
             if (false == changed) changed = true;
 		}
 	}
@@ -246,6 +254,7 @@ void Task::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCont
             m_progress->state = m_progress->state |   AFJOB::STATE_READY_MASK;
             m_progress->state = m_progress->state |   AFJOB::STATE_ERROR_READY_MASK;
             m_progress->state = m_progress->state & (~AFJOB::STATE_ERROR_MASK);
+            m_block->m_data->setTaskReady( m_number);
             v_appendLog( std::string("Automatically retrying error task") + af::itos( m_progress->errors_count) + " of " + af::itos( m_block->getErrorsRetries()) + ".");
             if( changed == false) changed = true;
          }
@@ -263,6 +272,26 @@ void Task::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCont
    deleteRunningZombie();
 }
 
+bool Task::isRefreshNeeded() const
+{
+	if( m_run )
+		return true;
+
+	// Reconnect timeout should be checked:
+	if( m_progress->state & AFJOB::STATE_WAITRECONNECT_MASK )
+		return true;
+
+	// Error task will be retried (it is not changed any more if retries are over):
+	if(( m_progress->state & AFJOB::STATE_ERROR_MASK ) && ( m_progress->errors_count <= m_block->getErrorsRetries()))
+		return true;
+
+	// Error hosts should be forgiven:
+	if( m_errorHosts.size() && ( m_block->getErrorsForgiveTime() > 0 ))
+		return true;
+
+	return false;
+}
+
 void Task::restart( const std::string & i_message, RenderContainer * i_renders, MonitorContainer * i_monitoring, uint32_t i_state)
 {
 	if( i_state != 0 )
@@ -283,6 +312,7 @@ void Task::restart( const std::string & i_message, RenderContainer * i_renders,
 	}
 
 	m_progress->state = AFJOB::STATE_READY_MASK;
+	m_block->m_data->setTaskReady( m_number);
 	m_progress->errors_count = 0;
 	v_store();
 	v_monitor( i_monitoring);
@@ -407,10 +437,21 @@ void Task::v_store()
 	if( m_store_dir.empty())
 		initStoreFolders();
 
-	std::ostringstream str;
-	m_progress->jsonWrite( str);
-	AFCommon::QueueFileWrite( new FileData( str, m_store_file_progress,
-		m_store_dir));
+	// Task can be changed several times during a run cycle:
+	if( m_progress_store )
+		return;
+
+	m_progress_store = true;
+	m_block->m_job->storeTaskProgress( this);
+}
+
+void Task::writeProgressRecord( std::ostringstream & o_str)
+{
+	o_str << "{\"b\":" << m_block->m_data->getBlockNum() << ",\"t\":" << m_number << ",\"p\":";
+	m_progress->jsonWrite( o_str);
+	o_str << "}\n";
+
+	m_progress_store = false;
 }
 
 void Task::v_appendLog( const std::string & message)
@@ -16,7 +16,7 @@ class RenderContainer;
 class Task
 {
 public:
-	Task( Block * taskBlock, af::TaskProgress * taskProgress, int taskNumber);
+	Task( Block * taskBlock, af::TaskProgressView taskProgress, int taskNumber);
 	virtual ~Task();
 
 public:
@@ -37,6 +37,10 @@ public:
 
 	virtual void v_refresh( time_t currentTime, RenderContainer * renders, MonitorContainer * monitoring, int & errorHostId);
 
+	/// Whether the task is running or has something to check on refresh (errors retry and forgive, reconnect).
+	/// Job action refreshes all tasks, so parameters changes are checked.
+	bool isRefreshNeeded() const;
+
 	void restart( const std::string & i_message, RenderContainer * i_renders, MonitorContainer * i_monitoring, uint32_t i_state = 0);
 
 	void skip(const std::string & i_message, RenderContainer * i_renders, MonitorContainer * i_monitoring, uint32_t i_state);
@@ -62,8 +66,12 @@ public:
 	virtual void v_monitor( MonitorContainer * monitoring) const;
 
 	// Store function should be empty in system job tasks
+	/// Task progress is not written at once, it is queued to job tasks progress journal.
 	virtual void v_store();
 
+	/// Write task progress journal record, called by job on journal write.
+	void writeProgressRecord( std::ostringstream & o_str);
+
 	virtual const std::string v_getInfo( bool full = false) const;
 
 	const std::string getOutputFileName( int i_starts_count) const;
@@ -88,13 +96,17 @@ public:
 	inline Block * getBlock() {return m_block;}
 
 public:
-	bool m_solved;
+	int64_t m_solve_epoch; ///< Job solving attempt, task was tried on.
+
+	bool m_refresh; ///< Task is stored in block tasks to refresh.
+
+	bool m_progress_store; ///< Task progress is queued to store in job journal.
 
 	std::vector<Task*> m_depend_on;
 	std::vector<Task*> m_dependent;
 
 protected:
-	af::TaskProgress * m_progress;
+	af::TaskProgressView m_progress;
 	std::list<std::string> m_logStringList;    ///< Task log.
 	Block * m_block;
 
@@ -109,7 +121,7 @@ private:
 	std::string m_store_dir;
 	std::string m_store_dir_output;
 	std::string m_store_dir_files;
-	std::string m_store_file_progress;
+	std::string m_store_file_progress; ///< Old stores progress file, it is only read now.
 
 	std::vector<std::string> m_stored_files;
 	std::vector<std::string> m_parsed_files;
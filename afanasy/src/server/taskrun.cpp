@@ -23,7 +23,7 @@ std::string TaskRun::ms_no_name = "no_exec_name";
   
 TaskRun::TaskRun( Task * runningTask,
                   af::TaskExec* taskExec,
-                  af::TaskProgress * taskProgress,
+                  af::TaskProgressView taskProgress,
                   Block * taskBlock,
                   RenderAf * render,
                   MonitorContainer * monitoring
@@ -79,6 +79,7 @@ AFINFA("TaskRun:: ~ TaskRun: %s[%d][%d]:", m_block->m_job->getName().c_str(), m_
    if( m_progress->state & AFJOB::STATE_SKIPPED_MASK ) return;
 
    m_progress->state = AFJOB::STATE_READY_MASK;
+   m_block->m_data->setTaskReady( m_tasknum);
 }
 
 void TaskRun::update(const af::MCTaskUp& taskup, RenderContainer * renders, MonitorContainer * monitoring, bool & o_error_host)
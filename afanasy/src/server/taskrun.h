@@ -23,7 +23,7 @@ public:
 **/
    TaskRun( Task * runningTask,
             af::TaskExec * taskExec,
-            af::TaskProgress * taskProgress,
+            af::TaskProgressView taskProgress,
             Block * taskBlock,
             RenderAf * render,
             MonitorContainer * monitoring
@@ -71,7 +71,7 @@ protected:
    Task * m_task;
    Block * m_block;
    af::TaskExec * m_exec;
-   af::TaskProgress * m_progress;
+   af::TaskProgressView m_progress;
    int m_tasknum;
    int m_hostId;       ///< Task Host Id
 	int64_t * m_running_capacity_counter;
@@ -15,7 +15,7 @@ public:
 	TaskRunMulti(
 		Task * i_runningTask,
 		af::TaskExec * i_taskExec,
-		af::TaskProgress * i_taskProgress,
+		af::TaskProgressView i_taskProgress,
 		Block * i_taskBlock,
 		RenderAf * i_render,
 		MonitorContainer * i_monitoring
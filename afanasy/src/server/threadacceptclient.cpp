@@ -188,6 +188,9 @@ void threadAcceptPort(void * i_arg, int i_port)
 
 	while( AFRunning )
 	{
+		// Do not accept more clients, while too many requests are waiting for processing:
+		threadArgs->socketsProcessing->waitQueue();
+
 		struct sockaddr_storage * sas = new sockaddr_storage;
 		socklen_t client_sockaddr_len = sizeof(*sas);
 		int sfd = accept( server_sd, (struct sockaddr*)(sas), &client_sockaddr_len);
@@ -24,6 +24,7 @@
 #include "threadargs.h"
 #include "usercontainer.h"
 
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgclasses/mctask.h"
 #include "../libafanasy/rapidjson/stringbuffer.h"
 #include "../libafanasy/rapidjson/prettywriter.h"
@@ -69,6 +70,10 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 		std::string mask;
 		af::jr_string("mask", mask, getObj);
 
+		// Client can provide a list version it already has, to get "not modified" response:
+		int64_t version = 0;
+		af::jr_int64("version", version, getObj);
+
 		if( type == "jobs" )
 		{
 			if( getObj.HasMember("uids"))
@@ -192,89 +197,106 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 			}
 			else
 			{
-				AfContainerLock lock( i_args->jobs, AfContainerLock::READLOCK);
-				JobAf * job = NULL;
-				if( ids.size() == 1 )
-				{
-					JobContainerIt it( i_args->jobs);
-					job = it.getJob(ids[0], i_msg);
-					if( job == NULL )
-						o_msg_response = af::jsonMsgError( "Invalid ID");
-				}
+				// Whole jobs list can be served from a snapshot without container locking:
+				if(( o_msg_response == NULL ) && ids.empty() && mask.empty() && mode.empty() && ( false == full ) &&
+					( false == getObj.HasMember("serials")))
+					o_msg_response = i_args->jobs->generateSnapshot( json, version);
 
-				if( job )
+				if( o_msg_response == NULL )
 				{
-					std::vector<int32_t> block_ids;
-					af::jr_int32vec("block_ids", block_ids, getObj);
-					if( block_ids.size() && ( block_ids[0] != -1 ))
+					AfContainerLock lock( i_args->jobs, AfContainerLock::READLOCK);
+					JobAf * job = NULL;
+					if( ids.size() == 1 )
 					{
-						std::vector<int32_t> task_ids;
-						af::jr_int32vec("task_ids", task_ids, getObj);
-						if( task_ids.size() && ( task_ids[0] != -1))
-							o_msg_response = job->writeTask( block_ids[0], task_ids[0], mode, binary);
-						else
-						{
-							std::vector<std::string> modes;
-							af::jr_stringvec("mode", modes, getObj);
-							o_msg_response = job->writeBlocks( block_ids, modes, binary);
-						}
+						JobContainerIt it( i_args->jobs);
+						job = it.getJob(ids[0], i_msg);
+						if( job == NULL )
+							o_msg_response = af::jsonMsgError( "Invalid ID");
 					}
-					else if( mode.size())
+
+					if( job )
 					{
-						if( mode == "thumbnail" )
-							o_msg_response = job->writeThumbnail( binary);
-						else if( mode == "progress" )
-							o_msg_response = job->writeProgress( json);
-						else if( mode == "error_hosts" )
-							o_msg_response = job->writeErrorHosts( binary);
-						else if( mode == "log" )
-							o_msg_response = job->writeLog( binary);
+						std::vector<int32_t> block_ids;
+						af::jr_int32vec("block_ids", block_ids, getObj);
+						if( block_ids.size() && ( block_ids[0] != -1 ))
+						{
+							std::vector<int32_t> task_ids;
+							af::jr_int32vec("task_ids", task_ids, getObj);
+							if( task_ids.size() && ( task_ids[0] != -1))
+								o_msg_response = job->writeTask( block_ids[0], task_ids[0], mode, binary);
+							else
+							{
+								std::vector<std::string> modes;
+								af::jr_stringvec("mode", modes, getObj);
+								o_msg_response = job->writeBlocks( block_ids, modes, binary);
+							}
+						}
+						else if( mode.size())
+						{
+							if( mode == "thumbnail" )
+								o_msg_response = job->writeThumbnail( binary);
+							else if( mode == "progress" )
+								o_msg_response = job->writeProgress( json);
+							else if( mode == "progress_compact" )
+								o_msg_response = job->writeProgress( json, true);
+							else if( mode == "error_hosts" )
+								o_msg_response = job->writeErrorHosts( binary);
+							else if( mode == "log" )
+								o_msg_response = job->writeLog( binary);
+						}
 					}
-				}
 
-				if( o_msg_response == NULL )
-				{
-					std::vector<int64_t> serials;
-					if( af::jr_int64vec("serials", serials, getObj))
+					if( o_msg_response == NULL )
 					{
-						ids = i_args->jobs->getIdsBySerials( serials);
-					}
+						std::vector<int64_t> serials;
+						if( af::jr_int64vec("serials", serials, getObj))
+						{
+							ids = i_args->jobs->getIdsBySerials( serials);
+						}
 
-					o_msg_response = i_args->jobs->generateList(
-						full ? af::Msg::TJob : af::Msg::TJobsList, type, ids, mask, json);
+						o_msg_response = i_args->jobs->generateList(
+							full ? af::Msg::TJob : af::Msg::TJobsList, type, ids, mask, json);
+					}
 				}
 			}
 		}
 		else if( type == "renders")
 		{
-			AfContainerLock lock( i_args->renders, AfContainerLock::READLOCK);
-			if( mode.size())
+			// Whole renders list can be served from a snapshot without container locking:
+			if( mode.empty() && ids.empty() && mask.empty())
+				o_msg_response = i_args->renders->generateSnapshot( json, version);
+
+			if( o_msg_response == NULL )
 			{
-				RenderAf * render = NULL;
-				if( ids.size() == 1 )
+				AfContainerLock lock( i_args->renders, AfContainerLock::READLOCK);
+				if( mode.size())
 				{
-					RenderContainerIt it( i_args->renders);
-					render = it.getRender(ids[0], i_msg);
-					if( render == NULL )
-						o_msg_response = af::jsonMsgError( "Invalid ID");
+					RenderAf * render = NULL;
+					if( ids.size() == 1 )
+					{
+						RenderContainerIt it( i_args->renders);
+						render = it.getRender(ids[0], i_msg);
+						if( render == NULL )
+							o_msg_response = af::jsonMsgError( "Invalid ID");
+					}
+					if( render )
+					{
+						if( full )
+							o_msg_response = render->writeFullInfo( binary);
+						else if( mode == "log" )
+							o_msg_response = render->writeLog( binary);
+						else if( mode == "tasks_log" )
+							o_msg_response = render->writeTasksLog( binary);
+					}
 				}
-				if( render )
+				if( o_msg_response == NULL )
 				{
-					if( full )
-						o_msg_response = render->writeFullInfo( binary);
-					else if( mode == "log" )
-						o_msg_response = render->writeLog( binary);
-					else if( mode == "tasks_log" )
-						o_msg_response = render->writeTasksLog( binary);
+					if( mode == "resources" )
+						o_msg_response = i_args->renders->generateList( af::Msg::TRendersResources, type, ids, mask, json);
+					else
+						o_msg_response = i_args->renders->generateList( af::Msg::TRendersList, type, ids, mask, json);
 				}
 			}
-			if( o_msg_response == NULL )
-			{
-				if( mode == "resources" )
-					o_msg_response = i_args->renders->generateList( af::Msg::TRendersResources, type, ids, mask, json);
-				else
-					o_msg_response = i_args->renders->generateList( af::Msg::TRendersList, type, ids, mask, json);
-			}
 		}
 		else if( type == "users")
 		{
@@ -361,7 +383,18 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 				}
 				if( monitor )
 				{
-					if( mode == "events")
+					// Web monitor can ask to wait for events,
+					// sockets processing holds such request until run cycle dispatches some events.
+					bool wait = false;
+					af::jr_bool("wait", wait, getObj);
+
+					if(( mode == "events") && wait && ( af::Environment::getMonitorEventsWaitSec() > 0 ) &&
+						( false == monitor->hasEvents()))
+					{
+						monitor->updateTime();
+						o_msg_response = new af::Msg( af::Msg::TMonitorEventsWait, monitor->getId());
+					}
+					else if( mode == "events")
 						o_msg_response = monitor->getEventsJSON();
 					else if( mode == "log")
 						o_msg_response = monitor->writeLog( binary);
@@ -387,6 +420,12 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 			files << "]}";
 			o_msg_response = af::jsonMsg( files);
 		}
+		else if( type == "database" )
+		{
+			std::ostringstream str;
+			AFCommon::DBJsonWrite( str);
+			o_msg_response = af::jsonMsg( str);
+		}
 		else if( type == "config" )
 		{
 			o_msg_response = af::jsonMsg( af::Environment::getConfigData());
@@ -503,7 +542,7 @@ af::Msg * jsonSaveObject( rapidjson::Document & i_obj)
 	jObj.Accept(writer);
 	std::string text( buffer.GetString());
 
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{\"save\":\n";
 	str << "\t\"path\":\"" << path << "\",\n";
 	if( af::pathFileExists( path)) str << "\t\"overwrite\":true,\n";
@@ -19,7 +19,10 @@
 #include "monitoraf.h"
 #include "monitorcontainer.h"
 #include "poolscontainer.h"
+#include "renderconnections.h"
 #include "rendercontainer.h"
+#include "runcyclewaker.h"
+#include "socketsprocessing.h"
 #include "threadargs.h"
 #include "usercontainer.h"
 
@@ -104,6 +107,17 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 	case af::Msg::TRenderRegister:
 	{
 //printf("case af::Msg::TRenderRegister:\n");
+		// Registration locks many containers, on a renders storm
+		// (after server restart or network outage) renders are asked to retry later:
+		int retry_sec = 0;
+		if( false == i_args->socketsProcessing->allowRenderRegister( &retry_sec))
+		{
+			af::RenderEvents re( af::RenderEvents::RE_Status_Retry, "Server is busy registering other renders.");
+			re.m_heartbeat_sec = retry_sec;
+			o_msg_response = new af::Msg(af::Msg::TRenderEvents, &re);
+			break;
+		}
+
 		AfContainerLock jLock(i_args->jobs,     AfContainerLock::WRITELOCK);
 		AfContainerLock mLock(i_args->monitors, AfContainerLock::WRITELOCK);
 		AfContainerLock pLock(i_args->pools,    AfContainerLock::WRITELOCK);
@@ -119,12 +133,18 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 		af::RenderUpdate * rup = new af::RenderUpdate( i_msg);
 		bool render_found = false;
 
+		int64_t wait_us = af::getMonotonicUSec();
+
 		{
-			AfContainerLock rlock( i_args->renders, AfContainerLock::WRITELOCK);
+			// Render update does not change container, it locks render update mutex itself.
+			// So updates of different renders are processed in parallel.
+			AfContainerLock rlock( i_args->renders, AfContainerLock::READLOCK);
 
 			RenderContainerIt rendersIt( i_args->renders);
 			RenderAf * render = rendersIt.getRender(rup->getId(), i_msg);
 
+			wait_us = af::getMonotonicUSec() - wait_us;
+
 			if( NULL == render)
 			{
 				// If there is not such online render, a zero id will be send.
@@ -150,6 +170,12 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 			}
 		}
 
+		// Render update time, resources and tasks percents are changed without an event:
+		if( render_found)
+			i_args->renders->setSnapshotDirty();
+
+		i_args->renders->updateStat( i_msg->writeSize(), *rup, wait_us);
+
 		if( render_found)
 		{
 			// Task outputs received:
@@ -164,6 +190,7 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 			if( rup->m_taskups.size())
 			{
 				i_args->rupQueue->pushUp( rup);
+				RunCycleWaker::Wake();
 				return o_msg_response;
 			}
 		}
@@ -172,6 +199,25 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 
 		break;
 	}
+	case af::Msg::TRenderConnect:
+	{
+		// Render asks to keep this connection to receive pushed events.
+		// Zero id answer means that render should continue to connect on each update.
+		int id = 0;
+
+		if( RenderConnections::Enabled())
+		{
+			AfContainerLock rlock( i_args->renders, AfContainerLock::READLOCK);
+
+			RenderContainerIt rendersIt( i_args->renders);
+			RenderAf * render = rendersIt.getRender( i_msg->int32());
+			if( render && render->isOnline())
+				id = render->getId();
+		}
+
+		o_msg_response = new af::Msg( af::Msg::TRenderId, id);
+		break;
+	}
 	case af::Msg::TRendersResourcesRequestIds:
 	{
 	  AfContainerLock lock( i_args->renders, AfContainerLock::READLOCK);
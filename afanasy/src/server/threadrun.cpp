@@ -17,6 +17,7 @@
 #include <stdlib.h>
 
 #include "../libafanasy/environment.h"
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgqueue.h"
 
 #include "afcommon.h"
@@ -26,8 +27,10 @@
 #include "monitorcontainer.h"
 #include "poolscontainer.h"
 #include "rendercontainer.h"
+#include "runcyclewaker.h"
 #include "socketsprocessing.h"
 #include "solver.h"
+#include "storelog.h"
 #include "threadargs.h"
 #include "usercontainer.h"
 
@@ -42,6 +45,42 @@ extern bool AFRunning;
 // Messages reaction case function
 void threadRunCycleCase( ThreadArgs * i_args, af::Msg * i_msg);
 
+/// Log containers locks wait and hold time, render updates traffic,
+/// waiting monitors events requests, sockets admission and IO, messages buffers,
+/// files writing, store log and statistics database every profiling period.
+static void profileLocks( ThreadArgs * a)
+{
+	static int64_t stat_time = 0;
+
+	int64_t now = af::getMonotonicMSec();
+	if( stat_time == 0 )
+		stat_time = now;
+
+	int64_t msec = now - stat_time;
+	if( msec < 1000 * int64_t( af::Environment::getServerProfilingSec()))
+		return;
+
+	std::ostringstream log;
+	log << "Containers locks in last " << (msec / 1000) << " seconds:";
+	a->branches->writeLockStat( log);
+	a->jobs    ->writeLockStat( log);
+	a->monitors->writeLockStat( log);
+	a->pools   ->writeLockStat( log);
+	a->renders ->writeLockStat( log);
+	a->users   ->writeLockStat( log);
+	a->renders ->writeUpdateStat( log);
+	a->socketsProcessing->writeWaitingEventsStat( log);
+	a->socketsProcessing->writeAdmissionStat( log);
+	a->socketsProcessing->writeIOStat( log);
+	af::MsgBufferPool::WriteStat( log);
+	AFCommon::writeFilesStat( log);
+	StoreLog::WriteStat( log);
+	AFCommon::DBWriteStat( log);
+	AFCommon::QueueLog( log.str());
+
+	stat_time = now;
+}
+
 /** This is a main run cycle thread entry point
 **/
 void threadRunCycle( void * i_args)
@@ -78,6 +117,11 @@ void threadRunCycle( void * i_args)
 		We should alaways lock containers in alphabetical order.
 		Thread mutex lock can happer it one thread tries to lock A than B,
 		and other thread tries to lock B at first, than A.
+
+		Containers are locked by phases: messages reaction and refresh,
+		solving, monitors dispatch and zombies deletion.
+		Locks are released between phases, so other threads requests
+		should not wait for the whole cycle.
 	*/
 	AFINFO("ThreadRun::run: Locking containers...")
 	AfContainerLock bLock( a->branches, AfContainerLock::WRITELOCK);
@@ -95,10 +139,7 @@ void threadRunCycle( void * i_args)
 	/*
 		Process all messages in our message queue. We do it without
 		waiting so that the job solving below can run just after.
-		NOTE: I think this should be a waiting operation in a different
-		thread. The job solving below should be put asleep using a
-		semaphore and woke up when something changes. We need to avoid
-		the Sleep() function below.
+		New messages can wake run thread up (see RunCycleWaker).
 	*/
 
 	//
@@ -129,10 +170,21 @@ void threadRunCycle( void * i_args)
 	a->renders  ->refresh( a->jobs,     a->monitors);
 	a->users    ->refresh( NULL,        a->monitors);
 
+	}// - lock containers: messages and refresh
 
+	{
 	//
 	// Jobs sloving.
+	// Solving changes all nodes: jobs, renders, users, branches and pools counters.
 	//
+	AFINFO("ThreadRun::run: Locking containers for solving...")
+	AfContainerLock bLock( a->branches, AfContainerLock::WRITELOCK);
+	AfContainerLock jLock( a->jobs,     AfContainerLock::WRITELOCK);
+	AfContainerLock mlock( a->monitors, AfContainerLock::WRITELOCK);
+	AfContainerLock pLock( a->pools,    AfContainerLock::WRITELOCK);
+	AfContainerLock rLock( a->renders,  AfContainerLock::WRITELOCK);
+	AfContainerLock ulock( a->users,    AfContainerLock::WRITELOCK);
+
 	// Perform pre solving calculations.
 	a->branches->preSolve(a->monitors);
 	a->jobs    ->preSolve(a->monitors);
@@ -143,26 +195,80 @@ void threadRunCycle( void * i_args)
 	//
 	// Perform post solving calculations.
 	// Some data for guis needed to be refreshed after solving (after new tasks started).
+	// Jobs write tasks progress changed during the cycle.
 	a->branches->postSolve(a->monitors);
+	a->jobs    ->postSolve(a->monitors);
 	a->renders ->postSolve(a->monitors);
 
+	}// - lock containers: solving
+
+	{
 	//
 	// Dispatch events to monitors:
+	// Jobs and users are only read here (blocks data and users jobs order).
 	//
 	AFINFO("ThreadRun::run: dispatching monitor events:")
+	AfContainerLock jLock( a->jobs,     AfContainerLock::READLOCK);
+	AfContainerLock mlock( a->monitors, AfContainerLock::WRITELOCK);
+	AfContainerLock rLock( a->renders,  AfContainerLock::WRITELOCK);
+	AfContainerLock ulock( a->users,    AfContainerLock::READLOCK);
+
+	// Events are cleared on dispatch, lists snapshots are prepared only on changes:
+	if( a->monitors->jobsChanged())    a->jobs   ->setSnapshotDirty();
+	if( a->monitors->rendersChanged()) a->renders->setSnapshotDirty();
+
 	a->monitors->dispatch( a->renders);
 
+	// Answer monitors events requests waiting for dispatched events:
+	a->socketsProcessing->processWaitingEvents();
+
+	}// - lock containers: dispatch
+
+	{
+	//
+	// Prepare jobs and renders lists snapshots,
+	// GUI requests are served from them without containers locking:
+	//
+	AfContainerLock jLock( a->jobs,     AfContainerLock::READLOCK);
+	AfContainerLock rLock( a->renders,  AfContainerLock::READLOCK);
+
+	a->jobs   ->updateSnapshot();
+	a->renders->updateSnapshot();
+
+	}// - lock containers: snapshots
+
 	//
 	// Free Containers:
+	// Zombies are already removed from all other nodes,
+	// so each container is locked separately.
 	//
 	AFINFO("ThreadRun::run: deleting zombies:")
-	a->monitors ->freeZombies();
-	a->renders  ->freeZombies();
-	a->jobs     ->freeZombies();
-	a->branches ->freeZombies();
-	a->users    ->freeZombies();
+	{
+		AfContainerLock lock( a->monitors, AfContainerLock::WRITELOCK);
+		a->monitors->freeZombies();
+	}
+	{
+		AfContainerLock lock( a->renders, AfContainerLock::WRITELOCK);
+		a->renders->freeZombies();
+	}
+	{
+		AfContainerLock lock( a->jobs, AfContainerLock::WRITELOCK);
+		a->jobs->freeZombies();
+	}
+	{
+		AfContainerLock lock( a->branches, AfContainerLock::WRITELOCK);
+		a->branches->freeZombies();
+	}
+	{
+		AfContainerLock lock( a->users, AfContainerLock::WRITELOCK);
+		a->users->freeZombies();
+	}
+
+	// Log containers locks statistics:
+	profileLocks( a);
 
-	}// - lock containers
+	// Queue statistics database rows waiting too long:
+	AFCommon::DBFlush();
 
 	// Save store
 	if( cycle % 100 == 0 )
@@ -173,10 +279,10 @@ void threadRunCycle( void * i_args)
 	}
 
 	//
-	// Sleeping
+	// Sleeping (or waiting for an event)
 	//
 	AFINFO("ThreadRun::run: sleeping...")
-	   af::sleep_sec( 1);
+	RunCycleWaker::Wait();
 
 	cycle++;
 	}// - while running
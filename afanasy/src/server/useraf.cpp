@@ -16,6 +16,7 @@
 #include "useraf.h"
 
 #include "../libafanasy/environment.h"
+#include "../libafanasy/msgbufferpool.h"
 
 #include "action.h"
 #include "afcommon.h"
@@ -51,7 +52,7 @@ UserAf::UserAf( const std::string & i_store_dir):
 	AfNodeSolve( this, i_store_dir)
 {
 	int size;
-	char * data = af::fileRead( getStoreFile(), &size);
+	char * data = AFCommon::readStoreFile( getStoreFile(), &size);
 	if( data == NULL ) return;
 
 	rapidjson::Document document;
@@ -134,6 +135,12 @@ void UserAf::v_action( Action & i_action)
 
 	if( i_action.log.size() )
 	{
+		// Blocks use user errors retries and forgive time if they are not set,
+		// so error tasks should be refreshed to be retried or forgiven again:
+		AfListIt jobsListIt( &m_jobs_list);
+		for( AfNodeSrv *job = jobsListIt.node(); job != NULL; jobsListIt.next(), job = jobsListIt.node())
+			((JobAf*)(job))->setRefreshAll();
+
 		store();
 		i_action.monitors->addEvent( af::Monitor::EVT_users_change, m_id);
 	}
@@ -243,7 +250,7 @@ af::Msg * UserAf::writeJobdsOrder( bool i_binary) const
 
 
 	std::vector<int32_t> jids = m_jobs_list.generateIdsList();
-	std::ostringstream str;
+	af::MsgStream str;
 
 	str << "{\"events\":{\"jobs_order\":{\"uids\":[";
 	str << getId();
@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "../include/afanasy.h"
+#include "../libafanasy/msgbufferpool.h"
 #include "../libafanasy/msgqueue.h"
 
 #include "../libafsql/dbconnection.h"
@@ -109,7 +110,7 @@ af::Msg * UserContainer::addUser( UserAf * i_user, MonitorContainer * i_monitori
 		{
 			AFERRAR("UserContainer::addUser: User \"%s\" already exists.", i_user->getName().c_str());
 			delete i_user;
-			std::ostringstream str;
+			af::MsgStream str;
 			str << "{\"error\":\"exists\"";
 			str << ",\n\"user\":\n";
 			user->v_jsonWrite( str, /*type no matter*/ 0);
@@ -131,7 +132,7 @@ af::Msg * UserContainer::addUser( UserAf * i_user, MonitorContainer * i_monitori
 
 	AFCommon::QueueLog("User registered: " + i_user->v_generateInfoString( false));
 
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{\"user\":\n";
 	i_user->v_jsonWrite( str, /*type no matter*/ 0);
 	str << "\n}";